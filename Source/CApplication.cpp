@@ -7,20 +7,43 @@
 #include <wx/display.h>
 
 #include "CApplication.h"
+#include "CRenderBenchmark.h"
 #include "WRUtilities.h"
 
 namespace WinRuler
 {
+	CApplication::CApplication() :
+		m_pMainFrame(nullptr),
+		m_pIcon(nullptr),
+		m_pLogger(nullptr),
+		m_bRunBenchmark(false)
+	{
+		// No code.
+	}
+
 	bool CApplication::OnInit()
 	{
+		// Parse command line. It calls OnInitCmdLine() and OnCmdLineParsed().
+		if (!wxApp::OnInit())
+			return false;
+
 		// Set frame appearance to use system theme.
 		SetAppearance(wxApp::Appearance::System);
 
-		// Only in Debug, create our wxLog instance and set it as active
-		// target.
+		// In benchmark mode, log (with benchmark results) is written to
+		// standard output. Otherwise Debug build creates our wxLog window
+		// and sets it as active target.
+		if (m_bRunBenchmark)
+		{
+			m_pLogger = new wxLogStderr(stdout);
+			wxLog::SetActiveTarget(m_pLogger);
+		}
 #ifdef _DEBUG
-		m_pLogger = new wxLogWindow(nullptr, "Log", true, false);
-		wxLog::SetActiveTarget(m_pLogger);
+		else
+		{
+			m_pLogger = new wxLogWindow(nullptr, "Log", true, false);
+			wxLog::SetActiveTarget(m_pLogger);
+		}
 #endif
 
 		// Initialize all supported image handlers.
@@ -31,11 +54,16 @@ namespace WinRuler
 		for (unsigned int i = 0; i < wxDisplay::GetCount(); ++i)
 		{
 			const wxDisplay display(i);
+			const wxSize PPI = display.GetPPI();
 
-			g_vPixelPerInch.emplace_back();
-			g_vPixelPerInch.back() = display.GetPPI();
+			g_vPixelPerInch.emplace_back(PPI.GetWidth(), PPI.GetHeight());
 		}
 
+		// In benchmark mode no window is created. Benchmark suite is
+		// executed by OnRun() instead of main loop.
+		if (m_bRunBenchmark)
+			return true;
+
 		// If our application is executed for the first time, store bool
 		// true here, otherwise store false. We will need that information
 		// bellow.
@@ -47,19 +75,7 @@ namespace WinRuler
 
 		// Set MainFrame client size depending on ruler scale position and
 		// centre it on the screen.
-		switch (m_pMainFrame->m_eRulerPosition)
-		{
-		case ERulerPosition::rpLeft:
-		case ERulerPosition::rpRight:
-			m_pMainFrame->SetClientSize(60, m_pMainFrame->m_iRulerLength);
-
-			break;
-		case ERulerPosition::rpTop:
-		case ERulerPosition::rpBottom:
-			m_pMainFrame->SetClientSize(m_pMainFrame->m_iRulerLength, 60);
-
-			break;
-		}
+		m_pMainFrame->SetClientSize(m_pMainFrame->GetRulerSize());
 
 		// Centre MainFrame if application is executed for the first time.
 		if (bAppExecForTheFirstTime)
@@ -90,14 +106,12 @@ namespace WinRuler
 
 	int CApplication::OnExit()
 	{
-#ifdef _DEBUG
 		// Clean our wxLog instance.
 		wxLog::SetActiveTarget(nullptr);
 		if (m_pLogger != nullptr)
 		{
 			wxDELETE(m_pLogger);
 		}
-#endif
 
 		// Release m_pIcon instance.
 		if (m_pIcon != nullptr)
@@ -118,6 +132,58 @@ namespace WinRuler
 		return wxApp::OnExit();
 	}
 
+	int CApplication::OnRun()
+	{
+		// Run benchmark suite headless with default ruler's appearance
+		// instead of main loop.
+		if (m_bRunBenchmark)
+		{
+			CRenderBenchmark Benchmark;
+			Benchmark.Run(CRenderBenchmark::GetDefaultConfig());
+			Benchmark.RunBackends(CRenderBenchmark::GetDefaultConfig(), 800);
+			Benchmark.RunTickSubmission(
+				CRenderBenchmark::GetDefaultConfig(), 800);
+			Benchmark.RunPixelKernels(800);
+
+			// Conversion kernels of all instruction sets must give the same
+			// results and steady-state repaint must not allocate memory.
+			// Failure is reported by non-zero exit code, skipped check is
+			// only reported in the log.
+			bool bPassed = Benchmark.RunConversionKernels(800);
+			bPassed =
+				(Benchmark.CheckSteadyStateAllocations(
+					CRenderBenchmark::GetDefaultConfig()) != crFailed) &&
+				bPassed;
+
+			wxLog::FlushActive();
+
+			return bPassed ? 0 : 1;
+		}
+
+		// Execute and return inherited method OnRun() value.
+		return wxApp::OnRun();
+	}
+
+	void CApplication::OnInitCmdLine(wxCmdLineParser& Parser)
+	{
+		// Add standard switches first.
+		wxApp::OnInitCmdLine(Parser);
+
+		Parser.AddSwitch(
+			wxString(""), wxString("benchmark"),
+			wxString(
+				"Run render benchmark suite without showing the ruler and "
+				"exit."));
+	}
+
+	bool CApplication::OnCmdLineParsed(wxCmdLineParser& Parser)
+	{
+		m_bRunBenchmark = Parser.Found(wxString("benchmark"));
+
+		// Execute and return inherited method OnCmdLineParsed() value.
+		return wxApp::OnCmdLineParsed(Parser);
+	}
+
 	int CApplication::FilterEvent(wxEvent& Event)
 	{
 		// Retrieve event type.
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <wx/wx.h>
+#include <wx/cmdline.h>
 
 #include <CMainFrame.h>
 
@@ -18,6 +19,11 @@ namespace WinRuler
 		public wxApp
 	{
 	public:
+		/**
+		 * Default constructor.
+		 **/
+		CApplication();
+
 		/**
 		 * This function is called when application is initialized and returns
 		 * true if initialization process was successful.
@@ -35,6 +41,30 @@ namespace WinRuler
 		 **/
 		int OnExit() override;
 
+		/**
+		 * Runs application's main loop, or only render benchmark suite if
+		 * --benchmark switch was specified.
+		 *
+		 * \return	Returns exit code of the application.
+		 **/
+		int OnRun() override;
+
+		/**
+		 * Adds application's command line switches to the parser.
+		 *
+		 * \param Parser	Reference to wxCmdLineParser object.
+		 **/
+		void OnInitCmdLine(wxCmdLineParser& Parser) override;
+
+		/**
+		 * Reads application's command line switches from the parser.
+		 *
+		 * \param Parser	Reference to wxCmdLineParser object.
+		 *
+		 * \return	Returns true if command line is valid, otherwise false.
+		 **/
+		bool OnCmdLineParsed(wxCmdLineParser& Parser) override;
+
 		/**
 		 * Override FilterEvent method for our mouse events pre-processing.
 		 * 
@@ -63,5 +93,9 @@ namespace WinRuler
 
 		//! Pointer to wxLog.
 		wxLog* m_pLogger;
+
+		//! If true, application only runs render benchmark suite headless
+		//! and exits.
+		bool m_bRunBenchmark;
 	};
 } // end namespace WinRuler
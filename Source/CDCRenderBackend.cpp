@@ -0,0 +1,108 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <wx/wx.h>
+#include <wx/graphics.h>
+#include "CDCRenderBackend.h"
+
+namespace WinRuler
+{
+    CDCRenderBackend::CDCRenderBackend() :
+        m_pDC(nullptr),
+        m_bBatchLines(true)
+    {
+        // No code.
+    }
+
+    void CDCRenderBackend::SetBatchLines(bool bBatchLines)
+    {
+        m_bBatchLines = bBatchLines;
+    }
+
+    bool CDCRenderBackend::Begin(wxDC& dc)
+    {
+        m_pDC = &dc;
+
+        return true;
+    }
+
+    void CDCRenderBackend::End()
+    {
+        m_pDC = nullptr;
+    }
+
+    void CDCRenderBackend::SetPen(const wxPen& Pen)
+    {
+        m_pDC->SetPen(Pen);
+    }
+
+    void CDCRenderBackend::SetTextStyle(
+        const wxFont& Font, const wxColour& Colour)
+    {
+        m_pDC->SetFont(Font);
+        m_pDC->SetTextForeground(Colour);
+    }
+
+    void CDCRenderBackend::DrawLine(const SRenderLine& Line)
+    {
+        m_pDC->DrawLine(Line.Start, Line.End);
+    }
+
+    void CDCRenderBackend::DrawLines(const SRenderLine* pLines, size_t uCount)
+    {
+        // Submit all lines in one batch through graphics context, if it can
+        // be created for this device context.
+        if (m_bBatchLines && (uCount > 1))
+        {
+            wxGraphicsContext* pContext =
+                wxGraphicsContext::CreateFromUnknownDC(*m_pDC);
+            if (pContext != nullptr)
+            {
+                // Disable antialiasing and use butt cap, so every line
+                // covers exactly the same pixels as if it was drawn by
+                // DrawLine().
+                wxPen Pen(m_pDC->GetPen());
+                Pen.SetCap(wxCAP_BUTT);
+                pContext->SetAntialiasMode(wxANTIALIAS_NONE);
+                pContext->SetPen(Pen);
+
+                // Graphics context does not have to inherit clipping region
+                // of the device context, so clip it explicitly.
+                wxRect Box;
+                if (m_pDC->GetClippingBox(Box))
+                    pContext->Clip(
+                        Box.GetX(), Box.GetY(),
+                        Box.GetWidth(), Box.GetHeight());
+
+                StrokeLines(*pContext, pLines, uCount, m_vBegins, m_vEnds);
+
+                // Graphics context flushes all drawing when it is destroyed.
+                delete pContext;
+
+                return;
+            }
+        }
+
+        // Otherwise draw lines one by one.
+        for (size_t I = 0; I < uCount; I++)
+            m_pDC->DrawLine(pLines[I].Start, pLines[I].End);
+    }
+
+    void CDCRenderBackend::DrawText(const wxString& Text, const wxPoint& Point)
+    {
+        m_pDC->DrawText(Text, Point);
+    }
+
+    void CDCRenderBackend::DrawBitmap(
+        const wxBitmap& Bitmap, const wxPoint& Point, bool bUseMask)
+    {
+        m_pDC->DrawBitmap(Bitmap, Point, bUseMask);
+    }
+
+    const wxChar* CDCRenderBackend::GetName() const
+    {
+        return wxT("wxDC");
+    }
+} // end namespace WinRuler
@@ -0,0 +1,67 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include "CRenderBackend.h"
+
+namespace WinRuler
+{
+    /**
+     * CDCRenderBackend class definition. Classic backend which draws
+     * directly through wxDC calls, without antialiasing. It can draw on any
+     * device context. wxDC has no call for batch of disjoint lines, so many
+     * lines are stroked in one batch through graphics context created for
+     * the device context, with antialiasing off and butt caps, so they
+     * cover exactly the same pixels as DrawLine(). If graphics context can
+     * not be created, lines are drawn one by one.
+     **/
+    class CDCRenderBackend :
+        public CRenderBackend
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CDCRenderBackend();
+
+        /**
+         * Selects whether many lines are submitted in one batch (default)
+         * or drawn one by one. Per-line drawing is used by benchmark for
+         * comparison.
+         *
+         * \param bBatchLines   If true, lines are submitted in one batch.
+         **/
+        void SetBatchLines(bool bBatchLines);
+
+        // Implementation of CRenderBackend interface, see its documentation.
+        bool Begin(wxDC& dc) override;
+        void End() override;
+        void SetPen(const wxPen& Pen) override;
+        void SetTextStyle(
+            const wxFont& Font, const wxColour& Colour) override;
+        void DrawLine(const SRenderLine& Line) override;
+        void DrawLines(const SRenderLine* pLines, size_t uCount) override;
+        void DrawText(const wxString& Text, const wxPoint& Point) override;
+        void DrawBitmap(
+            const wxBitmap& Bitmap, const wxPoint& Point,
+            bool bUseMask) override;
+        const wxChar* GetName() const override;
+    private:
+        //! Device context bound by Begin().
+        wxDC* m_pDC;
+
+        //! If true, many lines are submitted in one batch.
+        bool m_bBatchLines;
+
+        //! Scratch buffer with start points of batched lines.
+        std::vector<wxPoint2DDouble> m_vBegins;
+
+        //! Scratch buffer with end points of batched lines.
+        std::vector<wxPoint2DDouble> m_vEnds;
+    };
+} // end namespace WinRuler
@@ -4,10 +4,14 @@
  **/
 
 #include <cmath>
+#include <algorithm>
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
+#include <wx/display.h>
 #include "CMainFrame.h"
 #include "CDrawPanel.h"
 #include "WRUtilities.h"
+#include "WRRulerUnits.h"
 
 namespace WinRuler
 {
@@ -23,13 +27,54 @@ namespace WinRuler
     EVT_MOTION(CDrawPanel::OnMouseMove)
     EVT_LEAVE_WINDOW(CDrawPanel::OnMouseLeave)
 
+    // Catch timer events.
+    EVT_TIMER(ID_STATISTICS_TIMER, CDrawPanel::OnStatisticsTimer)
+    EVT_TIMER(ID_INPUT_TIMER, CDrawPanel::OnInputTimer)
+
+    // Catch layer render worker events.
+    EVT_THREAD(ID_LAYER_RENDER_WORKER, CDrawPanel::OnLayerRendered)
+    EVT_THREAD(ID_LAYER_PRERENDER_WORKER, CDrawPanel::OnLayerPrerendered)
+
+    // Catch idle events, layers are pre-rendered in idle time.
+    EVT_IDLE(CDrawPanel::OnIdle)
+
     END_EVENT_TABLE()
 
     CDrawPanel::CDrawPanel(wxFrame* pParent) :
         wxPanel(pParent),
-        m_bDragging(false)
+        m_bDragging(false),
+        m_pScaleLayer(nullptr),
+        m_ulPaintCounter(0),
+        m_LayerRenderWorker(this, ID_LAYER_RENDER_WORKER),
+        m_ulSurfaceJobCounter(0),
+        m_PrerenderWorker(this, ID_LAYER_PRERENDER_WORKER),
+        m_bPrerenderJobPending(false),
+        m_ulPrerenderJob(0),
+        m_bShowRenderStatistics(false),
+        m_StatisticsTimer(this, ID_STATISTICS_TIMER),
+        m_bInputPending(false),
+        m_InputTimer(this, ID_INPUT_TIMER),
+        m_lFrameInterval(16),
+        m_uDisplayNo(0)
     {
-        // No code.
+        // Panel composes every paint in its own back buffer and covers whole
+        // update region, so background does not have to be erased.
+        SetBackgroundStyle(wxBG_STYLE_PAINT);
+
+        // No layer cache is used yet.
+        for (SScaleLayerCache& Cache : m_aScaleLayers)
+        {
+            Cache.dScaleFactor = 0.0;
+            Cache.bValid = false;
+            Cache.ulLastUse = 0;
+            Cache.bSurfaceJobPending = false;
+            Cache.ulSurfaceJob = 0;
+        }
+
+        // Retrieve display which shows the ruler and its refresh interval
+        // used for input scheduling.
+        UpdateDisplay();
+        UpdateFrameInterval();
     }
 
     void CDrawPanel::OnMouseEvent(wxMouseEvent& Event)
@@ -75,27 +120,18 @@ namespace WinRuler
                 pRulerPositionMenu);
             pMenu->AppendSeparator();
 
-            // Append measuring units as radio items.
-            pMenu->AppendRadioItem(
-                ID_PIXELS_AS_UNIT,
-                wxString("&Pixels as unit"))->Check(
-                    pMainFrame->m_eRulerUnits == ERulerUnits::ruPixels ? 
-                        true : false);
-            pMenu->AppendRadioItem(
-                ID_CENTIMETRES_AS_UNIT,
-                wxString("&Centimetres as unit"))->Check(
-                    pMainFrame->m_eRulerUnits == ERulerUnits::ruCentimetres ? 
-                        true : false);
-            pMenu->AppendRadioItem(
-                ID_INCHES_AS_UNIT,
-                wxString("&Inches as unit"))->Check(
-                    pMainFrame->m_eRulerUnits == ERulerUnits::ruInches ? 
-                        true : false);
-            pMenu->AppendRadioItem(
-                ID_PICAS_AS_UNIT,
-                wxString("&Picas as unit"))->Check(
-                    pMainFrame->m_eRulerUnits == ERulerUnits::ruPicas ? 
-                        true : false);
+            // Append all units of measurement of the registry as radio
+            // items.
+            for (int I = 0; I < ERulerUnits::ruCount; I++)
+            {
+                const SRulerUnitDesc& Desc =
+                    GetRulerUnitDesc(static_cast<ERulerUnits>(I));
+
+                pMenu->AppendRadioItem(
+                    ID_UNIT_OF_MEASUREMENT + I,
+                    wxString(Desc.pszName) + wxString(" as unit"))->Check(
+                        pMainFrame->m_eRulerUnits == Desc.eUnits);
+            }
             pMenu->AppendSeparator();
 
             // Append AlwaysOnTop item separated.
@@ -114,6 +150,20 @@ namespace WinRuler
             pMenu->Append(ID_OPTIONS, wxString("&Options..."));
             pMenu->AppendSeparator();
 
+            // Append render statistics overlay item.
+            pMenu->AppendCheckItem(
+                ID_RENDER_STATISTICS,
+                wxString("Show render &statistics"))->Check(
+                    m_bShowRenderStatistics);
+            pMenu->AppendSeparator();
+
+#ifdef _DEBUG
+            // Append render benchmark menu item (only in Debug).
+            pMenu->Append(
+                ID_RENDER_BENCHMARK, wxString("Run render &benchmark"));
+            pMenu->AppendSeparator();
+#endif
+
             // Append About and Close items separated.
             pMenu->Append(wxID_ABOUT, wxString("&About..."));
             pMenu->AppendSeparator();
@@ -136,8 +186,8 @@ namespace WinRuler
 		// Create paint device context.
         wxPaintDC dc(this);
 
-		// Render on created device context.
-        Render(dc);
+		// Render on created device context only parts that need repaint.
+        Render(dc, GetUpdateRegion());
     }
 
     void CDrawPanel::PaintNow()
@@ -145,11 +195,11 @@ namespace WinRuler
 		// Create paint device context.
         wxClientDC dc(this);
 
-		// Render on created device context.
-        Render(dc);
+		// Render whole client area on created device context.
+        Render(dc, wxRegion(wxRect(GetClientSize())));
     }
 
-    void CDrawPanel::Render(wxDC& dc)
+    void CDrawPanel::Render(wxDC& dc, const wxRegion& UpdateRegion)
     {
         // Retrieve pointer to CMainFrame class.
         CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
@@ -158,1879 +208,771 @@ namespace WinRuler
         wxSize size(this->GetClientSize());
         wxRect surfaceRect(0, 0, size.GetWidth(), size.GetHeight());
 
-        // Draw ruler's surface.
-        DrawRulerSurface(
-            dc, surfaceRect,
-            pMainFrame->m_eRulerPosition,
-            pMainFrame->m_eRulerBackgroundType,
-            pMainFrame->m_cRulerBackgroundColour,
-            pMainFrame->m_cRulerBackgroundStartColour,
-            pMainFrame->m_cRulerBackgroundEndColour,
-            pMainFrame->m_RulerBackgroundBitmapLeftH,
-            pMainFrame->m_RulerBackgroundBitmapMiddleH,
-            pMainFrame->m_RulerBackgroundBitmapRightH,
-            pMainFrame->m_RulerBackgroundBitmapTopV,
-            pMainFrame->m_RulerBackgroundBitmapMiddleV,
-            pMainFrame->m_RulerBackgroundBitmapBottomV);
-
-        // Draw ruler's scale.
-        DrawRulerScale(
-            dc, surfaceRect,
-            pMainFrame->m_cRulerScaleColour,
-            pMainFrame->m_eRulerPosition,
-            pMainFrame->m_eRulerUnits);
-
-        // Draw ruler's markers.
-        DrawRulerMarkers(
-            dc, surfaceRect, 
-            pMainFrame->m_eRulerPosition,
-            pMainFrame->m_eRulerUnits,
-            pMainFrame->m_cRulerScaleColour,
-            pMainFrame->m_cFirstMarkerColour,
-            pMainFrame->m_cSecondMarkerColour,
-            pMainFrame->m_iFirstMarkerPosition,
-            pMainFrame->m_iSecondMarkerPosition);
-    }
-
-    void CDrawPanel::DrawRulerMarkers(
-        wxDC& dc, wxRect& SurfaceRect,
-        ERulerPosition eRulerPosition,
-        ERulerUnits eRulerUnits,
-        wxColour& cRulerScaleColour,
-        wxColour& cFirstMarkerColour,
-        wxColour& cSecondMarkerColour,
-        int iFirstMarkerPosition,
-        int iSecondMarkerPosition)
-    {
-        wxString TmpS;
-        wxCoord TextWidth, TextHeight;
-
-		// If first marker position is -1, do not draw anything and return.
-        if (iFirstMarkerPosition == -1)
+        // Nothing to draw on empty surface.
+        if (surfaceRect.IsEmpty())
             return;
 
-		// Prepare device context. We will draw ruler's markers on it.
-        
-        // Set device context brush to transparent.
-        dc.SetBrush(wxBrush(wxTransparentColour, wxBRUSHSTYLE_TRANSPARENT));
-
-		// Set device context pen colour to first marker colour and style to
-        // solid.
-        dc.SetPen(wxPen(cFirstMarkerColour, 1, wxPENSTYLE_SOLID));
-
-		// Set device context font size to 6 and font colour to
-		// m_RulerScaleColour. Additionally, set font style to normal and
-		// weight to normal and family to default.
-        wxFont font(
-            6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-        dc.SetFont(font);
-		// Set device context text foreground colour to m_RulerScaleColour.
-        dc.SetTextForeground(cRulerScaleColour);
-
-		// Draw ruler's marker and its information depending on ruler's unit of
-		// measurement and ruler's position.
-        switch (eRulerPosition)
+        // Select layers of display's DPI scale factor. Layers of the other
+        // display stay cached, so moving the ruler back does not rebuild
+        // them.
+        SelectScaleLayer(surfaceRect);
+        SScaleLayerCache& ScaleLayer = *m_pScaleLayer;
+
+        // Reset static layer (ruler's surface and scale) only if it was
+        // invalidated, surface size was changed or PPI value was changed
+        // since the last reset.
+        if (!ScaleLayer.bValid ||
+            !ScaleLayer.Layer.IsOk() ||
+            (ScaleLayer.Layer.GetLogicalSize() != size) ||
+            (ScaleLayer.PixelPerInch != GetPixelPerInch(m_uDisplayNo)))
         {
-        case ERulerPosition::rpLeft:
-            // Draw first marker.
-            dc.DrawLine(
-                wxPoint(
-                    SurfaceRect.GetLeft(), SurfaceRect.GetTop() + 4 +
-                    iFirstMarkerPosition),
-                wxPoint(
-                    SurfaceRect.GetRight(), SurfaceRect.GetTop() + 4 +
-                    iFirstMarkerPosition));
-
-			// Prepare temporary string TmpS for first marker.
-            switch (eRulerUnits)
-            {
-            case ERulerUnits::ruCentimetres:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToCentimetresHorizontal(
-                            0, iFirstMarkerPosition), 2) +
-                    wxString(" cm");
+            RebuildScaleLayer(surfaceRect);
+        }
 
-                break;
-            case ERulerUnits::ruInches:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToInchesHorizontal(
-                            0, iFirstMarkerPosition), 2) +
-                    wxString(" in");
+        // Draw part of static layer which is exposed for the first time
+        // since its reset.
+        wxRect UpdateBox = UpdateRegion.GetBox();
+        if (!ScaleLayer.ValidRect.Contains(UpdateBox))
+            UpdateScaleLayer(surfaceRect, UpdateBox);
+
+        // Only markers' positions change between rebuilds of static layer,
+        // so cached configuration is updated in place instead of being
+        // copied from main frame.
+        ScaleLayer.RenderConfig.iFirstMarkerPosition =
+            pMainFrame->m_iFirstMarkerPosition;
+        ScaleLayer.RenderConfig.iSecondMarkerPosition =
+            pMainFrame->m_iSecondMarkerPosition;
+
+        // Describe frame: static layer, markers and render statistics
+        // overlay drawn over everything else.
+        SFrameContent Content;
+        Content.SurfaceRect = surfaceRect;
+        Content.dScaleFactor = GetContentScaleFactor();
+        Content.pScaleLayerDC = &m_ScaleLayerDC;
+        Content.pRenderer = &ScaleLayer.Renderer;
+        Content.pRenderConfig = &ScaleLayer.RenderConfig;
+        Content.FirstMarkerBounds =
+            GetMarkerBounds(
+                surfaceRect, pMainFrame->m_eRulerPosition,
+                pMainFrame->m_iFirstMarkerPosition);
+        Content.SecondMarkerBounds =
+            GetMarkerBounds(
+                surfaceRect, pMainFrame->m_eRulerPosition,
+                pMainFrame->m_iSecondMarkerPosition);
+        Content.pOverlay = nullptr;
+
+        SFrameOverlay Overlay;
+        if (m_bShowRenderStatistics)
+        {
+            Overlay.Bounds =
+                GetRenderStatisticsBounds(surfaceRect, &Overlay.iRows);
+            Overlay.pLines = m_asRenderStatisticsLines;
+            Overlay.iLines = RenderStatisticsLines;
+            Overlay.LineExtent = m_StatisticsLineExtent;
 
-                break;
-            case ERulerUnits::ruPicas:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToPicasHorizontal(
-                            0, iFirstMarkerPosition), 2) +
-                    wxString(" pica");
+            Content.pOverlay = &Overlay;
+        }
 
-                break;
-            case ERulerUnits::ruPixels:
-                TmpS =
-                    wxString::Format(
-                        wxT("%d px"), iFirstMarkerPosition);
+        // Compose update region in back buffer and copy it to the window.
+        m_FrameCompositor.Compose(
+            dc, UpdateRegion, Content, m_RenderStatistics);
 
-                break;
-            }
+        // If one second elapsed, compute per second statistics.
+        if (m_RenderStatistics.Update())
+        {
+#ifdef _DEBUG
+            wxString Summary;
+            m_RenderStatistics.FormatSummary(Summary);
+            wxLogInfo(Summary);
+#endif
+        }
+    }
 
-            // Retrieve text width and text height of TmpS string.
-            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
+    wxRect CDrawPanel::GetMarkerBounds(
+        const wxRect& SurfaceRect,
+        ERulerPosition eRulerPosition,
+        int iMarkerPosition) const
+    {
+        return CRulerRenderer::GetMarkerBounds(
+            SurfaceRect, eRulerPosition, iMarkerPosition, GetMetrics(),
+            m_MarkerLabelExtent);
+    }
 
-			// Draw text of first marker on device context depending on ruler's
-            // position and text width and height.
-            if (SurfaceRect.GetTop() + 4 + iFirstMarkerPosition + 4 +
-                TextHeight > SurfaceRect.GetBottom())
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() +
-                        ((SurfaceRect.GetWidth() / 3) * 2) - (TextWidth / 2),
-                        SurfaceRect.GetTop() + 4 +
-                        iFirstMarkerPosition - 4 - TextHeight));
-            }
-            else
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() +
-                        ((SurfaceRect.GetWidth() / 3) * 2) - (TextWidth / 2),
-                        SurfaceRect.GetTop() + 4 +
-                        iFirstMarkerPosition + 4));
-            }
+    void CDrawPanel::ShowRenderStatistics(bool bShow)
+    {
+        m_bShowRenderStatistics = bShow;
 
-            // If second marker's position is other than -1, we can draw it.
-            if (iSecondMarkerPosition != -1)
-            {
-                // Set pen colour to second marker's colour.
-                dc.SetPen(wxPen(cSecondMarkerColour, 1, wxPENSTYLE_SOLID));
-
-                dc.DrawLine(
-                    wxPoint(
-                        SurfaceRect.GetLeft(), SurfaceRect.GetTop() + 4 +
-                        iSecondMarkerPosition),
-                    wxPoint(
-                        SurfaceRect.GetRight(), SurfaceRect.GetTop() + 4 +
-                        iSecondMarkerPosition));
-
-                // Prepare temporary string TmpS for second marker.
-                switch (eRulerUnits)
-                {
-                case ERulerUnits::ruCentimetres:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToCentimetresHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" cm");
-
-                    break;
-                case ERulerUnits::ruInches:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToInchesHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" in");
-
-                    break;
-                case ERulerUnits::ruPicas:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToPicasHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" pica");
-
-                    break;
-                case ERulerUnits::ruPixels:
-                    TmpS =
-                        wxString::Format(wxT("%d px"), iSecondMarkerPosition);
-
-                    break;
-                }
+        // Overlay is refreshed once per second only while it is shown.
+        if (bShow)
+        {
+            FormatRenderStatistics();
+            m_StatisticsTimer.Start(1000);
+        }
+        else
+        {
+            m_StatisticsTimer.Stop();
+        }
 
-				// Retrieve text width and text height of TmpS string.
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
+        RefreshRect(GetRenderStatisticsBounds(wxRect(GetClientSize())), false);
+    }
 
-                // Draw text of second marker on device context depending on
-                // ruler's position and text width and height.
-                if (SurfaceRect.GetTop() + 4 + iSecondMarkerPosition + 4 +
-                    TextHeight > SurfaceRect.GetBottom())
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() +
-                            ((SurfaceRect.GetWidth() / 3) * 2) - 
-                            (TextWidth / 2),
-                            SurfaceRect.GetTop() + 4 +
-                            iSecondMarkerPosition - 4 - TextHeight));
-                }
-                else
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() +
-                            ((SurfaceRect.GetWidth() / 3) * 2) - 
-                            (TextWidth / 2),
-                            SurfaceRect.GetTop() + 4 + 
-                            iSecondMarkerPosition + 4));
-                }
-            }
+    bool CDrawPanel::IsRenderStatisticsShown() const
+    {
+        return m_bShowRenderStatistics;
+    }
 
-            break;
-        case ERulerPosition::rpTop:
-            // Draw first marker.
-            dc.DrawLine(
+    wxRect CDrawPanel::GetRenderStatisticsBounds(
+        const wxRect& SurfaceRect, int* piRows) const
+    {
+        bool bVertical = SurfaceRect.GetHeight() > SurfaceRect.GetWidth();
+        int iLineHeight = std::max(m_StatisticsLineExtent.GetHeight(), 1);
+        SRulerMetrics Metrics = GetMetrics();
+
+        // On vertical ruler all lines are in one column. On horizontal one
+        // lines are split into columns which fit ruler's thickness without
+        // the longest ticks.
+        int iRows = RenderStatisticsLines;
+        if (!bVertical)
+            iRows =
+                std::max(
+                    1,
+                    std::min(
+                        iRows,
+                        (SurfaceRect.GetHeight() - Metrics.iLongTick) /
+                            iLineHeight));
+        int iColumns = (RenderStatisticsLines + iRows - 1) / iRows;
+
+        if (piRows != nullptr)
+            *piRows = iRows;
+
+        // Overlay has 2 pixels of padding on every side and between columns.
+        wxSize Size(
+            ((m_StatisticsLineExtent.GetWidth() + 2) * iColumns) + 2,
+            (m_StatisticsLineExtent.GetHeight() * iRows) + 4);
+
+        // Overlay is centred across the ruler at the end of its scale.
+        if (bVertical)
+            return wxRect(
                 wxPoint(
-                    SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition,
-                    SurfaceRect.GetTop()),
+                    SurfaceRect.GetLeft() +
+                        ((SurfaceRect.GetWidth() - Size.GetWidth()) / 2),
+                    SurfaceRect.GetBottom() - Metrics.iInset -
+                        Size.GetHeight()),
+                Size);
+        else
+            return wxRect(
                 wxPoint(
-                    SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition,
-                    SurfaceRect.GetBottom()));
-
-			// Prepare temporary string TmpS for first marker.
-            switch (eRulerUnits)
-            {
-            case ERulerUnits::ruCentimetres:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToCentimetresVertical(0, iFirstMarkerPosition), 
-                        2) +
-                    wxString(" cm");
-
-                break;
-            case ERulerUnits::ruInches:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToInchesVertical(0, iFirstMarkerPosition), 2) +
-                    wxString(" in");
-
-                break;
-            case ERulerUnits::ruPicas:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToPicasVertical(0, iFirstMarkerPosition), 2) +
-                    wxString(" pica");
-
-                break;
-            case ERulerUnits::ruPixels:
-                TmpS = wxString::Format(wxT("%d px"), iFirstMarkerPosition);
-
-                break;
-            }
-
-			// Retrieve text width and text height of TmpS string.
-            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
+                    SurfaceRect.GetRight() - Metrics.iInset - Size.GetWidth(),
+                    SurfaceRect.GetTop() +
+                        ((SurfaceRect.GetHeight() - Size.GetHeight()) / 2)),
+                Size);
+    }
 
-			// Draw text of first marker on device context depending on ruler's
-			// position and text width and height.
-            if (SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition +
-                TextWidth > SurfaceRect.GetRight())
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 +
-                        iFirstMarkerPosition - 4 - TextWidth,
-                        SurfaceRect.GetTop() +
-                        ((SurfaceRect.GetHeight() / 3) * 2)));
-            }
-            else
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition + 4,
-                        SurfaceRect.GetTop() +
-                        ((SurfaceRect.GetHeight() / 3) * 2)));
-            }
+    void CDrawPanel::FormatRenderStatistics()
+    {
+        wxString* Lines = m_asRenderStatisticsLines;
+
+        // Format per second counters.
+        Lines[0].Printf(
+            wxT("move %u/s"), m_RenderStatistics.GetMotionEventsPerSecond());
+        Lines[1].Printf(
+            wxT("merge %u/s"),
+            m_RenderStatistics.GetCoalescedEventsPerSecond());
+        Lines[2].Printf(
+            wxT("paint %u/s"), m_RenderStatistics.GetPaintsPerSecond());
+        Lines[3].Printf(
+            wxT("drag %u/s"), m_RenderStatistics.GetWindowMovesPerSecond());
+
+        // Format the last timings of rendering stages.
+        Lines[4].Printf(
+            wxT("surf %.0fus"), m_RenderStatistics.GetStageTime(rsSurface));
+        Lines[5].Printf(
+            wxT("scale %.0fus"), m_RenderStatistics.GetStageTime(rsScale));
+        Lines[6].Printf(
+            wxT("mark %.0fus"), m_RenderStatistics.GetStageTime(rsMarkers));
+
+        // Format layer cache hits and misses.
+        Lines[7].Printf(
+            wxT("cache %llu/%llu"), m_RenderStatistics.GetLayerCacheHits(),
+            m_RenderStatistics.GetLayerCacheMisses());
+
+        // Measure the new lines with font of the current layers.
+        if (m_ScaleLayerDC.GetSelectedBitmap().IsOk())
+            MeasureStatisticsLines(m_ScaleLayerDC);
+    }
 
-            // If second marker's position is other than -1, we can draw it.
-            if (iSecondMarkerPosition != -1)
-            {
-                // Set pen colour to second marker's colour.
-                dc.SetPen(wxPen(cSecondMarkerColour, 1, wxPENSTYLE_SOLID));
-
-                dc.DrawLine(
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 + iSecondMarkerPosition,
-                        SurfaceRect.GetTop()),
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 + iSecondMarkerPosition,
-                        SurfaceRect.GetBottom()));
-
-				// Prepare temporary string TmpS for second marker.
-                switch (eRulerUnits)
-                {
-                case ERulerUnits::ruCentimetres:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToCentimetresHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" cm");
-
-                    break;
-                case ERulerUnits::ruInches:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToInchesHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" in");
-
-                    break;
-                case ERulerUnits::ruPicas:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToPicasHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" pica");
-
-                    break;
-                case ERulerUnits::ruPixels:
-                    TmpS =
-                        wxString::Format(wxT("%d px"), iSecondMarkerPosition);
-
-                    break;
-                }
+    void CDrawPanel::OnStatisticsTimer(wxTimerEvent& WXUNUSED(Event))
+    {
+        // Close measurement window even if nothing was painted.
+        if (m_RenderStatistics.Update())
+        {
+#ifdef _DEBUG
+            wxString Summary;
+            m_RenderStatistics.FormatSummary(Summary);
+            wxLogInfo(Summary);
+#endif
+        }
 
-				// Retrieve text width and text height of TmpS string.
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
+        // Repaint overlay with new values. Its width follows its widest
+        // line, so both old and new bounds are repainted.
+        wxRect ClientRect(GetClientSize());
+        wxRect Bounds = GetRenderStatisticsBounds(ClientRect);
+        FormatRenderStatistics();
+        Bounds.Union(GetRenderStatisticsBounds(ClientRect));
+        RefreshRect(Bounds, false);
+    }
 
-				// Draw text of second marker on device context depending on
-				// ruler's position and text width and height.
-                if (SurfaceRect.GetLeft() + 4 + iSecondMarkerPosition + 4 +
-                    TextWidth > SurfaceRect.GetRight())
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() + 4 +
-                            iSecondMarkerPosition - 4 - TextWidth,
-                            SurfaceRect.GetTop() +
-                            ((SurfaceRect.GetHeight() / 3) * 2)));
-                }
-                else
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() + 4 + 
-                            iSecondMarkerPosition + 4,
-                            SurfaceRect.GetTop() +
-                            ((SurfaceRect.GetHeight() / 3) * 2)));
-                }
-            }
+    void CDrawPanel::RefreshMarker(int iMarkerPosition)
+    {
+        // Retrieve pointer to CMainFrame class.
+        CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
 
-            break;
-        case ERulerPosition::rpRight:
-            // Draw first marker.
-            dc.DrawLine(
-                wxPoint(
-                    SurfaceRect.GetLeft(),
-                    SurfaceRect.GetTop() + 4 + iFirstMarkerPosition),
-                wxPoint(
-                    SurfaceRect.GetRight(),
-                    SurfaceRect.GetTop() + 4 + iFirstMarkerPosition));
+        // Retrieve marker's bounds.
+        wxRect Bounds =
+            GetMarkerBounds(
+                wxRect(GetClientSize()), pMainFrame->m_eRulerPosition,
+                iMarkerPosition);
 
-			// Prepare temporary string TmpS for first marker.
-            switch (eRulerUnits)
-            {
-            case ERulerUnits::ruCentimetres:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToCentimetresHorizontal(0, iFirstMarkerPosition), 
-                        2) +
-                    wxString(" cm");
+        // Invalidate only marker's bounds.
+        if (!Bounds.IsEmpty())
+            RefreshRect(Bounds, false);
+    }
 
-                break;
-            case ERulerUnits::ruInches:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToInchesHorizontal(0, iFirstMarkerPosition), 2) +
-                    wxString(" in");
+    SRulerRenderConfig CDrawPanel::GetRenderConfig() const
+    {
+        // Retrieve pointer to CMainFrame class.
+        CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
 
-                break;
-            case ERulerUnits::ruPicas:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToPicasHorizontal(0, iFirstMarkerPosition), 2) +
-                    wxString(" pica");
+        // Copy all settings which affect ruler's appearance.
+        SRulerRenderConfig Config;
+        Config.eRulerPosition = pMainFrame->m_eRulerPosition;
+        Config.eRulerUnits = pMainFrame->m_eRulerUnits;
+        Config.eRulerBackgroundType = pMainFrame->m_eRulerBackgroundType;
+        Config.cRulerBackgroundColour = pMainFrame->m_cRulerBackgroundColour;
+        Config.cRulerBackgroundStartColour =
+            pMainFrame->m_cRulerBackgroundStartColour;
+        Config.cRulerBackgroundEndColour =
+            pMainFrame->m_cRulerBackgroundEndColour;
+        Config.cRulerScaleColour = pMainFrame->m_cRulerScaleColour;
+        Config.cFirstMarkerColour = pMainFrame->m_cFirstMarkerColour;
+        Config.cSecondMarkerColour = pMainFrame->m_cSecondMarkerColour;
+        Config.RulerBackgroundBitmapLeftH =
+            pMainFrame->m_RulerBackgroundBitmapLeftH;
+        Config.RulerBackgroundBitmapMiddleH =
+            pMainFrame->m_RulerBackgroundBitmapMiddleH;
+        Config.RulerBackgroundBitmapRightH =
+            pMainFrame->m_RulerBackgroundBitmapRightH;
+        Config.RulerBackgroundBitmapTopV =
+            pMainFrame->m_RulerBackgroundBitmapTopV;
+        Config.RulerBackgroundBitmapMiddleV =
+            pMainFrame->m_RulerBackgroundBitmapMiddleV;
+        Config.RulerBackgroundBitmapBottomV =
+            pMainFrame->m_RulerBackgroundBitmapBottomV;
+        Config.iFirstMarkerPosition = pMainFrame->m_iFirstMarkerPosition;
+        Config.iSecondMarkerPosition = pMainFrame->m_iSecondMarkerPosition;
+        Config.cClearColour = GetBackgroundColour();
+        Config.eRenderBackend = pMainFrame->m_eRenderBackend;
+        Config.Metrics = GetMetrics();
+        Config.dContentScale = GetContentScaleFactor();
+        Config.PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+
+        return Config;
+    }
 
-                break;
-            case ERulerUnits::ruPixels:
-                TmpS =
-                    wxString::Format(wxT("%d px"), iFirstMarkerPosition);
+    SRulerMetrics CDrawPanel::GetMetrics() const
+    {
+        // Metrics are in DIPs. On GTK and macOS logical pixels are DIPs
+        // (content scale factor equals DPI scale factor), on MSW logical
+        // pixels are physical ones.
+        return GetRulerMetrics(
+            GetDPIScaleFactor() / GetContentScaleFactor());
+    }
 
-                break;
-            }
+    void CDrawPanel::InvalidateLayers()
+    {
+        // Mark static layers of all scale factors as invalid, they will be
+        // rebuilt on the next paint which uses them.
+        for (SScaleLayerCache& Cache : m_aScaleLayers)
+            Cache.bValid = false;
+    }
 
-			// Retrieve text width and text height of TmpS string.
-            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
+    void CDrawPanel::ClearPrerenderedLayers()
+    {
+        m_LayerPrerenderCache.Clear();
+    }
 
-			// Draw text of first marker on device context depending on ruler's
-			// position and text width and height.
-            if (SurfaceRect.GetTop() + 4 + iFirstMarkerPosition + 4 +
-                TextHeight > SurfaceRect.GetBottom())
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() +
-                        (SurfaceRect.GetWidth() / 3) - (TextWidth / 2),
-                        SurfaceRect.GetTop() + 4 +
-                        iFirstMarkerPosition - 4 - TextHeight));
-            }
-            else
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() +
-                        (SurfaceRect.GetWidth() / 3) - (TextWidth / 2),
-                        SurfaceRect.GetTop() + 4 + iFirstMarkerPosition + 4));
-            }
+    void CDrawPanel::SelectScaleLayer(const wxRect& SurfaceRect)
+    {
+        double dScaleFactor = GetDPIScaleFactor();
 
-			// If second marker's position is other than -1, we can draw it.
-            if (iSecondMarkerPosition != -1)
-            {
-                // Set pen colour to second marker's colour.
-                dc.SetPen(wxPen(cSecondMarkerColour, 1, wxPENSTYLE_SOLID));
-
-                dc.DrawLine(
-                    wxPoint(
-                        SurfaceRect.GetLeft(),
-                        SurfaceRect.GetTop() + 4 + iSecondMarkerPosition),
-                    wxPoint(
-                        SurfaceRect.GetRight(),
-                        SurfaceRect.GetTop() + 4 + iSecondMarkerPosition));
-
-				// Prepare temporary string TmpS for second marker.
-                switch (eRulerUnits)
-                {
-                case ERulerUnits::ruCentimetres:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToCentimetresHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" cm");
-
-                    break;
-                case ERulerUnits::ruInches:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToInchesHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" in");
-
-                    break;
-                case ERulerUnits::ruPicas:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToPicasHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" pica");
-
-                    break;
-                case ERulerUnits::ruPixels:
-                    TmpS =
-                        wxString::Format(wxT("%d px"), iSecondMarkerPosition);
-
-                    break;
-                }
+        // Count paints, the current cache is the most recently used one.
+        m_ulPaintCounter++;
 
-				// Retrieve text width and text height of TmpS string.
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                
-				// Draw text of second marker on device context depending on
-				// ruler's position and text width and height.
-                if (SurfaceRect.GetTop() + 4 + iSecondMarkerPosition + 4 +
-                    TextHeight > SurfaceRect.GetBottom())
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() +
-                            (SurfaceRect.GetWidth() / 3) - (TextWidth / 2),
-                            SurfaceRect.GetTop() + 4 +
-                            iSecondMarkerPosition - 4 - TextHeight));
-                }
-                else
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() +
-                            (SurfaceRect.GetWidth() / 3) - (TextWidth / 2),
-                            SurfaceRect.GetTop() + 4 +
-                            iSecondMarkerPosition + 4));
-                }
-            }
+        if ((m_pScaleLayer != nullptr) &&
+            (m_pScaleLayer->dScaleFactor == dScaleFactor))
+        {
+            m_pScaleLayer->ulLastUse = m_ulPaintCounter;
 
-            break;
-        case ERulerPosition::rpBottom:
-            // Draw first marker.
-            dc.DrawLine(
-                wxPoint(
-                    SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition,
-                    SurfaceRect.GetTop()),
-                wxPoint(
-                    SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition,
-                    SurfaceRect.GetBottom()));
+            return;
+        }
 
-			// Prepare temporary string TmpS for first marker.
-            switch (eRulerUnits)
+        // Look for layers of this scale factor. If there are none, take
+        // over the least recently used cache (unused caches come first).
+        SScaleLayerCache* pCache = nullptr;
+        for (SScaleLayerCache& Cache : m_aScaleLayers)
+        {
+            if (Cache.dScaleFactor == dScaleFactor)
             {
-            case ERulerUnits::ruCentimetres:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToCentimetresVertical(
-                            0, iFirstMarkerPosition), 2) +
-                    wxString(" cm");
-
-                break;
-            case ERulerUnits::ruInches:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToInchesVertical(
-                            0, iFirstMarkerPosition), 2) +
-                    wxString(" in");
-
-                break;
-            case ERulerUnits::ruPicas:
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToPicasVertical(
-                            0, iFirstMarkerPosition), 2) +
-                    wxString(" pica");
-
-                break;
-            case ERulerUnits::ruPixels:
-                TmpS = wxString::Format(wxT("%d px"), iFirstMarkerPosition);
+                pCache = &Cache;
 
                 break;
             }
 
-			// Retrieve text width and text height of TmpS string.
-            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-
-			// Draw text of first marker on device context depending on ruler's
-			// position and text width and height.
-            if (SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition +
-                4 + TextWidth > SurfaceRect.GetRight())
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 +
-                        iFirstMarkerPosition - 4 - TextWidth,
-                        SurfaceRect.GetTop() +
-                        (SurfaceRect.GetHeight() / 3) - TextHeight));
-            }
-            else
-            {
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 + iFirstMarkerPosition + 4,
-                        SurfaceRect.GetTop() +
-                        (SurfaceRect.GetHeight() / 3) - TextHeight));
-            }
+            if ((pCache == nullptr) || (Cache.ulLastUse < pCache->ulLastUse))
+                pCache = &Cache;
+        }
 
-			// If second marker's position is other than -1, we can draw it.
-            if (iSecondMarkerPosition != -1)
-            {
-                // Set pen colour to second marker's colour.
-                dc.SetPen(wxPen(cSecondMarkerColour, 1, wxPENSTYLE_SOLID));
-
-                dc.DrawLine(
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 + iSecondMarkerPosition,
-                        SurfaceRect.GetTop()),
-                    wxPoint(
-                        SurfaceRect.GetLeft() + 4 + iSecondMarkerPosition,
-                        SurfaceRect.GetBottom()));
-
-				// Prepare temporary string TmpS for second marker.
-                switch (eRulerUnits)
-                {
-                case ERulerUnits::ruCentimetres:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToCentimetresHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" cm");
-
-                    break;
-                case ERulerUnits::ruInches:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToInchesHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" in");
-
-                    break;
-                case ERulerUnits::ruPicas:
-                    TmpS =
-                        wxString::FromDouble(
-                            PixelsToPicasHorizontal(
-                                0, iSecondMarkerPosition), 2) +
-                        wxString(" pica");
-
-                    break;
-                case ERulerUnits::ruPixels:
-                    TmpS =
-                        wxString::Format(
-                            wxT("%d px"), iSecondMarkerPosition);
-
-                    break;
-                }
+        if (pCache->dScaleFactor != dScaleFactor)
+        {
+            pCache->dScaleFactor = dScaleFactor;
+            pCache->bValid = false;
+            pCache->ValidRect = wxRect();
+            pCache->bSurfaceJobPending = false;
+        }
 
-				// Retrieve text width and text height of TmpS string.
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
+        pCache->ulLastUse = m_ulPaintCounter;
+        m_pScaleLayer = pCache;
 
-				// Draw text of second marker on device context depending on
-				// ruler's position and text width and height.
-                if (SurfaceRect.GetLeft() + 4 + iSecondMarkerPosition + 4 +
-                    TextWidth > SurfaceRect.GetRight())
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() + 4 +
-                            iSecondMarkerPosition - 4 - TextWidth,
-                            SurfaceRect.GetTop() +
-                            (SurfaceRect.GetHeight() / 3) - TextHeight));
-                }
-                else
-                {
-                    dc.DrawText(
-                        TmpS,
-                        wxPoint(
-                            SurfaceRect.GetLeft() + 4 + 
-                            iSecondMarkerPosition + 4,
-                            SurfaceRect.GetTop() +
-                            (SurfaceRect.GetHeight() / 3) - TextHeight));
-                }
-            }
+        // Select layer of the cache in layer's device context. Invalid
+        // layer is selected by its rebuild.
+        m_ScaleLayerDC.SelectObject(wxNullBitmap);
+        if (pCache->bValid && pCache->Layer.IsOk())
+        {
+            m_ScaleLayerDC.SelectObject(pCache->Layer);
 
-            break;
+            // Extents depend on font of cache's renderer.
+            MeasureLabelExtents(SurfaceRect);
         }
+
+#ifdef _DEBUG
+        wxLogInfo(
+            wxString::Format(
+                "Ruler's layers of scale factor %.2f were selected.",
+                dScaleFactor));
+#endif
     }
 
-    void CDrawPanel::DrawRulerScale(
-        wxDC& dc, wxRect& SurfaceRect,
-        wxColour& cRulerScaleColour,
-        ERulerPosition eRulerPosition,
-        ERulerUnits eRulerUnits)
+    void CDrawPanel::MeasureLabelExtents(const wxRect& SurfaceRect)
     {
-		// Prepare device context. We will draw ruler's scale on it.
-        unsigned int I, sT, pT;
-        double ID;
-        wxString TmpS;
-        wxCoord TextWidth, TextHeight;
-
-		// Set device context brush to transparent.
-        dc.SetBrush(wxBrush(wxTransparentColour, wxBRUSHSTYLE_TRANSPARENT));
+        CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
+        wxMemoryDC& MemoryDC = m_ScaleLayerDC;
+
+        // Measure the widest marker's label possible for current ruler's
+        // length and unit of measurement. It is used for computation of
+        // marker's bounds.
+        m_pScaleLayer->Renderer.UpdateFont(GetMetrics());
+        MemoryDC.SetFont(m_pScaleLayer->Renderer.GetFont());
+        m_MarkerLabelExtent =
+            CRulerRenderer::MeasureMarkerLabel(
+                MemoryDC, SurfaceRect.GetSize(), pMainFrame->m_eRulerUnits,
+                GetPixelPerInch(m_uDisplayNo));
+
+        // Measure the widest line of render statistics overlay.
+        MeasureStatisticsLines(MemoryDC);
+    }
 
-        // Set device context pen to SOLID, with width equal 1 and colour
-		// equal to m_RulerScaleColour.
-        dc.SetPen(wxPen(cRulerScaleColour, 1, wxPENSTYLE_SOLID));
+    void CDrawPanel::MeasureStatisticsLines(wxDC& dc)
+    {
+        wxCoord TextWidth, TextHeight;
 
-        // Set device context font size to 6 and font style to normal, weight
-        // to normal and family to default.
-        wxFont font(
-            6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-        dc.SetFont(font);
-		// Set device context text foreground colour to m_RulerScaleColour.
-        dc.SetTextForeground(cRulerScaleColour);
+        dc.GetTextExtent(
+            wxString(wxT("scale 99999us")), &TextWidth, &TextHeight);
+        wxSize Extent(TextWidth, TextHeight);
 
-        // Depending on ruler's position and ruler's unit of measurement:
-        switch (eRulerPosition)
+        // Counters grow without limit, so formatted lines are measured.
+        for (const wxString& Line : m_asRenderStatisticsLines)
         {
-        case ERulerPosition::rpLeft:    // Ruler's position on left side.
-            switch (eRulerUnits)
-            {
-            case ERulerUnits::ruCentimetres: // Ruler's unit as centimetres.
-                sT = SurfaceRect.GetHeight() - 10;
-                ID = 0.0;
-                I = CentimetresToPixelsVertical(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(wxPoint(0, pT), wxPoint(12, pT));
-
-                        TmpS = wxString("0.00");
-                        dc.DrawText(TmpS, wxPoint(14, pT - 2));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(5, pT));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(5, pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(3, pT));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = CentimetresToPixelsVertical(0, ID);
-                }
-
-                dc.DrawLine(wxPoint(0, 4 + sT), wxPoint(12, 4 + sT));
-
-                TmpS = 
-                    wxString::FromDouble(
-                        PixelsToCentimetresVertical(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(TmpS, wxPoint(14, 4 + sT - TextHeight));
-
-                break;
-            case ERulerUnits::ruInches:  // Ruler's unit as inches.
-                sT = SurfaceRect.GetHeight() - 10;
-                ID = 0.0;
-                I = InchesToPixelsVertical(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(wxPoint(0, pT), wxPoint(12, pT));
-
-                        TmpS = wxString("0.00");
-                        dc.DrawText(TmpS, wxPoint(14, pT - 2));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(5, pT));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(5, pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(3, pT));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = InchesToPixelsVertical(0, ID);
-                }
-
-                dc.DrawLine(wxPoint(0, 4 + sT), wxPoint(12, 4 + sT));
-
-                TmpS = 
-                    wxString::FromDouble(PixelsToInchesVertical(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(TmpS, wxPoint(14, 4 + sT - TextHeight));
-
-                break;
-            case ERulerUnits::ruPixels:  // Ruler's unit as pixels.
-                sT = (SurfaceRect.GetHeight() - 8) / 2;
-
-                for (I = 0; I <= sT - 1; I++)
-                {
-                    pT = 4 + (I * 2);
-
-                    if ((I == 0) || (I == sT - 1))
-                    {
-                        dc.DrawLine(wxPoint(0, pT), wxPoint(12, pT));
-
-                        if (I == 0)
-                        {
-                            TmpS = wxString("0");
-                            dc.DrawText(TmpS, wxPoint(14, pT - 2));
-                        }
-
-                        if (I == sT - 1)
-                        {
-                            TmpS = wxString::Format(wxT("%d"), (sT - 1) * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(14, pT - TextHeight + 2));
-                        }
-                    }
-                    else
-                    {
-                        if (I % 10 == 0)
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(5, pT));
-                            TmpS = wxString::Format(wxT("%d"), I * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(5, pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(3, pT));
-                        }
-                    }
-                }
-
-                break;
-            case ERulerUnits::ruPicas:   // Ruler's unit as picas.
-                sT = SurfaceRect.GetHeight() - 10;
-                ID = 0.0;
-                I = PicasToPixelsVertical(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(wxPoint(0, pT), wxPoint(12, pT));
-
-                        TmpS = wxString("0.00");
-                        dc.DrawText(TmpS, wxPoint(14, pT - 2));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 6.0), 0.0))
-                        {
-                            dc.DrawLine(wxPoint(0, pT), wxPoint(5, pT));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(5, pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            if (AreSame(std::fmod(ID, 1.0), 0.0))
-                            {
-                                dc.DrawLine(wxPoint(0, pT), wxPoint(8, pT));
-                            }
-                            else
-                            {
-                                dc.DrawLine(wxPoint(0, pT), wxPoint(3, pT));
-                            }
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = PicasToPixelsVertical(0, ID);
-                }
+            dc.GetTextExtent(Line, &TextWidth, &TextHeight);
+            Extent.Set(
+                std::max(Extent.GetWidth(), TextWidth),
+                std::max(Extent.GetHeight(), TextHeight));
+        }
 
-                dc.DrawLine(wxPoint(0, 4 + sT), wxPoint(12, 4 + sT));
+        m_StatisticsLineExtent = Extent;
+    }
 
-                TmpS = wxString::FromDouble(PixelsToPicasVertical(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(TmpS, wxPoint(14, 4 + sT - TextHeight));
+    void CDrawPanel::RebuildScaleLayer(wxRect& SurfaceRect)
+    {
+        SScaleLayerCache& ScaleLayer = *m_pScaleLayer;
+        double dContentScale = GetContentScaleFactor();
+        SRulerRenderConfig Config = GetRenderConfig();
 
-                break;
-            }
+        // Layer pre-rendered in idle time makes switching of ruler's
+        // position or unit of measurement a single swap.
+        if (SwapPrerenderedLayer(SurfaceRect, Config))
+            return;
 
-            break;
-        case ERulerPosition::rpTop:
-            switch (eRulerUnits)
+        // Composition of image background of a long ruler is expensive, so
+        // it is done by worker thread and the UI thread keeps painting.
+        if ((Config.eRulerBackgroundType == ERulerBackgroundType::btImage) &&
+            !ScaleLayer.Renderer.IsSurfaceLayerValid(SurfaceRect, Config))
+        {
+            SubmitSurfaceJob(SurfaceRect, Config);
+
+            // Previous content of the layer is shown until the new surface
+            // is ready, if it still fits the surface.
+            if (ScaleLayer.Layer.IsOk() &&
+                (ScaleLayer.Layer.GetLogicalSize() == SurfaceRect.GetSize()) &&
+                (ScaleLayer.Layer.GetScaleFactor() == dContentScale) &&
+                !ScaleLayer.ValidRect.IsEmpty())
             {
-            case ERulerUnits::ruCentimetres: // Ruler's unit as centimetres.
-                sT = SurfaceRect.GetWidth() - 10;
-                ID = 0.0;
-                I = CentimetresToPixelsHorizontal(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 12));
-
-                        TmpS = wxString("0.00");
-                        dc.DrawText(TmpS, wxPoint(pT, 12));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 5));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(pT - (TextWidth / 2), 5));
-                        }
-                        else
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 3));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = CentimetresToPixelsHorizontal(0, ID);
-                }
-
-                dc.DrawLine(wxPoint(4 + sT, 0), wxPoint(4 + sT, 12));
-
-                TmpS = 
-                    wxString::FromDouble(
-                        PixelsToCentimetresHorizontal(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(TmpS, wxPoint(4 + sT - TextWidth, 12));
-
-                break;
-            case ERulerUnits::ruInches:  // Ruler's unit as inches.
-                sT = SurfaceRect.GetWidth() - 10;
-                ID = 0.0;
-                I = InchesToPixelsHorizontal(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 12));
-
-                        TmpS = wxString("0.00");
-                        dc.DrawText(TmpS, wxPoint(pT, 12));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 5));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(pT - (TextWidth / 2), 5));
-                        }
-                        else
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 3));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = InchesToPixelsHorizontal(0, ID);
-                }
-
-                dc.DrawLine(wxPoint(4 + sT, 0), wxPoint(4 + sT, 12));
-
-                TmpS = 
-                    wxString::FromDouble(PixelsToInchesHorizontal(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(TmpS, wxPoint(4 + sT - TextWidth, 12));
-
-                break;
-            case ERulerUnits::ruPixels:  // Ruler's unit as pixels.
-                sT = (SurfaceRect.GetWidth() - 8) / 2;
-
-                for (I = 0; I <= sT - 1; I++)
-                {
-                    pT = 4 + (I * 2);
-
-                    if ((I == 0) || (I == sT - 1))
-                    {
-                        dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 12));
-
-                        if (I == 0)
-                        {
-                            TmpS = wxString("0");
-                            dc.DrawText(TmpS, wxPoint(pT, 12));
-                        }
-
-                        if (I == sT - 1)
-                        {
-                            TmpS = wxString::Format(wxT("%d"), (sT - 1) * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(TmpS, wxPoint(pT - TextWidth, 12));
-                        }
-                    }
-                    else
-                    {
-                        if (I % 10 == 0)
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 5));
-
-                            TmpS = wxString::Format(wxT("%d"), I * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(pT - (TextWidth / 2) + 2, 5));
-                        }
-                        else
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 3));
-                        }
-                    }
-                }
+                if (!m_ScaleLayerDC.GetSelectedBitmap().IsOk())
+                    m_ScaleLayerDC.SelectObject(ScaleLayer.Layer);
 
-                break;
-            case ERulerUnits::ruPicas:   // Ruler's unit as picas.
-                sT = SurfaceRect.GetWidth() - 10;
-                ID = 0.0;
-                I = PicasToPixelsHorizontal(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 12));
-
-                        TmpS = wxString("0.00");
-                        dc.DrawText(TmpS, wxPoint(pT, 12));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 6.0), 0.0))
-                        {
-                            dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 5));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS, wxPoint(pT - (TextWidth / 2), 5));
-                        }
-                        else
-                        {
-                            if (AreSame(std::fmod(ID, 1.0), 0.0))
-                            {
-                                dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 8));
-                            }
-                            else
-                            {
-                                dc.DrawLine(wxPoint(pT, 0), wxPoint(pT, 3));
-                            }
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = PicasToPixelsHorizontal(0, ID);
-                }
+                MeasureLabelExtents(SurfaceRect);
 
-                dc.DrawLine(wxPoint(4 + sT, 0), wxPoint(4 + sT, 12));
+                ScaleLayer.PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+                ScaleLayer.bValid = true;
 
-                TmpS = wxString::FromDouble(PixelsToPicasHorizontal(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(TmpS, wxPoint(4 + sT - TextWidth, 12));
-
-                break;
+                return;
             }
 
-            break;
-        case ERulerPosition::rpRight:
-            switch (eRulerUnits)
-            {
-            case ERulerUnits::ruCentimetres: // Ruler's unit as centimetres.
-                sT = SurfaceRect.GetHeight() - 10;
-                ID = 0.0;
-                I = CentimetresToPixelsVertical(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(
-                            wxPoint(SurfaceRect.GetRight() - 1 - 12, pT),
-                            wxPoint(SurfaceRect.GetRight(), pT));
-
-                        TmpS = wxString("0.00");
-                        dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                        dc.DrawText(
-                            TmpS,
-                            wxPoint(
-                                SurfaceRect.GetRight() - 1 - 14 - TextWidth,
-                                pT - 2));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight() - 1 - 5, pT),
-                                wxPoint(SurfaceRect.GetRight(), pT));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    SurfaceRect.GetRight() - 1 - 5 - TextWidth,
-                                    pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight() - 1 - 3, pT),
-                                wxPoint(SurfaceRect.GetRight(), pT));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = CentimetresToPixelsVertical(0, ID);
-                }
+            // Otherwise solid background in ruler's background colour is
+            // used as cheap placeholder.
+            Config.eRulerBackgroundType = ERulerBackgroundType::btSolid;
+        }
 
-                dc.DrawLine(
-                    wxPoint(SurfaceRect.GetRight() - 1 - 12, 4 + sT),
-                    wxPoint(SurfaceRect.GetRight(), 4 + sT));
+        // (Re)create layer bitmap only when its size or content scale factor
+        // was changed. Layer has physical resolution of the display, so it
+        // is not resampled when it is copied to the window. Bitmap can not
+        // be recreated while it is selected in device context.
+        if (!ScaleLayer.Layer.IsOk() ||
+            (ScaleLayer.Layer.GetLogicalSize() != SurfaceRect.GetSize()) ||
+            (ScaleLayer.Layer.GetScaleFactor() != dContentScale))
+        {
+            m_ScaleLayerDC.SelectObject(wxNullBitmap);
+            ScaleLayer.Layer.CreateWithLogicalSize(
+                SurfaceRect.GetSize(), dContentScale);
+        }
 
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToCentimetresVertical(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetRight() - 1 - 14 - TextWidth,
-                        4 + sT - TextHeight));
+        // Layer bitmap stays selected in its memory device context, so
+        // painting does not have to create device context on every frame.
+        if (!m_ScaleLayerDC.GetSelectedBitmap().IsOk())
+            m_ScaleLayerDC.SelectObject(ScaleLayer.Layer);
 
-                break;
-            case ERulerUnits::ruInches:  // Ruler's unit as inches.
-                sT = SurfaceRect.GetHeight() - 10;
-                ID = 0.0;
-                I = InchesToPixelsVertical(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(
-                            wxPoint(SurfaceRect.GetRight(), pT),
-                            wxPoint(SurfaceRect.GetRight() - 1 - 12, pT));
-
-                        TmpS = wxString("0.00");
-                        dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                        dc.DrawText(
-                            TmpS,
-                            wxPoint(
-                                SurfaceRect.GetRight() - 1 - 14 - TextWidth,
-                                pT - 2));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight(), pT),
-                                wxPoint(SurfaceRect.GetRight() - 1 - 5, pT));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    SurfaceRect.GetRight() - 1 - 5 - TextWidth,
-                                    pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight() - 1 - 3, pT),
-                                wxPoint(SurfaceRect.GetRight(), pT));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = InchesToPixelsVertical(0, ID);
-                }
+        // Clear layer with panel's background colour. Surface and scale are
+        // drawn later, only in parts exposed by paints.
+        wxMemoryDC& MemoryDC = m_ScaleLayerDC;
+        MemoryDC.SetBackground(wxBrush(GetBackgroundColour()));
+        MemoryDC.Clear();
+        ScaleLayer.ValidRect = wxRect();
 
-                dc.DrawLine(
-                    wxPoint(SurfaceRect.GetRight() - 1 - 12, 4 + sT),
-                    wxPoint(SurfaceRect.GetRight(), 4 + sT));
+        // Cache ruler's appearance. It is used by every paint until the
+        // next rebuild.
+        ScaleLayer.RenderConfig = Config;
 
-                TmpS = wxString::FromDouble(PixelsToInchesVertical(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetRight() - 1 - 14 - TextWidth,
-                        4 + sT - TextHeight));
+        // Measure extents of marker's label and statistics overlay.
+        MeasureLabelExtents(SurfaceRect);
 
-                break;
-            case ERulerUnits::ruPixels:  // Ruler's unit as pixels.
-                sT = (SurfaceRect.GetHeight() - 8) / 2;
+        // Store PPI value used for this reset and mark layer as valid.
+        ScaleLayer.PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+        ScaleLayer.bValid = true;
 
-                for (I = 0; I <= sT - 1; I++)
-                {
-                    pT = 4 + (I * 2);
-
-                    if ((I == 0) || (I == sT - 1))
-                    {
-                        dc.DrawLine(
-                            wxPoint(SurfaceRect.GetRight() - 1 - 12, pT),
-                            wxPoint(SurfaceRect.GetRight(), pT));
-
-                        if (I == 0)
-                        {
-                            TmpS = wxString("0");
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    SurfaceRect.GetRight() - 1 - 15 - 
-                                    TextWidth, pT - 2));
-                        }
-
-                        if (I == sT - 1)
-                        {
-                            TmpS = wxString::Format(wxT("%d"), (sT - 1) * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    SurfaceRect.GetRight() - 1 - 17 - 
-                                    TextWidth, pT - TextHeight + 2));
-                        }
-                    }
-                    else
-                    {
-                        if (I % 10 == 0)
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight() - 1 - 5, pT),
-                                wxPoint(SurfaceRect.GetRight(), pT));
-                            TmpS = wxString::Format(wxT("%d"), I * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    SurfaceRect.GetRight() - 1 - 5 - TextWidth,
-                                    pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight() - 1 - 3, pT),
-                                wxPoint(SurfaceRect.GetRight(), pT));
-                        }
-                    }
-                }
+#ifdef _DEBUG
+        wxLogInfo(wxString("Ruler's scale layer was rebuilt."));
+#endif
+    }
 
-                break;
-            case ERulerUnits::ruPicas:   // Ruler's unit as picas.
-                sT = SurfaceRect.GetHeight() - 10;
-                ID = 0.0;
-                I = PicasToPixelsVertical(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(
-                            wxPoint(SurfaceRect.GetRight() - 1 - 12, pT),
-                            wxPoint(SurfaceRect.GetRight(), pT));
-
-                        TmpS = wxString("0.00");
-                        dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                        dc.DrawText(
-                            TmpS,
-                            wxPoint(
-                                SurfaceRect.GetRight() - 1 - 14 - TextWidth,
-                                pT - 2));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 6.0), 0.0))
-                        {
-                            dc.DrawLine(
-                                wxPoint(SurfaceRect.GetRight() - 1 - 5, pT),
-                                wxPoint(SurfaceRect.GetRight(), pT));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    SurfaceRect.GetRight() - 1 - 5 - TextWidth,
-                                    pT - (TextHeight / 2)));
-                        }
-                        else
-                        {
-                            if (AreSame(std::fmod(ID, 1.0), 0.0))
-                            {
-                                dc.DrawLine(
-                                    wxPoint(
-                                        SurfaceRect.GetRight() - 1 - 8, pT),
-                                    wxPoint(SurfaceRect.GetRight(), pT));
-                            }
-                            else
-                            {
-                                dc.DrawLine(
-                                    wxPoint(
-                                        SurfaceRect.GetRight() - 1 - 3, pT),
-                                    wxPoint(SurfaceRect.GetRight(), pT));
-                            }
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = PicasToPixelsVertical(0, ID);
-                }
+    void CDrawPanel::SubmitSurfaceJob(
+        const wxRect& SurfaceRect, const SRulerRenderConfig& Config)
+    {
+        SScaleLayerCache& ScaleLayer = *m_pScaleLayer;
 
-                dc.DrawLine(
-                    wxPoint(SurfaceRect.GetRight() - 1 - 12, 4 + sT),
-                    wxPoint(SurfaceRect.GetRight(), 4 + sT));
+        // The same surface is already being composed (e.g. only units were
+        // changed since submission).
+        if (ScaleLayer.bSurfaceJobPending &&
+            (ScaleLayer.SurfaceJobRect == SurfaceRect) &&
+            CRulerRenderer::IsSameSurface(ScaleLayer.SurfaceJobConfig, Config))
+            return;
 
-                TmpS = wxString::FromDouble(PixelsToPicasVertical(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        SurfaceRect.GetRight() - 1 - 14 - TextWidth,
-                        4 + sT - TextHeight));
+        // Description is prepared here, worker thread touches only the job.
+        std::unique_ptr<SLayerRenderJob> pJob(new SLayerRenderJob());
+        pJob->ulId = ++m_ulSurfaceJobCounter;
+        CRulerRenderer::DescribeSurfaceLayer(
+            SurfaceRect.GetSize(), Config, pJob->Desc, pJob->Surface);
 
-                break;
-            }
+        ScaleLayer.bSurfaceJobPending = true;
+        ScaleLayer.ulSurfaceJob = pJob->ulId;
+        ScaleLayer.SurfaceJobRect = SurfaceRect;
+        ScaleLayer.SurfaceJobConfig = Config;
 
-            break;
-        case ERulerPosition::rpBottom:
-            switch (eRulerUnits)
-            {
-            case ERulerUnits::ruCentimetres: // Ruler's unit as centimetres.
-                sT = SurfaceRect.GetWidth() - 10;
-                ID = 0.0;
-                I = CentimetresToPixelsHorizontal(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(
-                            wxPoint(pT, SurfaceRect.GetBottom() - 1 - 12),
-                            wxPoint(pT, SurfaceRect.GetBottom()));
-
-                        TmpS = wxString("0.00");
-                        dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                        dc.DrawText(
-                            TmpS,
-                            wxPoint(
-                                pT,
-                                SurfaceRect.GetBottom() - 1 - 12 - 
-                                TextHeight));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 1 - 5),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    pT - (TextWidth / 2),
-                                    SurfaceRect.GetBottom() - 1 - 5 - 
-                                    TextHeight));
-                        }
-                        else
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 1 - 3),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = CentimetresToPixelsHorizontal(0, ID);
-                }
+        m_LayerRenderWorker.Submit(std::move(pJob));
 
-                dc.DrawLine(
-                    wxPoint(4 + sT, SurfaceRect.GetBottom() - 1 - 12),
-                    wxPoint(4 + sT, SurfaceRect.GetBottom()));
+#ifdef _DEBUG
+        wxLogInfo(wxString("Ruler's surface job was submitted."));
+#endif
+    }
 
-                TmpS =
-                    wxString::FromDouble(
-                        PixelsToCentimetresHorizontal(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        4 + sT - TextWidth,
-                        SurfaceRect.GetBottom() - 1 - 12 - TextHeight));
+    bool CDrawPanel::SwapPrerenderedLayer(
+        const wxRect& SurfaceRect, const SRulerRenderConfig& Config)
+    {
+        SScaleLayerCache& ScaleLayer = *m_pScaleLayer;
+        wxRealPoint PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+        wxBitmap Layer;
 
-                break;
-            case ERulerUnits::ruInches:  // Ruler's unit as inches.
-                sT = SurfaceRect.GetWidth() - 10;
-                ID = 0.0;
-                I = InchesToPixelsHorizontal(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(
-                            wxPoint(pT, SurfaceRect.GetBottom() - 1 - 12),
-                            wxPoint(pT, SurfaceRect.GetBottom()));
-
-                        TmpS = wxString("0.00");
-                        dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                        dc.DrawText(
-                            TmpS,
-                            wxPoint(
-                                pT,
-                                SurfaceRect.GetBottom() - 1 - 12 - 
-                                TextHeight));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 1.0), 0.0))
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 5),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    pT - (TextWidth / 2),
-                                    SurfaceRect.GetBottom() - 1 - 5 - 
-                                    TextHeight));
-                        }
-                        else
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 1 - 3),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = InchesToPixelsHorizontal(0, ID);
-                }
+        if (!m_LayerPrerenderCache.Take(
+                Config, SurfaceRect.GetSize(), PixelPerInch, Layer))
+        {
+            m_RenderStatistics.AddLayerCacheMiss();
 
-                dc.DrawLine(
-                    wxPoint(4 + sT, SurfaceRect.GetBottom() - 1 - 12),
-                    wxPoint(4 + sT, SurfaceRect.GetBottom()));
+            return false;
+        }
 
-                TmpS =
-                    wxString::FromDouble(PixelsToInchesHorizontal(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        4 + sT - TextWidth,
-                        SurfaceRect.GetBottom() - 1 - 12 - TextHeight));
+        m_RenderStatistics.AddLayerCacheHit();
 
-                break;
-            case ERulerUnits::ruPixels:  // Ruler's unit as pixels.
-                sT = (SurfaceRect.GetWidth() - 8) / 2;
+        // Bitmap can not be replaced while it is selected in device context.
+        m_ScaleLayerDC.SelectObject(wxNullBitmap);
 
-                for (I = 0; I <= sT - 1; I++)
-                {
-                    pT = 4 + (I * 2);
-
-                    if ((I == 0) || (I == sT - 1))
-                    {
-                        dc.DrawLine(
-                            wxPoint(pT, SurfaceRect.GetBottom() - 12),
-                            wxPoint(pT, SurfaceRect.GetBottom()));
-
-                        if (I == 0)
-                        {
-                            TmpS = wxString("0");
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    pT,
-                                    SurfaceRect.GetBottom() - 12 - 
-                                    TextHeight));
-                        }
-
-                        if (I == sT - 1)
-                        {
-                            TmpS = wxString::Format(wxT("%d"), (sT - 1) * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    pT - TextWidth,
-                                    SurfaceRect.GetBottom() - 12 - 
-                                    TextHeight));
-                        }
-                    }
-                    else
-                    {
-                        if (I % 10 == 0)
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 6),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-
-                            TmpS = wxString::Format(wxT("%d"), I * 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    pT - (TextWidth / 2) + 2,
-                                    SurfaceRect.GetBottom() - 5 - TextHeight));
-                        }
-                        else
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 4),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-                        }
-                    }
-                }
+        // Keep complete previous layer, so switching back is a swap too.
+        if (ScaleLayer.Layer.IsOk() &&
+            !ScaleLayer.bSurfaceJobPending &&
+            (ScaleLayer.ValidRect ==
+                wxRect(ScaleLayer.Layer.GetLogicalSize())) &&
+            CLayerPrerenderCache::IsSameAppearance(
+                ScaleLayer.RenderConfig, Config))
+        {
+            m_LayerPrerenderCache.Store(
+                ScaleLayer.RenderConfig, ScaleLayer.Layer.GetLogicalSize(),
+                ScaleLayer.PixelPerInch, ScaleLayer.Layer);
+        }
 
-                break;
-            case ERulerUnits::ruPicas:   // Ruler's unit as picas.
-                sT = SurfaceRect.GetWidth() - 10;
-                ID = 0.0;
-                I = PicasToPixelsHorizontal(0, ID);
-                while (I < sT)
-                {
-                    pT = 4 + I;
-
-                    if (AreSame(ID, 0.0))
-                    {
-                        dc.DrawLine(
-                            wxPoint(pT, SurfaceRect.GetBottom() - 1 - 12),
-                            wxPoint(pT, SurfaceRect.GetBottom()));
-
-                        TmpS = wxString("0.00");
-                        dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                        dc.DrawText(
-                            TmpS,
-                            wxPoint(
-                                pT,
-                                SurfaceRect.GetBottom() - 1 - 12 - 
-                                TextHeight));
-                    }
-                    else
-                    {
-                        if (AreSame(std::fmod(ID, 6.0), 0.0))
-                        {
-                            dc.DrawLine(
-                                wxPoint(pT, SurfaceRect.GetBottom() - 1 - 5),
-                                wxPoint(pT, SurfaceRect.GetBottom()));
-
-                            TmpS = wxString::FromDouble(ID, 2);
-                            dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                            dc.DrawText(
-                                TmpS,
-                                wxPoint(
-                                    pT - (TextWidth / 2),
-                                    SurfaceRect.GetBottom() - 1 - 5 - 
-                                    TextHeight));
-                        }
-                        else
-                        {
-                            if (AreSame(std::fmod(ID, 1.0), 0.0))
-                            {
-                                dc.DrawLine(
-                                    wxPoint(
-                                        pT, SurfaceRect.GetBottom() - 1 - 8),
-                                    wxPoint(pT, SurfaceRect.GetBottom()));
-                            }
-                            else
-                            {
-                                dc.DrawLine(
-                                    wxPoint(
-                                        pT, SurfaceRect.GetBottom() - 1 - 3),
-                                    wxPoint(pT, SurfaceRect.GetBottom()));
-                            }
-                        }
-                    }
-
-                    ID = ID + 0.125;
-                    I = PicasToPixelsHorizontal(0, ID);
-                }
+        // Pre-rendered layer is complete, so no part of it is drawn later.
+        ScaleLayer.Layer = Layer;
+        m_ScaleLayerDC.SelectObject(ScaleLayer.Layer);
+        ScaleLayer.ValidRect = SurfaceRect;
+        ScaleLayer.RenderConfig = Config;
 
-                dc.DrawLine(
-                    wxPoint(4 + sT, SurfaceRect.GetBottom() - 1 - 12),
-                    wxPoint(4 + sT, SurfaceRect.GetBottom()));
+        MeasureLabelExtents(SurfaceRect);
 
-                TmpS =
-                    wxString::FromDouble(PixelsToPicasHorizontal(0, sT), 2);
-                dc.GetTextExtent(TmpS, &TextWidth, &TextHeight);
-                dc.DrawText(
-                    TmpS,
-                    wxPoint(
-                        4 + sT - TextWidth,
-                        SurfaceRect.GetBottom() - 1 - 12 - TextHeight));
+        ScaleLayer.PixelPerInch = PixelPerInch;
+        ScaleLayer.bValid = true;
 
-                break;
-            }
+#ifdef _DEBUG
+        wxLogInfo(wxString("Pre-rendered ruler's layer was used."));
+#endif
 
-            break;
-        }
+        return true;
     }
 
-    void CDrawPanel::DrawRulerSurface(
-        wxDC& dc, wxRect& SurfaceRect,
-        ERulerPosition eRulerPosition,
-        ERulerBackgroundType eRulerBackgroundType,
-        wxColour& cRulerBackgroundColour,
-        wxColour& cRulerBackgroundStartColour,
-        wxColour& cRulerBackgroundEndColour,
-        wxBitmap RulerBackgroundBitmapLeftH,
-        wxBitmap RulerBackgroundBitmapMiddleH,
-        wxBitmap RulerBackgroundBitmapRightH,
-        wxBitmap RulerBackgroundBitmapTopV,
-        wxBitmap RulerBackgroundBitmapMiddleV,
-        wxBitmap RulerBackgroundBitmapBottomV)
+    void CDrawPanel::OnIdle(wxIdleEvent& Event)
     {
-        // Draw surface of ruler:
-        switch (eRulerPosition)
-        {
-        case ERulerPosition::rpLeft:    // Ruler's position on left side.
-            switch (eRulerBackgroundType)
-            {
-            // Ruler's background as solid.
-            case ERulerBackgroundType::btSolid:
-				// Prepare display context's brush.
-                dc.SetBrush(
-                    wxBrush(cRulerBackgroundColour, wxBRUSHSTYLE_SOLID));
-
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColour(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
-
-                // Draw rectangle on whole surface size.
-                dc.DrawRectangle(SurfaceRect);
-
-                break;
-            // Ruler's background as gradient.
-            case ERulerBackgroundType::btGradient:
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColour(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
+        Event.Skip();
 
-                // Draw gradient rectangle on whole surface size.
-                dc.GradientFillLinear(
-                    SurfaceRect,
-                    cRulerBackgroundStartColour, cRulerBackgroundEndColour,
-                    wxRIGHT);
+        // Retrieve pointer to CMainFrame class.
+        CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
 
-                break;
-               // Ruler's background as image.
-            case ERulerBackgroundType::btImage:
-                // TODO: For now we use simple bitmap drawing. It must be done
-                //       in a better way.
-
-				dc.DrawBitmap(
-					RulerBackgroundBitmapLeftH,
-					wxPoint(SurfaceRect.GetX(), SurfaceRect.GetY()));
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapTopV,
-                    wxPoint(SurfaceRect.GetX(), SurfaceRect.GetY()));
-
-                for (int i = 0; i <= (SurfaceRect.GetHeight() - 8) / 2; i++)
-                {
-                    dc.DrawBitmap(
-                        RulerBackgroundBitmapMiddleV,
-                        wxPoint(
-                            SurfaceRect.GetX(),
-                            SurfaceRect.GetY() + 4 + (2 * i)));
-                }
+        // Budget is in MB, layers over the new budget are dropped at once.
+        m_LayerPrerenderCache.SetMemoryBudget(
+            static_cast<size_t>(
+                std::max(pMainFrame->m_iLayerPrerenderBudget, 0)) *
+            1024 * 1024);
+
+        // Pre-render only from complete current layers, never while user
+        // interacts with the ruler and never while pre-render worker
+        // composes surface (its event wakes idle processing again).
+        if ((m_pScaleLayer == nullptr) ||
+            !m_pScaleLayer->bValid ||
+            m_pScaleLayer->bSurfaceJobPending ||
+            m_bPrerenderJobPending ||
+            m_bDragging ||
+            m_bInputPending ||
+            (m_LayerPrerenderCache.GetMemoryBudget() == 0))
+            return;
 
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapBottomV,
-                    wxPoint(SurfaceRect.GetX(), SurfaceRect.GetBottom() - 3));
+        SScaleLayerCache& ScaleLayer = *m_pScaleLayer;
+        wxSize Size = ScaleLayer.Layer.GetLogicalSize();
+        SRulerRenderConfig Config = ScaleLayer.RenderConfig;
+        Config.iFirstMarkerPosition = -1;
+        Config.iSecondMarkerPosition = -1;
 
-                break;
-            }
+        // Drop layers which can not be used anymore, they only hold memory.
+        m_LayerPrerenderCache.Prune(Config, Size, ScaleLayer.PixelPerInch);
 
-            break;
-        // Ruler's position on top.
-        case ERulerPosition::rpTop:
-            switch (eRulerBackgroundType)
+        // Pre-renders candidate if it is not cached yet and fits the budget.
+        auto Prerender = [&](const SRulerRenderConfig& Candidate)
+        {
+            bool bVertical =
+                (Config.eRulerPosition == ERulerPosition::rpLeft) ||
+                (Config.eRulerPosition == ERulerPosition::rpRight);
+            bool bCandidateVertical =
+                (Candidate.eRulerPosition == ERulerPosition::rpLeft) ||
+                (Candidate.eRulerPosition == ERulerPosition::rpRight);
+            wxSize CandidateSize =
+                (bVertical == bCandidateVertical) ?
+                    Size : wxSize(Size.GetHeight(), Size.GetWidth());
+
+            if (m_LayerPrerenderCache.Contains(
+                    Candidate, CandidateSize, ScaleLayer.PixelPerInch) ||
+                !m_LayerPrerenderCache.CanFit(
+                    CandidateSize, Candidate.dContentScale))
+                return false;
+
+            // Composition of image background of a long ruler is expensive,
+            // so it is done by pre-render worker. Layer is rendered with the
+            // composed surface by a later idle event.
+            if ((Candidate.eRulerBackgroundType ==
+                    ERulerBackgroundType::btImage) &&
+                !m_PrerenderRenderer.IsSurfaceLayerValid(
+                    wxRect(CandidateSize), Candidate))
             {
-            // Ruler's background as solid.
-            case ERulerBackgroundType::btSolid:
-				// Prepare display context's brush.
-                dc.SetBrush(
-                    wxBrush(cRulerBackgroundColour, wxBRUSHSTYLE_SOLID));
-
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColor(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
+                std::unique_ptr<SLayerRenderJob> pJob(new SLayerRenderJob());
+                pJob->ulId = ++m_ulPrerenderJob;
+                CRulerRenderer::DescribeSurfaceLayer(
+                    CandidateSize, Candidate, pJob->Desc, pJob->Surface);
 
-                // Draw rectangle on whole surface size.
-                dc.DrawRectangle(SurfaceRect);
+                m_bPrerenderJobPending = true;
+                m_PrerenderJobSize = CandidateSize;
+                m_PrerenderJobConfig = Candidate;
 
-                break;
-            // Ruler's background as gradient.
-            case ERulerBackgroundType::btGradient:
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColour(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
+                m_PrerenderWorker.Submit(std::move(pJob));
 
-                // Draw gradient rectangle on whole surface size.
-                dc.GradientFillLinear(
-                    SurfaceRect,
-                    cRulerBackgroundStartColour, cRulerBackgroundEndColour,
-                    wxDOWN);
+                return true;
+            }
 
-                break;
-            // Ruler's background as image.
-            case ERulerBackgroundType::btImage:
-                // TODO: For now we use simple bitmap drawing. It must be done
-                //       in a better way.
+            m_LayerPrerenderCache.Store(
+                Candidate, CandidateSize, ScaleLayer.PixelPerInch,
+                m_PrerenderRenderer.RenderToBitmap(CandidateSize, Candidate));
 
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapLeftH,
-                    wxPoint(SurfaceRect.GetX(), SurfaceRect.GetY()));
+#ifdef _DEBUG
+            wxLogInfo(
+                wxString::Format(
+                    "Ruler's layer was pre-rendered (position %d, units %d, "
+                    "%zu of %zu bytes used).",
+                    static_cast<int>(Candidate.eRulerPosition),
+                    static_cast<int>(Candidate.eRulerUnits),
+                    m_LayerPrerenderCache.GetMemoryUsage(),
+                    m_LayerPrerenderCache.GetMemoryBudget()));
+#endif
 
-                for (int i = 0; i <= (SurfaceRect.GetWidth() - 8) / 2; i++)
-                {
-                    dc.DrawBitmap(
-                        RulerBackgroundBitmapMiddleH,
-                        wxPoint(
-                            SurfaceRect.GetX() + 4 + (2 * i),
-                            SurfaceRect.GetY()));
-                }
+            return true;
+        };
 
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapRightH,
-                    wxPoint(SurfaceRect.GetRight() - 3, SurfaceRect.GetTop()));
+        // Other positions with the current units and other units at the
+        // current position are the likely next layers. Only one layer is
+        // rendered per idle event, so input is not delayed.
+        SRulerRenderConfig Candidate(Config);
+        for (int I = ERulerPosition::rpLeft; I <= ERulerPosition::rpBottom; I++)
+        {
+            Candidate.eRulerPosition = static_cast<ERulerPosition>(I);
+            if ((Candidate.eRulerPosition != Config.eRulerPosition) &&
+                Prerender(Candidate))
+            {
+                Event.RequestMore();
 
-                break;
+                return;
             }
+        }
 
-            break;
-        // Ruler's position on right side.
-        case ERulerPosition::rpRight:
-            switch (eRulerBackgroundType)
+        Candidate.eRulerPosition = Config.eRulerPosition;
+        for (int I = 0; I < ERulerUnits::ruCount; I++)
+        {
+            Candidate.eRulerUnits = static_cast<ERulerUnits>(I);
+            if ((Candidate.eRulerUnits != Config.eRulerUnits) &&
+                Prerender(Candidate))
             {
-            // Ruler's background as solid.
-            case ERulerBackgroundType::btSolid:
-				// Prepare display context's brush.
-                dc.SetBrush(
-                    wxBrush(cRulerBackgroundColour, wxBRUSHSTYLE_SOLID));
-
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColor(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
-
-                // Draw rectangle on whole surface size.
-                dc.DrawRectangle(SurfaceRect);
-
-                break;
-            // Ruler's background as gradient.
-            case ERulerBackgroundType::btGradient:
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColour(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
-
-                // Draw gradient rectangle on whole surface size.
-                dc.GradientFillLinear(
-                    SurfaceRect,
-                    cRulerBackgroundStartColour, cRulerBackgroundEndColour,
-                    wxLEFT);
-
-                break;
-            // Ruler's background as image.
-            case ERulerBackgroundType::btImage:
-                // TODO: For now we use simple bitmap drawing. It must be done
-                //       in a better way.
-
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapTopV,
-                    wxPoint(SurfaceRect.GetX(), SurfaceRect.GetY()));
-
-                for (int i = 0; i <= (SurfaceRect.GetHeight() - 8) / 2; i++)
-                {
-                    dc.DrawBitmap(
-                        RulerBackgroundBitmapMiddleV,
-                        wxPoint(
-                            SurfaceRect.GetX(),
-                            SurfaceRect.GetY() + 4 + (2 * i)));
-                }
-
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapBottomV,
-                    wxPoint(SurfaceRect.GetX(), SurfaceRect.GetBottom() - 3));
+                Event.RequestMore();
 
-                break;
+                return;
             }
+        }
+    }
 
-            break;
-        // Ruler's position on bottom.
-        case ERulerPosition::rpBottom:
-            switch (eRulerBackgroundType)
-            {
-            // Ruler's background as solid.
-            case ERulerBackgroundType::btSolid:
-				// Prepare display context's brush.
-                dc.SetBrush(
-                    wxBrush(cRulerBackgroundColour, wxBRUSHSTYLE_SOLID));
+    void CDrawPanel::OnLayerRendered(wxThreadEvent& WXUNUSED(Event))
+    {
+        std::unique_ptr<SLayerRenderJob> pJob =
+            m_LayerRenderWorker.TakeResult();
+        if (!pJob)
+            return;
 
-				// Prepare display context's pen.
-                dc.SetPen(wxPen(wxColor(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
+        // Result of superseded job is dropped.
+        for (SScaleLayerCache& Cache : m_aScaleLayers)
+        {
+            if (!Cache.bSurfaceJobPending || (Cache.ulSurfaceJob != pJob->ulId))
+                continue;
 
-                // Draw rectangle on whole surface size.
-                dc.DrawRectangle(SurfaceRect);
+            Cache.Renderer.SetSurfaceLayer(
+                pJob->Surface, Cache.SurfaceJobRect, Cache.SurfaceJobConfig);
+            Cache.bSurfaceJobPending = false;
 
-                break;
-            // Ruler's background as gradient.
-            case ERulerBackgroundType::btGradient:
-				// Prepare display context's pen
-                dc.SetPen(wxPen(wxColour(0, 0, 0), 1, wxPENSTYLE_TRANSPARENT));
+            // Layer is rebuilt by the next paint with the new surface, so
+            // it replaces previous content at once.
+            Cache.bValid = false;
+            Refresh(false);
 
-                // Draw gradient rectangle on whole surface size.
-                dc.GradientFillLinear(
-                    SurfaceRect,
-                    cRulerBackgroundStartColour, cRulerBackgroundEndColour,
-                    wxUP);
+#ifdef _DEBUG
+            wxLogInfo(wxString("Ruler's surface job was finished."));
+#endif
+        }
+    }
 
-                break;
-            // Ruler's background as image.
-            case ERulerBackgroundType::btImage:
-                // TODO: For now we use simple bitmap drawing. It must be done
-                //       in a better way.
+    void CDrawPanel::OnLayerPrerendered(wxThreadEvent& WXUNUSED(Event))
+    {
+        std::unique_ptr<SLayerRenderJob> pJob = m_PrerenderWorker.TakeResult();
+        if (!pJob ||
+            !m_bPrerenderJobPending ||
+            (pJob->ulId != m_ulPrerenderJob))
+            return;
 
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapLeftH,
-                    wxPoint(SurfaceRect.GetX(), SurfaceRect.GetY()));
+        m_PrerenderRenderer.SetSurfaceLayer(
+            pJob->Surface, wxRect(m_PrerenderJobSize), m_PrerenderJobConfig);
+        m_bPrerenderJobPending = false;
+    }
 
-                for (int i = 0; i <= (SurfaceRect.GetWidth() - 8) / 2; i++)
-                {
-                    dc.DrawBitmap(
-                        RulerBackgroundBitmapMiddleH,
-                        wxPoint(
-                            SurfaceRect.GetX() + 4 + (2 * i),
-                            SurfaceRect.GetY()));
-                }
+    void CDrawPanel::UpdateScaleLayer(
+        const wxRect& SurfaceRect, const wxRect& Rect)
+    {
+        // Valid part of the layer is kept as one rectangle, so it grows to
+        // the bounding box of itself and exposed rectangle.
+        SScaleLayerCache& ScaleLayer = *m_pScaleLayer;
+        wxRect DirtyRect(Rect);
+        if (!ScaleLayer.ValidRect.IsEmpty())
+            DirtyRect.Union(ScaleLayer.ValidRect);
+        DirtyRect.Intersect(SurfaceRect);
+
+        if (DirtyRect.IsEmpty())
+            return;
 
-                dc.DrawBitmap(
-                    RulerBackgroundBitmapRightH,
-                    wxPoint(SurfaceRect.GetRight() - 3, SurfaceRect.GetTop()));
+        // Draw ruler's surface and scale clipped to dirty rectangle. Scale
+        // draws only ticks and labels inside of it, so cost is proportional
+        // to exposed area, not to ruler's length.
+        wxMemoryDC& MemoryDC = m_ScaleLayerDC;
+        MemoryDC.SetClippingRegion(DirtyRect);
 
-                break;
-            }
+        wxStopWatch StopWatch;
+        ScaleLayer.Renderer.DrawSurface(
+            MemoryDC, SurfaceRect, ScaleLayer.RenderConfig);
+        m_RenderStatistics.AddStageTime(
+            rsSurface, StopWatch.TimeInMicro().ToDouble());
 
-            break;
-        }
+        StopWatch.Start();
+        ScaleLayer.Renderer.DrawScale(
+            MemoryDC, SurfaceRect, ScaleLayer.RenderConfig);
+        m_RenderStatistics.AddStageTime(
+            rsScale, StopWatch.TimeInMicro().ToDouble());
 
-        // If m_eRulerBackgroundType is btImage, then return. Otherwise we will
-		// draw black outline around ruler.
-		if (eRulerBackgroundType == ERulerBackgroundType::btImage)
-			return;
+        MemoryDC.DestroyClippingRegion();
 
-        dc.SetPen(wxPen(wxColour(0, 0, 0), 1, wxPENSTYLE_SOLID));
-        dc.SetBrush(wxBrush(wxColour(0, 0, 0), wxBRUSHSTYLE_TRANSPARENT));
-        dc.DrawRectangle(
-            wxRect(0, 0, SurfaceRect.GetWidth(), SurfaceRect.GetHeight()));
+        ScaleLayer.ValidRect = DirtyRect;
     }
 
     void CDrawPanel::OnLeftDown(wxMouseEvent& Event)
     {
+        // Apply pending motion first, so it does not override this Event.
+        ApplyPendingInput();
+
+        // Ruler could be moved to another display since the last drag.
+        UpdateFrameInterval();
+
         // Retrieve Event position.
         wxPoint Pos = Event.GetPosition();
 
@@ -2044,6 +986,12 @@ namespace WinRuler
         // Retrieve also m_nOffsetBorder from pMainFrame.
         Offset = pMainFrame->m_iOffsetBorder;
 
+        // Remember current position of second marker.
+        int iOldSecondMarkerPosition = pMainFrame->m_iSecondMarkerPosition;
+
+        // Scale starts after inset of ruler's metrics.
+        SRulerMetrics Metrics = GetMetrics();
+
         // If mouse left button is down, then we can set second marker position
         // for measurement.
         if (Event.LeftDown())
@@ -2052,9 +1000,11 @@ namespace WinRuler
             {
             case rpLeft:
             case rpRight:
-                if ((Pos.y >= 4) && (Pos.y < pMainFrame->m_iRulerLength - 5))
+                if ((Pos.y >= Metrics.iInset) &&
+                    (Pos.y <= pMainFrame->m_iRulerLength - Metrics.iEndMargin))
                 {
-                    pMainFrame->m_iSecondMarkerPosition = Pos.y - 4;
+                    pMainFrame->m_iSecondMarkerPosition =
+                        Pos.y - Metrics.iInset;
 
 #ifdef _DEBUG
                     wxLogInfo(
@@ -2065,9 +1015,11 @@ namespace WinRuler
                 break;
             case rpTop:
             case rpBottom:
-                if ((Pos.x >= 4) && (Pos.x < pMainFrame->m_iRulerLength - 5))
+                if ((Pos.x >= Metrics.iInset) &&
+                    (Pos.x <= pMainFrame->m_iRulerLength - Metrics.iEndMargin))
                 {
-                    pMainFrame->m_iSecondMarkerPosition = Pos.x - 4;
+                    pMainFrame->m_iSecondMarkerPosition =
+                        Pos.x - Metrics.iInset;
 
 #ifdef _DEBUG
                     wxLogInfo(
@@ -2079,6 +1031,13 @@ namespace WinRuler
             }
         }
 
+        // If second marker was moved, repaint only its old and new bounds.
+        if (pMainFrame->m_iSecondMarkerPosition != iOldSecondMarkerPosition)
+        {
+            RefreshMarker(iOldSecondMarkerPosition);
+            RefreshMarker(pMainFrame->m_iSecondMarkerPosition);
+        }
+
         // If mouse left button is down and Event mouse position is inside
         // dragging space, then ...
         if (Event.LeftDown() &&
@@ -2110,6 +1069,9 @@ namespace WinRuler
         // If currently dragging, then ...
         if (m_bDragging)
         {
+            // ... apply the latest pointer position, ...
+            ApplyPendingInput();
+
             // .. finish dragging and ...
             m_bDragging = false;
 
@@ -2129,56 +1091,164 @@ namespace WinRuler
 
     void CDrawPanel::OnMouseMove(wxMouseEvent& Event)
     {
-        // Retrieve mouse position from event.
-        wxPoint Pos = Event.GetPosition();
+        // Count every motion event. If previous one was not applied yet, it
+        // is superseded by this one.
+        m_RenderStatistics.AddMotionEvent();
+        if (m_bInputPending)
+            m_RenderStatistics.AddCoalescedEvent();
+
+        // Keep only the latest pointer position. Screen position is taken
+        // now, because window can be moved before input is applied.
+        m_PendingPointerPos = Event.GetPosition();
+        m_PendingScreenPos = ClientToScreen(m_PendingPointerPos);
+        m_bInputPending = true;
+
+        // Apply input at most once per display refresh interval. If the
+        // interval already elapsed, apply it immediately, otherwise schedule
+        // it for the end of the interval.
+        long lElapsed = m_InputStopWatch.Time();
+        if (lElapsed >= m_lFrameInterval)
+            ApplyPendingInput();
+        else if (!m_InputTimer.IsRunning())
+            m_InputTimer.StartOnce(
+                static_cast<int>(m_lFrameInterval - lElapsed));
+
+        // If we are not dragging, skip this Event.
+        if (!m_bDragging)
+            Event.Skip();
+    }
+
+    void CDrawPanel::OnInputTimer(wxTimerEvent& WXUNUSED(Event))
+    {
+        ApplyPendingInput();
+    }
+
+    void CDrawPanel::ApplyPendingInput()
+    {
+        // Nothing to apply.
+        if (!m_bInputPending)
+            return;
+
+        m_bInputPending = false;
+        m_InputTimer.Stop();
+
+        // Open new refresh interval.
+        m_InputStopWatch.Start();
 
         // Retrieve pointer to CMainFrame.
         CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
 
+        // Remember current position of first marker.
+        int iOldFirstMarkerPosition = pMainFrame->m_iFirstMarkerPosition;
+
+        // Scale starts after inset of ruler's metrics.
+        SRulerMetrics Metrics = GetMetrics();
+
         // Update marker position depending on current ruler's position.
         switch (pMainFrame->m_eRulerPosition)
         {
         case rpLeft:
         case rpRight:
-            if ((Pos.y >= 4) && (Pos.y < pMainFrame->m_iRulerLength - 5))
+            if ((m_PendingPointerPos.y >= Metrics.iInset) &&
+                (m_PendingPointerPos.y <=
+                    pMainFrame->m_iRulerLength - Metrics.iEndMargin))
             {
-                pMainFrame->m_iFirstMarkerPosition = Pos.y - 4;
+                pMainFrame->m_iFirstMarkerPosition =
+                    m_PendingPointerPos.y - Metrics.iInset;
             }
 
             break;
         case rpTop:
         case rpBottom:
-            if ((Pos.x >= 4) && (Pos.x < pMainFrame->m_iRulerLength - 5))
+            if ((m_PendingPointerPos.x >= Metrics.iInset) &&
+                (m_PendingPointerPos.x <=
+                    pMainFrame->m_iRulerLength - Metrics.iEndMargin))
             {
-                pMainFrame->m_iFirstMarkerPosition = Pos.x - 4;
+                pMainFrame->m_iFirstMarkerPosition =
+                    m_PendingPointerPos.x - Metrics.iInset;
             }
 
             break;
         }
 
-        Refresh();
+        // If first marker was moved, repaint only its old and new bounds.
+        if (pMainFrame->m_iFirstMarkerPosition != iOldFirstMarkerPosition)
+        {
+            m_RenderStatistics.AddRepaintRequest();
+
+            RefreshMarker(iOldFirstMarkerPosition);
+            RefreshMarker(pMainFrame->m_iFirstMarkerPosition);
+        }
 
         // If currently dragging, then ...
         if (m_bDragging)
         {
-            // ... retrieve event position and cast it as ClientToScreen.
-            Pos = ClientToScreen(Pos);
-
-            // Calculate difference.
-            wxPoint diff = Pos - m_DragStartPos;
+            // ... calculate difference between the latest pointer position
+            // and the last applied one.
+            wxPoint diff = m_PendingScreenPos - m_DragStartPos;
 
             // Move parent frame which is our CMainFrame to new position which
             // is current position + our calculated diff.
-            pMainFrame->Move(pMainFrame->GetPosition() + diff);
+            if ((diff.x != 0) || (diff.y != 0))
+            {
+                pMainFrame->Move(pMainFrame->GetPosition() + diff);
+                m_RenderStatistics.AddWindowMove();
+            }
 
             // Update starting position.
-            m_DragStartPos = Pos;
+            m_DragStartPos = m_PendingScreenPos;
         }
-        else
+    }
+
+    bool CDrawPanel::UpdateDisplay()
+    {
+        // Ruler which is not on any display keeps its previous display.
+        int iDisplay = wxDisplay::GetFromWindow(this);
+        if ((iDisplay == wxNOT_FOUND) ||
+            (static_cast<unsigned int>(iDisplay) == m_uDisplayNo))
+            return false;
+
+        m_uDisplayNo = static_cast<unsigned int>(iDisplay);
+
+#ifdef _DEBUG
+        wxLogInfo(
+            wxString::Format(
+                "Ruler was moved to display %u (PPI %.2f x %.2f).",
+                m_uDisplayNo,
+                GetPixelPerInch(m_uDisplayNo).x,
+                GetPixelPerInch(m_uDisplayNo).y));
+#endif
+
+        // Layers are rebuilt on the next paint, because their PPI value
+        // differs from PPI value of the new display.
+        UpdateFrameInterval();
+
+        return true;
+    }
+
+    unsigned int CDrawPanel::GetDisplayNo() const
+    {
+        return m_uDisplayNo;
+    }
+
+    void CDrawPanel::UpdateFrameInterval()
+    {
+        int iRefreshFrequency = 0;
+
+        // Retrieve refresh frequency of display which shows the ruler.
+        int iDisplay = wxDisplay::GetFromWindow(this);
+        if (iDisplay != wxNOT_FOUND)
         {
-            // .. otherwise skip this Event.
-            Event.Skip();
+            iRefreshFrequency =
+                wxDisplay(static_cast<unsigned int>(iDisplay)).
+                    GetCurrentMode().GetRefreshFrequency();
         }
+
+        // If frequency is unknown, assume 60 Hz.
+        if (iRefreshFrequency <= 0)
+            iRefreshFrequency = 60;
+
+        m_lFrameInterval = std::max(1000L / iRefreshFrequency, 1L);
     }
 
     void CDrawPanel::OnMouseLeave(wxMouseEvent& Event)
@@ -6,10 +6,63 @@
 #pragma once
 
 #include <wx/wx.h>
+#include <wx/timer.h>
+#include <wx/stopwatch.h>
 #include "WRUtilities.h"
+#include "CRulerRenderer.h"
+#include "CRenderStatistics.h"
+#include "CFrameCompositor.h"
+#include "CLayerRenderWorker.h"
+#include "CLayerPrerenderCache.h"
 
 namespace WinRuler
 {
+    /**
+     * Cached layers of the ruler for one DPI scale factor. Each cache has
+     * its own renderer, so its scale layout, labels and surface stay valid
+     * while the ruler is shown on a display with another scale factor.
+     **/
+    struct SScaleLayerCache
+    {
+        //! DPI scale factor of the cache, 0.0 if cache was not used yet.
+        double dScaleFactor;
+
+        //! Renderer of ruler's surface, scale and markers.
+        CRulerRenderer Renderer;
+
+        //! Off-screen layer with ruler's surface and scale drawn on it.
+        wxBitmap Layer;
+
+        //! Ruler's appearance used for the last Layer rebuild. Only
+        //! markers' positions are updated on paint.
+        SRulerRenderConfig RenderConfig;
+
+        //! Validity flag of Layer.
+        bool bValid;
+
+        //! Part of Layer where surface and scale are already drawn.
+        wxRect ValidRect;
+
+        //! PPI value used for the last Layer rebuild.
+        wxRealPoint PixelPerInch;
+
+        //! Number of the paint which used the cache for the last time.
+        unsigned long ulLastUse;
+
+        //! Surface of the renderer is being composed by layer render
+        //! worker. Until it is ready, Layer shows previous content or
+        //! placeholder surface.
+        bool bSurfaceJobPending;
+
+        //! Identifier of the last submitted surface job.
+        unsigned long ulSurfaceJob;
+
+        //! Surface rectangle and ruler's appearance of the last submitted
+        //! surface job.
+        wxRect SurfaceJobRect;
+        SRulerRenderConfig SurfaceJobConfig;
+    };
+
     /**
      * CDrawPanel class definition.
      **/
@@ -17,6 +70,23 @@ namespace WinRuler
         public wxPanel
     {
         DECLARE_EVENT_TABLE()
+
+        //! Identifiers of panel's timers and layer render worker's events.
+        enum
+        {
+            ID_STATISTICS_TIMER = wxID_HIGHEST + 100,
+            ID_INPUT_TIMER,
+            ID_LAYER_RENDER_WORKER,
+            ID_LAYER_PRERENDER_WORKER
+        };
+
+        //! Number of lines of render statistics overlay.
+        static const int RenderStatisticsLines = 8;
+
+        //! Number of DPI scale factors whose layers are cached. Two are
+        //! enough for the ruler moved between a standard and a HiDPI
+        //! display.
+        static const size_t ScaleLayerCaches = 2;
     public:
         CDrawPanel(wxFrame* pParent);
 
@@ -48,9 +118,42 @@ namespace WinRuler
          * that it can work no matter what type of DC (e.g. wxPaintDC or
          * wxClientDC) is used.
          * 
-		 * \param dc        The device context to use for rendering.
+		 * \param dc            The device context to use for rendering.
+         * \param UpdateRegion  The region that needs to be repainted. All
+         *                      drawing is clipped to it.
+         **/
+        void Render(wxDC& dc, const wxRegion& UpdateRegion);
+
+        /**
+         * Invalidates all cached layers (ruler's surface and scale) of all
+         * DPI scale factors. Should be called whenever any setting that
+         * affects ruler's appearance was changed. Layers will be rebuilt
+         * during next paint.
+         **/
+        void InvalidateLayers();
+
+        /**
+         * Drops all pre-rendered layers. Should be called whenever setting
+         * which is not part of ruler's render configuration (e.g.
+         * user-defined unit of measurement) was changed.
          **/
-        void Render(wxDC& dc);
+        void ClearPrerenderedLayers();
+
+        /**
+         * Looks up display which shows the ruler. It should be called
+         * whenever the ruler was moved, all unit conversions use PPI value
+         * of the cached display.
+         *
+         * \return  Returns true if the ruler is on another display than
+         *          before, otherwise false.
+         **/
+        bool UpdateDisplay();
+
+        /**
+         * Returns number of display which shows the ruler, as cached by the
+         * last UpdateDisplay() call.
+         **/
+        unsigned int GetDisplayNo() const;
 
 		/**
 		 * This is the event handler for mouse events. It is called when the
@@ -59,112 +162,212 @@ namespace WinRuler
 		 * \param Event     The event that triggered the call.
          **/
         void OnMouseEvent(wxMouseEvent& Event);
-    public:
-		/**
-		 * This method draws the ruler markers on the specified device context
-         * takeing all specified parameters into account.
-         * 
-		 * \param dc                    The device context to use for
-         *                              rendering.
-		 * \param SurfaceRect           The rectangle that defines the area to
-         *                              draw in.
-		 * \param eRulerPosition        The position of the ruler (horizontal
-		 *                              or vertical).
-		 * \param eRulerUnits           The units of the ruler (pixels, mm,
-		 *                              inches, etc.).
-		 * \param cRulerScaleColour     The colour of the ruler scale.
-		 * \param cFirstMarkerColour    The colour of the first marker.
-		 * \param cSecondMarkerColour   The colour of the second marker.
-		 * \param iFirstMarkerPosition  The position of the first marker.
-		 * \param iSecondMarkerPosition The position of the second marker.
-         **/
-        void DrawRulerMarkers(
-            wxDC& dc, wxRect& SurfaceRect,
-            ERulerPosition eRulerPosition,
-            ERulerUnits eRulerUnits,
-            wxColour& cRulerScaleColour,
-            wxColour& cFirstMarkerColour,
-            wxColour& cSecondMarkerColour,
-            int iFirstMarkerPosition,
-            int iSecondMarkerPosition);
 
         /**
-		 * This method draws the ruler scale on the specified device context
-		 * takeing all specified parameters into account.
-         * 
-		 * \param dc                    The device context to use for
-         *                              rendering.
-		 * \param SurfaceRect           The rectangle that defines the area to
-		 *                              render in.
-		 * \param cRulerScaleColour     The colour of the ruler scale.
-		 * \param eRulerPosition        The position of the ruler (horizontal
-		 *                              or vertical).
-		 * \param eRulerUnits           The units of the ruler (pixels, mm,
-		 *                              inches, etc.).
-         **/
-        void DrawRulerScale(
-            wxDC& dc, wxRect& SurfaceRect,
-            wxColour& cRulerScaleColour,
-            ERulerPosition eRulerPosition,
-            ERulerUnits eRulerUnits);
-        
+         * Returns current ruler's appearance taken from main frame's
+         * settings.
+         *
+         * \return  Returns configuration for CRulerRenderer.
+         **/
+        SRulerRenderConfig GetRenderConfig() const;
+
         /**
-		 * This method draws the ruler surface on the specified device context
-		 * takeing all specified parameters into account.
-         * 
-		 * \param dc                        The device context to use for
-		 *                                  rendering.
-		 * \param SurfaceRect               The rectangle that defines the area
-         *                                  to render in.
-		 * \param eRulerPosition            The position of the ruler
-         *                                  (horizontal or vertical).
-		 * \param eRulerBackgroundType      The type of the ruler background
-		 *                                  (solid color, gradient or bitmap).
-		 * \param cRulerBackgroundColour    The colour of the ruler background.
-		 * \param cRulerBackgroundStartColour The start colour of the gradient
-         *                                    if gradient background type is
-         *                                    used, otherwise ignored.
-		 * \param cRulerBackgroundEndColour   The end colour of the gradient
-		 *                                    if gradient background type is
-		 *                                    used, otherwise ignored.
-		 * \param RulerBackgroundBitmapLeftH The bitmap to use for the
-		 *                                   horizontal left background if
-         *                                   bitmap background type is used,
-		 *                                   otherwise ignored.
-		 * \param RulerBackgroundBitmapMiddleH The bitmap to use for the
-		 *                                     horizontal middle background if
-		 *                                     bitmap background type is used,
-		 *                                     otherwise ignored.
-		 * \param RulerBackgroundBitmapRightH The bitmap to use for the
-		 *                                    horizontal right background if
-		 *                                    bitmap background type is used,
-		 *                                    otherwise ignored.
-		 * \param RulerBackgroundBitmapTopV The bitmap to use for the vertical
-		 *                                  top background if bitmap background
-		 *                                  type is used, otherwise ignored.
-		 * \param RulerBackgroundBitmapMiddleV The bitmap to use for the
-		 *                                     vertical middle background if
-		 *                                     bitmap background type is used,
-		 *                                     otherwise ignored.
-		 * \param RulerBackgroundBitmapBottomV The bitmap to use for the
-		 *                                     vertical bottom background type
-		 *                                     if bitmap background type is
-		 *                                     used, otherwise ignored.
-         **/
-        void DrawRulerSurface(
-            wxDC& dc, wxRect& SurfaceRect,
-            ERulerPosition eRulerPosition,
-            ERulerBackgroundType eRulerBackgroundType,
-            wxColour& cRulerBackgroundColour,
-            wxColour& cRulerBackgroundStartColour,
-            wxColour& cRulerBackgroundEndColour,
-            wxBitmap RulerBackgroundBitmapLeftH,
-            wxBitmap RulerBackgroundBitmapMiddleH,
-            wxBitmap RulerBackgroundBitmapRightH,
-            wxBitmap RulerBackgroundBitmapTopV,
-            wxBitmap RulerBackgroundBitmapMiddleV,
-            wxBitmap RulerBackgroundBitmapBottomV);
+         * Returns ruler's metrics scaled for display which shows the panel.
+         *
+         * \return  Returns ruler's metrics.
+         **/
+        SRulerMetrics GetMetrics() const;
+
+        /**
+         * Shows or hides overlay with render statistics (stage timings,
+         * paints, motion events and coalesced events per second).
+         *
+         * \param bShow     If true, overlay is shown.
+         **/
+        void ShowRenderStatistics(bool bShow);
+
+        /**
+         * Returns true if overlay with render statistics is shown.
+         **/
+        bool IsRenderStatisticsShown() const;
     private:
+        /**
+         * Selects cached layers of DPI scale factor of the display which
+         * shows the panel. If there are no such layers yet, the least
+         * recently used cache is taken over for them.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         **/
+        void SelectScaleLayer(const wxRect& SurfaceRect);
+
+        /**
+         * Measures the widest marker's label and the widest line of render
+         * statistics overlay with font of the current layers' renderer.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         **/
+        void MeasureLabelExtents(const wxRect& SurfaceRect);
+
+        /**
+         * Measures the widest formatted line of render statistics overlay.
+         * Overlay is never narrower than typical line of stage time, so it
+         * does not change its width with every value.
+         *
+         * \param dc    The device context used for measurement. Ruler's font
+         *              must be already set.
+         **/
+        void MeasureStatisticsLines(wxDC& dc);
+
+        /**
+         * Rebuilds static layer which holds ruler's surface and scale. This
+         * layer is reused by every paint until it is invalidated. Layer is
+         * only cleared, its content is drawn by UpdateScaleLayer().
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         **/
+        void RebuildScaleLayer(wxRect& SurfaceRect);
+
+        /**
+         * Submits composition of renderer's surface of the current layers to
+         * layer render worker, unless the same surface is already being
+         * composed.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void SubmitSurfaceJob(
+            const wxRect& SurfaceRect, const SRulerRenderConfig& Config);
+
+        /**
+         * Swaps layer pre-rendered for specified ruler into the current
+         * layers. Previous layer is kept in the pre-render cache if it is
+         * complete and differs only by position or unit of measurement.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         *
+         * \return  Returns true if pre-rendered layer was used, otherwise
+         *          false.
+         **/
+        bool SwapPrerenderedLayer(
+            const wxRect& SurfaceRect, const SRulerRenderConfig& Config);
+
+        /**
+         * Pre-renders during idle time one layer of other ruler's position
+         * or unit of measurement which is likely to be selected next. More
+         * idle events are requested until all of them are rendered or the
+         * memory budget is exhausted.
+         *
+         * \param Event     The event that triggered the call.
+         **/
+        void OnIdle(wxIdleEvent& Event);
+
+        /**
+         * Hands surface composed by layer render worker to renderer of its
+         * layers. Layers are rebuilt with it on the next paint, so the new
+         * ruler's appearance is swapped in at once.
+         *
+         * \param Event     The event that triggered the call.
+         **/
+        void OnLayerRendered(wxThreadEvent& Event);
+
+        /**
+         * Hands surface composed by pre-render worker to pre-render
+         * renderer, so the next idle event renders layer with it without
+         * composing it on the UI thread.
+         *
+         * \param Event     The event that triggered the call.
+         **/
+        void OnLayerPrerendered(wxThreadEvent& Event);
+
+        /**
+         * Draws ruler's surface and scale in the part of static layer which
+         * was exposed and is not valid yet.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Rect          The exposed rectangle.
+         **/
+        void UpdateScaleLayer(const wxRect& SurfaceRect, const wxRect& Rect);
+
+        /**
+         * Returns bounds of the marker (its line and its label) for the
+         * specified marker's position with panel's metrics and extent of
+         * marker's label, see CRulerRenderer::GetMarkerBounds().
+         *
+         * \param SurfaceRect       The rectangle that defines the area to
+         *                          render in.
+         * \param eRulerPosition    The position of the ruler.
+         * \param iMarkerPosition   The position of the marker.
+         *
+         * \return  Returns marker's bounds or empty rectangle if marker's
+         *          position is -1.
+         **/
+        wxRect GetMarkerBounds(
+            const wxRect& SurfaceRect,
+            ERulerPosition eRulerPosition,
+            int iMarkerPosition) const;
+
+        /**
+         * Returns bounds of the render statistics overlay. It is placed at
+         * the end of the ruler's scale.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param piRows        If not null, receives number of overlay's
+         *                      rows.
+         *
+         * \return  Returns overlay's bounds.
+         **/
+        wxRect GetRenderStatisticsBounds(
+            const wxRect& SurfaceRect, int* piRows = nullptr) const;
+
+        /**
+         * Formats lines of render statistics overlay from the last closed
+         * measurement window.
+         **/
+        void FormatRenderStatistics();
+
+        /**
+         * Closes measurement window of render statistics once per second
+         * and repaints their overlay.
+         *
+         * \param Event     The event that triggered the call.
+         **/
+        void OnStatisticsTimer(wxTimerEvent& Event);
+
+        /**
+         * Applies the latest pointer position received by OnMouseMove() (it
+         * moves the first marker and, while dragging, the ruler's window).
+         * All motion events received since the last call are coalesced into
+         * this one update.
+         **/
+        void ApplyPendingInput();
+
+        /**
+         * Applies pending input at the end of display refresh interval.
+         *
+         * \param Event     The event that triggered the call.
+         **/
+        void OnInputTimer(wxTimerEvent& Event);
+
+        /**
+         * Retrieves refresh interval of display which shows the ruler.
+         **/
+        void UpdateFrameInterval();
+
+        /**
+         * Invalidates only bounds of the marker at specified position.
+         *
+         * \param iMarkerPosition   The position of the marker.
+         **/
+        void RefreshMarker(int iMarkerPosition);
+
         /**
 		 * This is the event handler for the left mouse button down event.
          * 
@@ -206,5 +409,89 @@ namespace WinRuler
 
 		//! Initial position of the panel.
         wxPoint m_InitialPos;
+
+        //! Cached layers of the last used DPI scale factors.
+        SScaleLayerCache m_aScaleLayers[ScaleLayerCaches];
+
+        //! Cached layers of the current DPI scale factor.
+        SScaleLayerCache* m_pScaleLayer;
+
+        //! Memory device context with layer of m_pScaleLayer selected in it.
+        wxMemoryDC m_ScaleLayerDC;
+
+        //! Number of paints. It orders layer caches by their last use.
+        unsigned long m_ulPaintCounter;
+
+        //! Worker which composes expensive ruler's surfaces off the UI
+        //! thread.
+        CLayerRenderWorker m_LayerRenderWorker;
+
+        //! Identifier of the last submitted surface job.
+        unsigned long m_ulSurfaceJobCounter;
+
+        //! Layers of other ruler's positions and units of measurement.
+        CLayerPrerenderCache m_LayerPrerenderCache;
+
+        //! Renderer used for pre-rendering, so pre-rendering does not
+        //! invalidate scale layout and surface of the current layers.
+        CRulerRenderer m_PrerenderRenderer;
+
+        //! Worker which composes image-skinned surfaces of pre-rendered
+        //! layers off the UI thread.
+        CLayerRenderWorker m_PrerenderWorker;
+
+        //! Surface job of pre-render worker is being composed.
+        bool m_bPrerenderJobPending;
+
+        //! Identifier of the last submitted pre-render surface job.
+        unsigned long m_ulPrerenderJob;
+
+        //! Surface size and ruler's appearance of the last submitted
+        //! pre-render surface job.
+        wxSize m_PrerenderJobSize;
+        SRulerRenderConfig m_PrerenderJobConfig;
+
+        //! Compositor which composes every paint in its back buffer before
+        //! it is copied to the window.
+        CFrameCompositor m_FrameCompositor;
+
+        //! Extent of the widest marker's label for current ruler's length.
+        wxSize m_MarkerLabelExtent;
+
+        //! Rendering statistics (counters and stage timings).
+        CRenderStatistics m_RenderStatistics;
+
+        //! Visibility flag of render statistics overlay.
+        bool m_bShowRenderStatistics;
+
+        //! Timer which refreshes render statistics overlay.
+        wxTimer m_StatisticsTimer;
+
+        //! Extent of the widest line of render statistics overlay.
+        wxSize m_StatisticsLineExtent;
+
+        //! Lines of render statistics overlay. They are formatted once per
+        //! second, so paint only draws them.
+        wxString m_asRenderStatisticsLines[RenderStatisticsLines];
+
+        //! Pending input flag. It is set if motion event was received, but
+        //! not applied yet.
+        bool m_bInputPending;
+
+        //! The latest pointer position in client and screen coordinates.
+        wxPoint m_PendingPointerPos;
+        wxPoint m_PendingScreenPos;
+
+        //! Timer which applies pending input at the end of refresh interval.
+        wxTimer m_InputTimer;
+
+        //! Stop watch which measures time since input was applied.
+        wxStopWatch m_InputStopWatch;
+
+        //! Display's refresh interval in milliseconds.
+        long m_lFrameInterval;
+
+        //! Number of display which shows the ruler.
+        unsigned int m_uDisplayNo;
     };
 } // end namespace WinRuler
@@ -0,0 +1,137 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <algorithm>
+#include <wx/wx.h>
+#include <wx/stopwatch.h>
+#include "CFrameCompositor.h"
+
+namespace WinRuler
+{
+    CFrameCompositor::CFrameCompositor() :
+        m_dBackBufferScale(0.0)
+    {
+        // No code.
+    }
+
+    void CFrameCompositor::Compose(
+        wxDC& dc, const wxRegion& UpdateRegion,
+        const SFrameContent& Content, CRenderStatistics& Statistics)
+    {
+        // Compose paint in back buffer, so window never shows partially
+        // drawn frame. Clip all drawing to the update region.
+        wxRect UpdateBox = UpdateRegion.GetBox();
+        ReserveBackBuffer(Content.SurfaceRect.GetSize(), Content.dScaleFactor);
+        wxMemoryDC& BufferDC = m_BackBufferDC;
+        BufferDC.SetDeviceClippingRegion(UpdateRegion);
+
+        // Copy bounding box of update region from static layer. Clipping
+        // region limits the copy to updated rectangles, so they do not have
+        // to be iterated (wxRegionIterator allocates array of rectangles).
+        BufferDC.Blit(
+            UpdateBox.GetX(), UpdateBox.GetY(),
+            UpdateBox.GetWidth(), UpdateBox.GetHeight(),
+            Content.pScaleLayerDC, UpdateBox.GetX(), UpdateBox.GetY());
+
+        // Count paint and painted pixels. Pixels are counted for bounding
+        // box of update region, because iteration of its rectangles would
+        // allocate memory on every paint.
+        Statistics.AddPaint();
+        Statistics.AddPaintedPixels(
+            static_cast<unsigned long long>(UpdateBox.GetWidth()) *
+            static_cast<unsigned long long>(UpdateBox.GetHeight()));
+
+        // Draw ruler's markers only if any of them lies in update region.
+        // Those are the only elements drawn per frame.
+        if ((UpdateRegion.Contains(Content.FirstMarkerBounds) !=
+                wxOutRegion) ||
+            (UpdateRegion.Contains(Content.SecondMarkerBounds) !=
+                wxOutRegion))
+        {
+            wxStopWatch StopWatch;
+            Content.pRenderer->DrawMarkers(
+                BufferDC, Content.SurfaceRect, *Content.pRenderConfig);
+            Statistics.AddStageTime(
+                rsMarkers, StopWatch.TimeInMicro().ToDouble());
+        }
+
+        // Draw overlay over everything else.
+        if ((Content.pOverlay != nullptr) &&
+            (UpdateRegion.Contains(Content.pOverlay->Bounds) != wxOutRegion))
+            DrawOverlay(
+                BufferDC, *Content.pOverlay, Content.pRenderer->GetFont());
+
+        BufferDC.DestroyClippingRegion();
+
+        // Copy composed update region to the window.
+        dc.SetDeviceClippingRegion(UpdateRegion);
+        dc.Blit(
+            UpdateBox.GetX(), UpdateBox.GetY(),
+            UpdateBox.GetWidth(), UpdateBox.GetHeight(),
+            &BufferDC, UpdateBox.GetX(), UpdateBox.GetY());
+        dc.DestroyClippingRegion();
+    }
+
+    void CFrameCompositor::ReserveBackBuffer(
+        const wxSize& Size, double dScaleFactor)
+    {
+        // Current back buffer is large enough.
+        if (m_BackBuffer.IsOk() &&
+            (m_dBackBufferScale == dScaleFactor) &&
+            (Size.GetWidth() <= m_BackBufferCapacity.GetWidth()) &&
+            (Size.GetHeight() <= m_BackBufferCapacity.GetHeight()))
+            return;
+
+        // Grow capacity geometrically, so live resize reallocates buffer
+        // only a few times. After change of content scale factor capacity
+        // starts over from the current size.
+        wxSize Capacity(Size);
+        if (m_BackBuffer.IsOk() && (m_dBackBufferScale == dScaleFactor))
+        {
+            auto Grow = [](int iCapacity, int iRequired)
+            {
+                return (iRequired <= iCapacity) ?
+                    iCapacity : std::max(iRequired, iCapacity * 2);
+            };
+
+            Capacity = wxSize(
+                Grow(m_BackBufferCapacity.GetWidth(), Size.GetWidth()),
+                Grow(m_BackBufferCapacity.GetHeight(), Size.GetHeight()));
+        }
+
+        // Bitmap can not be recreated while it is selected in device
+        // context.
+        m_BackBufferDC.SelectObject(wxNullBitmap);
+        m_BackBuffer.CreateWithLogicalSize(Capacity, dScaleFactor);
+        m_BackBufferDC.SelectObject(m_BackBuffer);
+
+        m_BackBufferCapacity = Capacity;
+        m_dBackBufferScale = dScaleFactor;
+    }
+
+    void CFrameCompositor::DrawOverlay(
+        wxDC& dc, const SFrameOverlay& Overlay, const wxFont& Font)
+    {
+        // Draw overlay's box.
+        dc.SetPen(*wxBLACK_PEN);
+        dc.SetBrush(*wxWHITE_BRUSH);
+        dc.DrawRectangle(Overlay.Bounds);
+
+        dc.SetFont(Font);
+        dc.SetTextForeground(*wxBLACK);
+
+        // Draw lines column by column.
+        for (int I = 0; I < Overlay.iLines; I++)
+        {
+            dc.DrawText(
+                Overlay.pLines[I],
+                Overlay.Bounds.GetLeft() + 2 +
+                    ((I / Overlay.iRows) *
+                        (Overlay.LineExtent.GetWidth() + 2)),
+                Overlay.Bounds.GetTop() + 2 +
+                    ((I % Overlay.iRows) * Overlay.LineExtent.GetHeight()));
+        }
+    }
+} // end namespace WinRuler
@@ -0,0 +1,132 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "CRulerRenderer.h"
+#include "CRenderStatistics.h"
+
+namespace WinRuler
+{
+    /**
+     * Overlay drawn over composed frame, e.g. render statistics. Its lines
+     * are formatted by owner of the overlay, compositor only draws them.
+     **/
+    struct SFrameOverlay
+    {
+        //! Bounds of the overlay.
+        wxRect Bounds;
+
+        //! Lines of the overlay drawn column by column.
+        const wxString* pLines;
+
+        //! Number of lines of the overlay.
+        int iLines;
+
+        //! Number of lines in one column.
+        int iRows;
+
+        //! Extent of the widest line of the overlay.
+        wxSize LineExtent;
+    };
+
+    /**
+     * Content of one frame of the ruler: static layer and what is drawn
+     * over it.
+     **/
+    struct SFrameContent
+    {
+        //! The rectangle that defines the area to render in.
+        wxRect SurfaceRect;
+
+        //! Content scale factor of the window which shows the frame.
+        double dScaleFactor;
+
+        //! Memory device context with static layer (ruler's surface and
+        //! scale) selected in it.
+        wxMemoryDC* pScaleLayerDC;
+
+        //! Renderer which draws markers over static layer.
+        CRulerRenderer* pRenderer;
+
+        //! Ruler's appearance with current markers' positions.
+        const SRulerRenderConfig* pRenderConfig;
+
+        //! Bounds of the first and the second marker (their lines and
+        //! labels), empty for marker which is not set.
+        wxRect FirstMarkerBounds;
+        wxRect SecondMarkerBounds;
+
+        //! Overlay drawn over everything else, nullptr if there is none.
+        const SFrameOverlay* pOverlay;
+    };
+
+    /**
+     * CFrameCompositor class definition. It composes every paint of the
+     * ruler in its own back buffer (static layer is copied and markers and
+     * overlay are drawn over it only if they lie in update region) and
+     * copies composed update region to the window, so window never shows
+     * partially drawn frame. Back buffer is reused across paints, so
+     * steady-state paint does not allocate memory.
+     **/
+    class CFrameCompositor
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CFrameCompositor();
+
+        /**
+         * Composes update region of the frame in back buffer and copies it
+         * to specified device context. All drawing is clipped to update
+         * region. Paint, painted pixels and time of markers' drawing are
+         * counted in render statistics.
+         *
+         * \param dc            The device context to copy composed frame
+         *                      to.
+         * \param UpdateRegion  The region that needs to be repainted.
+         * \param Content       Content of the frame.
+         * \param Statistics    Render statistics to update.
+         **/
+        void Compose(
+            wxDC& dc, const wxRegion& UpdateRegion,
+            const SFrameContent& Content, CRenderStatistics& Statistics);
+    private:
+        /**
+         * Makes sure that back buffer covers specified size. Back buffer
+         * is reallocated only when ruler gets longer than its capacity or
+         * when content scale factor was changed.
+         *
+         * \param Size          Size of the ruler's surface.
+         * \param dScaleFactor  Content scale factor of the window.
+         **/
+        void ReserveBackBuffer(const wxSize& Size, double dScaleFactor);
+
+        /**
+         * Draws overlay.
+         *
+         * \param dc        The device context to use for rendering.
+         * \param Overlay   The overlay.
+         * \param Font      Font of overlay's lines.
+         **/
+        static void DrawOverlay(
+            wxDC& dc, const SFrameOverlay& Overlay, const wxFont& Font);
+    private:
+        //! Back buffer where every paint is composed before it is copied to
+        //! the window. It is reused across repaints and resizes.
+        wxBitmap m_BackBuffer;
+
+        //! Memory device context with m_BackBuffer selected in it.
+        wxMemoryDC m_BackBufferDC;
+
+        //! Size of m_BackBuffer (its capacity) in logical pixels.
+        wxSize m_BackBufferCapacity;
+
+        //! Content scale factor used for m_BackBuffer creation.
+        double m_dBackBufferScale;
+    };
+} // end namespace WinRuler
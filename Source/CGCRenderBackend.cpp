@@ -0,0 +1,91 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <wx/wx.h>
+#include <wx/graphics.h>
+#include "CGCRenderBackend.h"
+
+namespace WinRuler
+{
+    CGCRenderBackend::CGCRenderBackend() :
+        m_pContext(nullptr)
+    {
+        // No code.
+    }
+
+    CGCRenderBackend::~CGCRenderBackend()
+    {
+        End();
+    }
+
+    bool CGCRenderBackend::Begin(wxDC& dc)
+    {
+        End();
+
+        m_pContext = wxGraphicsContext::CreateFromUnknownDC(dc);
+        if (m_pContext == nullptr)
+            return false;
+
+        m_pContext->SetAntialiasMode(wxANTIALIAS_DEFAULT);
+
+        // Graphics context does not have to inherit clipping region of the
+        // device context, so clip it explicitly.
+        wxRect Box;
+        if (dc.GetClippingBox(Box))
+            m_pContext->Clip(
+                Box.GetX(), Box.GetY(), Box.GetWidth(), Box.GetHeight());
+
+        return true;
+    }
+
+    void CGCRenderBackend::End()
+    {
+        // Graphics context flushes all drawing when it is destroyed.
+        wxDELETE(m_pContext);
+    }
+
+    void CGCRenderBackend::SetPen(const wxPen& Pen)
+    {
+        // Butt cap, so line ends exactly at its end point like with wxDC.
+        wxPen ButtPen(Pen);
+        ButtPen.SetCap(wxCAP_BUTT);
+
+        m_pContext->SetPen(ButtPen);
+    }
+
+    void CGCRenderBackend::SetTextStyle(
+        const wxFont& Font, const wxColour& Colour)
+    {
+        m_pContext->SetFont(Font, Colour);
+    }
+
+    void CGCRenderBackend::DrawLine(const SRenderLine& Line)
+    {
+        DrawLines(&Line, 1);
+    }
+
+    void CGCRenderBackend::DrawLines(const SRenderLine* pLines, size_t uCount)
+    {
+        StrokeLines(*m_pContext, pLines, uCount, m_vBegins, m_vEnds);
+    }
+
+    void CGCRenderBackend::DrawText(const wxString& Text, const wxPoint& Point)
+    {
+        m_pContext->DrawText(Text, Point.x, Point.y);
+    }
+
+    void CGCRenderBackend::DrawBitmap(
+        const wxBitmap& Bitmap, const wxPoint& Point, bool WXUNUSED(bUseMask))
+    {
+        // Graphics context always uses bitmap's mask and alpha.
+        m_pContext->DrawBitmap(
+            Bitmap, Point.x, Point.y, Bitmap.GetWidth(), Bitmap.GetHeight());
+    }
+
+    const wxChar* CGCRenderBackend::GetName() const
+    {
+        return wxT("wxGraphicsContext");
+    }
+} // end namespace WinRuler
@@ -0,0 +1,60 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include <wx/graphics.h>
+#include "CRenderBackend.h"
+
+namespace WinRuler
+{
+    /**
+     * CGCRenderBackend class definition. Backend which draws through
+     * wxGraphicsContext (GDI+ or Direct2D on Windows, Cairo on Linux) with
+     * antialiasing. Lines are moved to pixel centres and submitted in one
+     * path, so the whole scale is stroked by a single call. Graphics context
+     * is created for every Begin(), which allocates memory, so this backend
+     * is not zero-allocation.
+     **/
+    class CGCRenderBackend :
+        public CRenderBackend
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CGCRenderBackend();
+
+        /**
+         * Destructor.
+         **/
+        ~CGCRenderBackend() override;
+
+        // Implementation of CRenderBackend interface, see its documentation.
+        bool Begin(wxDC& dc) override;
+        void End() override;
+        void SetPen(const wxPen& Pen) override;
+        void SetTextStyle(
+            const wxFont& Font, const wxColour& Colour) override;
+        void DrawLine(const SRenderLine& Line) override;
+        void DrawLines(const SRenderLine* pLines, size_t uCount) override;
+        void DrawText(const wxString& Text, const wxPoint& Point) override;
+        void DrawBitmap(
+            const wxBitmap& Bitmap, const wxPoint& Point,
+            bool bUseMask) override;
+        const wxChar* GetName() const override;
+    private:
+        //! Graphics context created by Begin().
+        wxGraphicsContext* m_pContext;
+
+        //! Scratch buffer with start points of submitted lines.
+        std::vector<wxPoint2DDouble> m_vBegins;
+
+        //! Scratch buffer with end points of submitted lines.
+        std::vector<wxPoint2DDouble> m_vEnds;
+    };
+} // end namespace WinRuler
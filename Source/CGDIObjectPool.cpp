@@ -0,0 +1,65 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <wx/wx.h>
+#include "CGDIObjectPool.h"
+
+namespace WinRuler
+{
+    CGDIObjectPool::CGDIObjectPool()
+    {
+        // Reserve space for all objects, so adding them does not move
+        // already pooled ones.
+        m_vPens.reserve(MaxObjects);
+        m_vBrushes.reserve(MaxObjects);
+    }
+
+    const wxPen& CGDIObjectPool::GetPen(
+        const wxColour& Colour, int iWidth, wxPenStyle eStyle)
+    {
+        // Pool is small, so linear search is the fastest way.
+        for (const SPooledPen& Pooled : m_vPens)
+        {
+            if ((Pooled.iWidth == iWidth) &&
+                (Pooled.eStyle == eStyle) &&
+                (Pooled.Colour == Colour))
+                return Pooled.Pen;
+        }
+
+        // Start over if pool is full.
+        if (m_vPens.size() == MaxObjects)
+            m_vPens.clear();
+
+        m_vPens.push_back(
+            { Colour, iWidth, eStyle, wxPen(Colour, iWidth, eStyle) });
+
+        return m_vPens.back().Pen;
+    }
+
+    const wxBrush& CGDIObjectPool::GetBrush(
+        const wxColour& Colour, wxBrushStyle eStyle)
+    {
+        // Pool is small, so linear search is the fastest way.
+        for (const SPooledBrush& Pooled : m_vBrushes)
+        {
+            if ((Pooled.eStyle == eStyle) && (Pooled.Colour == Colour))
+                return Pooled.Brush;
+        }
+
+        // Start over if pool is full.
+        if (m_vBrushes.size() == MaxObjects)
+            m_vBrushes.clear();
+
+        m_vBrushes.push_back({ Colour, eStyle, wxBrush(Colour, eStyle) });
+
+        return m_vBrushes.back().Brush;
+    }
+
+    void CGDIObjectPool::Clear()
+    {
+        m_vPens.clear();
+        m_vBrushes.clear();
+    }
+} // end namespace WinRuler
@@ -0,0 +1,106 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+
+namespace WinRuler
+{
+    /**
+     * Pooled pen together with its key.
+     **/
+    struct SPooledPen
+    {
+        //! Colour of the pen.
+        wxColour Colour;
+
+        //! Width of the pen.
+        int iWidth;
+
+        //! Style of the pen.
+        wxPenStyle eStyle;
+
+        //! The pen.
+        wxPen Pen;
+    };
+
+    /**
+     * Pooled brush together with its key.
+     **/
+    struct SPooledBrush
+    {
+        //! Colour of the brush.
+        wxColour Colour;
+
+        //! Style of the brush.
+        wxBrushStyle eStyle;
+
+        //! The brush.
+        wxBrush Brush;
+    };
+
+    /**
+     * CGDIObjectPool class definition. It keeps pens and brushes used for
+     * ruler's rendering, so drawing with the same colours does not create
+     * new GDI objects. Lookup does not allocate memory, only creation of
+     * a not yet pooled object does.
+     **/
+    class CGDIObjectPool
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CGDIObjectPool();
+
+        /**
+         * Returns pooled pen with specified attributes. If there is no such
+         * pen in the pool yet, it is created.
+         *
+         * \param Colour    The colour of the pen.
+         * \param iWidth    The width of the pen.
+         * \param eStyle    The style of the pen.
+         *
+         * \return  Returns reference to pooled pen. It stays valid until
+         *          pool is cleared or new pen is added to the pool.
+         **/
+        const wxPen& GetPen(
+            const wxColour& Colour,
+            int iWidth = 1,
+            wxPenStyle eStyle = wxPENSTYLE_SOLID);
+
+        /**
+         * Returns pooled brush with specified attributes. If there is no
+         * such brush in the pool yet, it is created.
+         *
+         * \param Colour    The colour of the brush.
+         * \param eStyle    The style of the brush.
+         *
+         * \return  Returns reference to pooled brush. It stays valid until
+         *          pool is cleared or new brush is added to the pool.
+         **/
+        const wxBrush& GetBrush(
+            const wxColour& Colour,
+            wxBrushStyle eStyle = wxBRUSHSTYLE_SOLID);
+
+        /**
+         * Releases all pooled objects.
+         **/
+        void Clear();
+    private:
+        //! Maximal number of pooled pens and brushes. When it is reached,
+        //! pool is cleared, so colours which are not used anymore do not
+        //! stay in the pool forever.
+        static const size_t MaxObjects = 16;
+
+        //! Pooled pens.
+        std::vector<SPooledPen> m_vPens;
+
+        //! Pooled brushes.
+        std::vector<SPooledBrush> m_vBrushes;
+    };
+} // end namespace WinRuler
@@ -0,0 +1,187 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cmath>
+#include <wx/wx.h>
+#include "CLayerPrerenderCache.h"
+
+namespace WinRuler
+{
+    CLayerPrerenderCache::CLayerPrerenderCache() :
+        m_uMemoryBudget(0),
+        m_uMemoryUsage(0),
+        m_ulUseCounter(0)
+    {
+        // No code.
+    }
+
+    void CLayerPrerenderCache::SetMemoryBudget(size_t uBytes)
+    {
+        m_uMemoryBudget = uBytes;
+
+        Evict(0);
+    }
+
+    size_t CLayerPrerenderCache::GetMemoryBudget() const
+    {
+        return m_uMemoryBudget;
+    }
+
+    size_t CLayerPrerenderCache::GetMemoryUsage() const
+    {
+        return m_uMemoryUsage;
+    }
+
+    bool CLayerPrerenderCache::CanFit(
+        const wxSize& Size, double dContentScale) const
+    {
+        return
+            m_uMemoryUsage + GetLayerMemory(Size, dContentScale) <=
+                m_uMemoryBudget;
+    }
+
+    bool CLayerPrerenderCache::Contains(
+        const SRulerRenderConfig& Config, const wxSize& Size,
+        const wxRealPoint& PixelPerInch) const
+    {
+        return Find(Config, Size, PixelPerInch) < m_vLayers.size();
+    }
+
+    bool CLayerPrerenderCache::Take(
+        const SRulerRenderConfig& Config, const wxSize& Size,
+        const wxRealPoint& PixelPerInch, wxBitmap& Layer)
+    {
+        size_t Index = Find(Config, Size, PixelPerInch);
+        if (Index >= m_vLayers.size())
+            return false;
+
+        Layer = m_vLayers[Index].Layer;
+        Remove(Index);
+
+        return true;
+    }
+
+    void CLayerPrerenderCache::Store(
+        const SRulerRenderConfig& Config, const wxSize& Size,
+        const wxRealPoint& PixelPerInch, const wxBitmap& Layer)
+    {
+        if (!Layer.IsOk())
+            return;
+
+        // Replace older layer of the same ruler.
+        size_t Index = Find(Config, Size, PixelPerInch);
+        if (Index < m_vLayers.size())
+            Remove(Index);
+
+        size_t uBytes = GetLayerMemory(Size, Config.dContentScale);
+        if (uBytes > m_uMemoryBudget)
+            return;
+
+        Evict(uBytes);
+
+        SPrerenderedLayer Entry;
+        Entry.Config = Config;
+        Entry.Size = Size;
+        Entry.PixelPerInch = PixelPerInch;
+        Entry.Layer = Layer;
+        Entry.ulLastUse = ++m_ulUseCounter;
+        m_vLayers.push_back(Entry);
+
+        m_uMemoryUsage += uBytes;
+    }
+
+    void CLayerPrerenderCache::Prune(
+        const SRulerRenderConfig& Config, const wxSize& Size,
+        const wxRealPoint& PixelPerInch)
+    {
+        // Layers of other orientation have transposed size.
+        wxSize Transposed(Size.GetHeight(), Size.GetWidth());
+
+        for (size_t I = m_vLayers.size(); I-- > 0;)
+        {
+            const SPrerenderedLayer& Entry = m_vLayers[I];
+
+            if ((Entry.PixelPerInch != PixelPerInch) ||
+                ((Entry.Size != Size) && (Entry.Size != Transposed)) ||
+                !IsSameAppearance(Entry.Config, Config))
+                Remove(I);
+        }
+    }
+
+    void CLayerPrerenderCache::Clear()
+    {
+        m_vLayers.clear();
+        m_uMemoryUsage = 0;
+    }
+
+    bool CLayerPrerenderCache::IsSameAppearance(
+        const SRulerRenderConfig& First,
+        const SRulerRenderConfig& Second)
+    {
+        if ((First.cRulerScaleColour != Second.cRulerScaleColour) ||
+            (First.eRenderBackend != Second.eRenderBackend) ||
+            (First.Metrics != Second.Metrics))
+            return false;
+
+        // Surfaces are compared as if they had the same position.
+        SRulerRenderConfig Config(Second);
+        Config.eRulerPosition = First.eRulerPosition;
+
+        return CRulerRenderer::IsSameSurface(First, Config);
+    }
+
+    size_t CLayerPrerenderCache::GetLayerMemory(
+        const wxSize& Size, double dContentScale)
+    {
+        // Layers have physical resolution and 32 bits per pixel.
+        return
+            static_cast<size_t>(std::lround(Size.GetWidth() * dContentScale)) *
+            static_cast<size_t>(
+                std::lround(Size.GetHeight() * dContentScale)) *
+            4;
+    }
+
+    size_t CLayerPrerenderCache::Find(
+        const SRulerRenderConfig& Config, const wxSize& Size,
+        const wxRealPoint& PixelPerInch) const
+    {
+        for (size_t I = 0; I < m_vLayers.size(); I++)
+        {
+            const SPrerenderedLayer& Entry = m_vLayers[I];
+
+            if ((Entry.Config.eRulerPosition == Config.eRulerPosition) &&
+                (Entry.Config.eRulerUnits == Config.eRulerUnits) &&
+                (Entry.Size == Size) &&
+                (Entry.PixelPerInch == PixelPerInch) &&
+                IsSameAppearance(Entry.Config, Config))
+                return I;
+        }
+
+        return m_vLayers.size();
+    }
+
+    void CLayerPrerenderCache::Remove(size_t Index)
+    {
+        m_uMemoryUsage -= GetLayerMemory(
+            m_vLayers[Index].Size, m_vLayers[Index].Config.dContentScale);
+        m_vLayers.erase(m_vLayers.begin() + Index);
+    }
+
+    void CLayerPrerenderCache::Evict(size_t uBytes)
+    {
+        while (!m_vLayers.empty() &&
+            (m_uMemoryUsage + uBytes > m_uMemoryBudget))
+        {
+            size_t Oldest = 0;
+            for (size_t I = 1; I < m_vLayers.size(); I++)
+            {
+                if (m_vLayers[I].ulLastUse < m_vLayers[Oldest].ulLastUse)
+                    Oldest = I;
+            }
+
+            Remove(Oldest);
+        }
+    }
+} // end namespace WinRuler
@@ -0,0 +1,203 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "CRulerRenderer.h"
+
+namespace WinRuler
+{
+    /**
+     * Single pre-rendered layer (ruler's surface and scale without markers).
+     **/
+    struct SPrerenderedLayer
+    {
+        //! Ruler's appearance the layer was rendered with. Markers'
+        //! positions are not used.
+        SRulerRenderConfig Config;
+
+        //! Size of the ruler's surface.
+        wxSize Size;
+
+        //! PPI value the layer was rendered with.
+        wxRealPoint PixelPerInch;
+
+        //! Rendered layer.
+        wxBitmap Layer;
+
+        //! Number of the store which stored the layer.
+        unsigned long ulLastUse;
+    };
+
+    /**
+     * CLayerPrerenderCache class definition. It keeps complete layers of
+     * the ruler for other positions and units of measurement than the
+     * current ones, so switching to them only swaps bitmaps. Layers are
+     * rendered ahead of time during idle time and the layer which was
+     * replaced is kept too, so switching back is free as well. Total size
+     * of layers is limited by memory budget, the least recently used layers
+     * are dropped first.
+     **/
+    class CLayerPrerenderCache
+    {
+    public:
+        /**
+         * Default constructor. Cache has no memory budget, so it is
+         * disabled until SetMemoryBudget() is called.
+         **/
+        CLayerPrerenderCache();
+
+        /**
+         * Sets memory budget of the cache. Layers over the new budget are
+         * dropped.
+         *
+         * \param uBytes    Memory budget in bytes, 0 disables the cache.
+         **/
+        void SetMemoryBudget(size_t uBytes);
+
+        /**
+         * Returns memory budget of the cache in bytes.
+         **/
+        size_t GetMemoryBudget() const;
+
+        /**
+         * Returns memory used by cached layers in bytes.
+         **/
+        size_t GetMemoryUsage() const;
+
+        /**
+         * Checks if layer of specified size would fit the budget without
+         * dropping any cached layer.
+         *
+         * \param Size          Size of the ruler's surface.
+         * \param dContentScale Content scale factor of the layer.
+         *
+         * \return  Returns true if layer fits, otherwise false.
+         **/
+        bool CanFit(const wxSize& Size, double dContentScale) const;
+
+        /**
+         * Checks if cache holds layer for specified ruler.
+         *
+         * \param Config        The ruler's appearance.
+         * \param Size          Size of the ruler's surface.
+         * \param PixelPerInch  PPI value of the ruler.
+         *
+         * \return  Returns true if layer is cached, otherwise false.
+         **/
+        bool Contains(
+            const SRulerRenderConfig& Config, const wxSize& Size,
+            const wxRealPoint& PixelPerInch) const;
+
+        /**
+         * Takes layer for specified ruler out of the cache.
+         *
+         * \param Config        The ruler's appearance.
+         * \param Size          Size of the ruler's surface.
+         * \param PixelPerInch  PPI value of the ruler.
+         * \param Layer         Receives the layer.
+         *
+         * \return  Returns true if layer was found, otherwise false.
+         **/
+        bool Take(
+            const SRulerRenderConfig& Config, const wxSize& Size,
+            const wxRealPoint& PixelPerInch, wxBitmap& Layer);
+
+        /**
+         * Stores layer. The least recently used layers are dropped to make
+         * room for it. Layer larger than the whole budget is not stored.
+         *
+         * \param Config        The ruler's appearance.
+         * \param Size          Size of the ruler's surface.
+         * \param PixelPerInch  PPI value of the ruler.
+         * \param Layer         The layer. It must not be shared with any
+         *                      bitmap which is drawn on later.
+         **/
+        void Store(
+            const SRulerRenderConfig& Config, const wxSize& Size,
+            const wxRealPoint& PixelPerInch, const wxBitmap& Layer);
+
+        /**
+         * Drops layers which can not be used by the ruler anymore: layers of
+         * other appearance, PPI value or length of the ruler.
+         *
+         * \param Config        The current ruler's appearance.
+         * \param Size          Size of the current ruler's surface.
+         * \param PixelPerInch  The current PPI value.
+         **/
+        void Prune(
+            const SRulerRenderConfig& Config, const wxSize& Size,
+            const wxRealPoint& PixelPerInch);
+
+        /**
+         * Drops all layers.
+         **/
+        void Clear();
+
+        /**
+         * Checks if two configurations produce layers which differ only by
+         * ruler's position and unit of measurement.
+         *
+         * \param First     The first ruler's appearance.
+         * \param Second    The second ruler's appearance.
+         *
+         * \return  Returns true if appearances are the same, otherwise
+         *          false.
+         **/
+        static bool IsSameAppearance(
+            const SRulerRenderConfig& First,
+            const SRulerRenderConfig& Second);
+
+        /**
+         * Returns memory occupied by layer of specified size.
+         *
+         * \param Size          Size of the ruler's surface.
+         * \param dContentScale Content scale factor of the layer.
+         *
+         * \return  Returns size in bytes.
+         **/
+        static size_t GetLayerMemory(const wxSize& Size, double dContentScale);
+    private:
+        /**
+         * Finds layer for specified ruler.
+         *
+         * \return  Returns index of the layer or number of layers if it was
+         *          not found.
+         **/
+        size_t Find(
+            const SRulerRenderConfig& Config, const wxSize& Size,
+            const wxRealPoint& PixelPerInch) const;
+
+        /**
+         * Drops layer at specified index.
+         *
+         * \param Index     Index of the layer.
+         **/
+        void Remove(size_t Index);
+
+        /**
+         * Drops the least recently used layers until specified number of
+         * bytes fits the budget.
+         *
+         * \param uBytes    Number of bytes that have to fit.
+         **/
+        void Evict(size_t uBytes);
+    private:
+        //! Cached layers.
+        std::vector<SPrerenderedLayer> m_vLayers;
+
+        //! Memory budget in bytes.
+        size_t m_uMemoryBudget;
+
+        //! Memory used by cached layers in bytes.
+        size_t m_uMemoryUsage;
+
+        //! Number of stores. It orders layers by their last use.
+        unsigned long m_ulUseCounter;
+    };
+} // end namespace WinRuler
@@ -0,0 +1,136 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <wx/wx.h>
+#include "CLayerRenderWorker.h"
+
+namespace WinRuler
+{
+    CLayerRenderWorker::CThread::CThread(CLayerRenderWorker* pOwner) :
+        wxThread(wxTHREAD_JOINABLE),
+        m_pOwner(pOwner)
+    {
+        // No code.
+    }
+
+    wxThread::ExitCode CLayerRenderWorker::CThread::Entry()
+    {
+        m_pOwner->Run();
+
+        return nullptr;
+    }
+
+    CLayerRenderWorker::CLayerRenderWorker(
+        wxEvtHandler* pHandler, int iEventId) :
+        m_pHandler(pHandler),
+        m_iEventId(iEventId),
+        m_pKernels(&GetPixelKernels()),
+        m_Condition(m_Mutex),
+        m_bStop(false)
+    {
+        // No code.
+    }
+
+    CLayerRenderWorker::~CLayerRenderWorker()
+    {
+        if (!m_pThread)
+            return;
+
+        {
+            wxMutexLocker Lock(m_Mutex);
+            m_bStop = true;
+            m_Condition.Broadcast();
+        }
+
+        m_pThread->Wait();
+    }
+
+    void CLayerRenderWorker::Submit(std::unique_ptr<SLayerRenderJob> pJob)
+    {
+        if (!StartThread())
+        {
+            Compose(std::move(pJob));
+
+            return;
+        }
+
+        wxMutexLocker Lock(m_Mutex);
+
+        // Job which was not started yet is not needed anymore.
+        m_pPendingJob = std::move(pJob);
+        m_Condition.Signal();
+    }
+
+    std::unique_ptr<SLayerRenderJob> CLayerRenderWorker::TakeResult()
+    {
+        wxMutexLocker Lock(m_Mutex);
+
+        return std::move(m_pResult);
+    }
+
+    bool CLayerRenderWorker::StartThread()
+    {
+        if (m_pThread)
+            return true;
+
+        if (!m_Condition.IsOk())
+            return false;
+
+        std::unique_ptr<CThread> pThread(new CThread(this));
+        if (pThread->Run() != wxTHREAD_NO_ERROR)
+        {
+#ifdef _DEBUG
+            wxLogInfo(
+                wxT("Layer render worker could not be started, layers are ")
+                wxT("composed on the UI thread."));
+#endif
+            return false;
+        }
+
+        m_pThread = std::move(pThread);
+
+        return true;
+    }
+
+    void CLayerRenderWorker::Run()
+    {
+        for (;;)
+        {
+            std::unique_ptr<SLayerRenderJob> pJob;
+
+            {
+                wxMutexLocker Lock(m_Mutex);
+                while (!m_bStop && !m_pPendingJob)
+                    m_Condition.Wait();
+
+                if (m_bStop)
+                    return;
+
+                pJob = std::move(m_pPendingJob);
+            }
+
+            Compose(std::move(pJob));
+        }
+    }
+
+    void CLayerRenderWorker::Compose(std::unique_ptr<SLayerRenderJob> pJob)
+    {
+        // Composition touches only the job, so it runs without the lock.
+        CRasterRenderBackend::ComposeSurface(
+            pJob->Surface, pJob->Desc, *m_pKernels);
+
+        {
+            wxMutexLocker Lock(m_Mutex);
+
+            // Newer job makes this one obsolete.
+            if (m_bStop || m_pPendingJob)
+                return;
+
+            m_pResult = std::move(pJob);
+        }
+
+        wxQueueEvent(m_pHandler, new wxThreadEvent(wxEVT_THREAD, m_iEventId));
+    }
+} // end namespace WinRuler
@@ -0,0 +1,148 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <memory>
+#include <wx/wx.h>
+#include <wx/thread.h>
+#include "CPixelBuffer.h"
+#include "CRasterRenderBackend.h"
+#include "WRPixelKernels.h"
+
+namespace WinRuler
+{
+    /**
+     * Single composition of the ruler's surface done by CLayerRenderWorker.
+     * Job is owned by one thread at a time, so its images and buffer are
+     * never shared between threads.
+     **/
+    struct SLayerRenderJob
+    {
+        //! Identifier of the job assigned by its submitter.
+        unsigned long ulId;
+
+        //! Description of the composed surface.
+        SRasterSurfaceDesc Desc;
+
+        //! Buffer the surface is composed in. It must already have size of
+        //! the surface.
+        CPixelBuffer Surface;
+    };
+
+    /**
+     * CLayerRenderWorker class definition. It composes ruler's surface on
+     * worker thread, so expensive rebuilds (long image-skinned rulers) do
+     * not block the UI thread. Only the latest submitted job matters: job
+     * which was not started yet is replaced by a newer one and result of
+     * job finished after a newer submission is dropped. When result is
+     * ready, wxThreadEvent with specified identifier is queued to the
+     * handler, which takes it with TakeResult(). Worker thread is started
+     * by the first submission and joined by destructor.
+     **/
+    class CLayerRenderWorker
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * \param pHandler  The handler notified about finished jobs.
+         * \param iEventId  Identifier of the wxEVT_THREAD event queued to
+         *                  the handler.
+         **/
+        CLayerRenderWorker(wxEvtHandler* pHandler, int iEventId);
+
+        /**
+         * Destructor. It stops and joins worker thread.
+         **/
+        ~CLayerRenderWorker();
+
+        /**
+         * Submits new job. Pending job which was not started yet is
+         * dropped. If worker thread can not be started, job is composed
+         * immediately on the calling thread and event is queued the same
+         * way.
+         *
+         * \param pJob  The job to compose.
+         **/
+        void Submit(std::unique_ptr<SLayerRenderJob> pJob);
+
+        /**
+         * Takes result of the last finished job.
+         *
+         * \return  Returns finished job or nullptr if there is none.
+         **/
+        std::unique_ptr<SLayerRenderJob> TakeResult();
+    private:
+        /**
+         * Joinable thread which runs worker loop of its owner.
+         **/
+        class CThread :
+            public wxThread
+        {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param pOwner    The worker whose loop is run.
+             **/
+            CThread(CLayerRenderWorker* pOwner);
+        protected:
+            ExitCode Entry() override;
+        private:
+            //! The worker whose loop is run.
+            CLayerRenderWorker* m_pOwner;
+        };
+
+        /**
+         * Starts worker thread if it does not run yet.
+         *
+         * \return  Returns true if worker thread runs, otherwise false.
+         **/
+        bool StartThread();
+
+        /**
+         * Worker loop. It waits for jobs and composes them until worker is
+         * stopped.
+         **/
+        void Run();
+
+        /**
+         * Composes the job and stores it as result unless a newer job was
+         * submitted in the meantime. Handler is notified about stored
+         * result.
+         *
+         * \param pJob  The job to compose.
+         **/
+        void Compose(std::unique_ptr<SLayerRenderJob> pJob);
+    private:
+        //! The handler notified about finished jobs.
+        wxEvtHandler* m_pHandler;
+
+        //! Identifier of the event queued to the handler.
+        int m_iEventId;
+
+        //! Pixel kernels used for composition.
+        const SPixelKernels* m_pKernels;
+
+        //! Mutex which guards all following members.
+        wxMutex m_Mutex;
+
+        //! Condition signalled when job is submitted or worker is stopped.
+        wxCondition m_Condition;
+
+        //! Job waiting for worker thread.
+        std::unique_ptr<SLayerRenderJob> m_pPendingJob;
+
+        //! The last finished job.
+        std::unique_ptr<SLayerRenderJob> m_pResult;
+
+        //! Worker thread, nullptr if it was not started yet.
+        std::unique_ptr<CThread> m_pThread;
+
+        //! Worker thread has to finish.
+        bool m_bStop;
+    };
+} // end namespace WinRuler
@@ -6,6 +6,9 @@
 #include <wx/wx.h>
 #include <wx/display.h>
 #include "CMainFrame.h"
+#include "CRenderBenchmark.h"
+#include "WRRulerMetrics.h"
+#include "WRRulerUnits.h"
 
 namespace WinRuler
 {
@@ -25,6 +28,50 @@ namespace WinRuler
 		}
 	}
 
+	/**
+	 * Returns key of per-display setting. Key of display 0 has no suffix,
+	 * so it is compatible with settings of older versions, keys of other
+	 * displays have suffix "_N".
+	 **/
+	static wxString GetDisplaySettingKey(
+		const wxString& Name, unsigned int DisplayNo)
+	{
+		if (DisplayNo == 0)
+			return Name;
+
+		return wxString::Format("%s_%u", Name, DisplayNo);
+	}
+
+	/**
+	 * Parses key of per-display setting created by GetDisplaySettingKey().
+	 * Returns true and number of display if key belongs to setting Name.
+	 **/
+	static bool ParseDisplaySettingKey(
+		const wxString& Key, const wxString& Name, unsigned int& DisplayNo)
+	{
+		wxString Suffix;
+		unsigned long ulDisplayNo;
+
+		if (!Key.StartsWith(Name, &Suffix))
+			return false;
+
+		if (Suffix.IsEmpty())
+		{
+			DisplayNo = 0;
+
+			return true;
+		}
+
+		if (Suffix.StartsWith("_", &Suffix) && Suffix.ToULong(&ulDisplayNo))
+		{
+			DisplayNo = static_cast<unsigned int>(ulDisplayNo);
+
+			return true;
+		}
+
+		return false;
+	}
+
 	BEGIN_EVENT_TABLE(CMainFrame, wxFrame)
 
 	// Mouse events handler.
@@ -33,10 +80,9 @@ namespace WinRuler
 	// Catch menu events.
 	EVT_MENU(ID_OPTIONS, CMainFrame::OnOptionsClicked)
 	EVT_MENU(ID_NEW_RULER_LENGTH, CMainFrame::OnNewRulerLengthClicked)
-	EVT_MENU(ID_PIXELS_AS_UNIT, CMainFrame::OnPixelsAsUnitClicked)
-	EVT_MENU(ID_CENTIMETRES_AS_UNIT, CMainFrame::OnCentimetresAsUnitClicked)
-	EVT_MENU(ID_INCHES_AS_UNIT, CMainFrame::OnInchesAsUnitClicked)
-	EVT_MENU(ID_PICAS_AS_UNIT, CMainFrame::OnPicasAsUnitClicked)
+	EVT_MENU_RANGE(
+		ID_UNIT_OF_MEASUREMENT, ID_UNIT_OF_MEASUREMENT_LAST,
+		CMainFrame::OnUnitOfMeasurementClicked)
 	EVT_MENU(ID_ALWAYS_ON_TOP, CMainFrame::OnAlwaysOnTopClicked)
 	EVT_MENU(ID_RULER_POSITION_SCALE_ON_LEFT, CMainFrame::OnScaleOnLeftClicked)
 	EVT_MENU(
@@ -46,6 +92,10 @@ namespace WinRuler
 		ID_RULER_POSITION_SCALE_ON_BOTTOM, CMainFrame::OnScaleOnBottomClicked)
 	EVT_MENU(wxID_ABOUT, CMainFrame::OnAboutClicked)
 	EVT_MENU(wxID_CLOSE, CMainFrame::OnCloseClicked)
+	EVT_MENU(ID_RENDER_STATISTICS, CMainFrame::OnRenderStatisticsClicked)
+#ifdef _DEBUG
+	EVT_MENU(ID_RENDER_BENCHMARK, CMainFrame::OnRenderBenchmarkClicked)
+#endif
 
 	END_EVENT_TABLE()
 
@@ -101,6 +151,9 @@ namespace WinRuler
 		// Bind OnMove event for window move event.
 		Bind(wxEVT_MOVE, &CMainFrame::OnMove, this);
 
+		// Bind OnDPIChanged event for DPI change event.
+		Bind(wxEVT_DPI_CHANGED, &CMainFrame::OnDPIChanged, this);
+
 		// Initialize Border Dragging.
 		BorderDragInit();
 	}
@@ -150,6 +203,9 @@ namespace WinRuler
 		// Ruler's unit of measurement.
 		m_eRulerUnits = ERulerUnits::ruCentimetres;
 
+		// User-defined unit of measurement (one unit per inch).
+		SetUserDefinedUnit(1.0, wxString("u"));
+
 		// Ruler's background type.
 		m_eRulerBackgroundType = ERulerBackgroundType::btGradient;
 
@@ -182,6 +238,12 @@ namespace WinRuler
 		// Ruler transparency value.
 		m_iRulerTransparencyValue = 255;
 
+		// Graphics backend used for ruler's rendering.
+		m_eRenderBackend = ERenderBackend::rbDC;
+
+		// Memory budget of pre-rendered layers in MB.
+		m_iLayerPrerenderBudget = 32;
+
 		// First marker position.
 		m_iFirstMarkerPosition = 0;
 
@@ -200,10 +262,9 @@ namespace WinRuler
 	void CMainFrame::CreateControls()
 	{
 		// Create new CDrawPanel and store it in m_pDrawPanel.
+		// CDrawPanel composes every paint in its own persistent back buffer,
+		// so it is not double buffered by the system.
 		m_pDrawPanel = new CDrawPanel(static_cast<wxFrame*>(this));
-
-		// Set double buffered flag for our CDrawPanel instance.
-		m_pDrawPanel->SetDoubleBuffered(true);
 	}
 
 	void CMainFrame::SetupSizers()
@@ -262,6 +323,10 @@ namespace WinRuler
 
 		wxDELETE(Bitmap);
 
+		// Ruler's background bitmaps were changed, so invalidate cached
+		// layers of m_pDrawPanel.
+		m_pDrawPanel->InvalidateLayers();
+
 		// All operation was successful, return true.
 		return true;
 	}
@@ -359,6 +424,40 @@ namespace WinRuler
 				SetTransparent(255);
 			}
 
+			// Set graphics backend used for ruler's rendering.
+			m_eRenderBackend =
+				static_cast<ERenderBackend>(
+					m_pOptionsDialog->m_pRenderBackendChoice->GetSelection());
+
+			// Set user-defined unit of measurement. Pre-rendered layers do
+			// not know about it, so they are dropped if it was changed.
+			// Units per inch out of supported range keep previous value.
+			double dUnitsPerInch;
+			wxString UnitSymbol =
+				m_pOptionsDialog->m_pUserDefinedUnitSymbolTextCtrl->GetValue();
+			if (!m_pOptionsDialog->m_pUserDefinedUnitsPerInchTextCtrl->
+					GetValue().ToCDouble(&dUnitsPerInch) ||
+				!IsValidUserDefinedUnitsPerInch(dUnitsPerInch))
+			{
+				wxLogError(
+					"Units per inch of user-defined unit must be a number "
+					"from %g to %g!",
+					UserDefinedUnitsPerInchMin, UserDefinedUnitsPerInchMax);
+
+				dUnitsPerInch = GetUserDefinedUnitsPerInch();
+			}
+
+			if ((dUnitsPerInch != GetUserDefinedUnitsPerInch()) ||
+				(UnitSymbol != GetUserDefinedUnitSymbol()))
+			{
+				SetUserDefinedUnit(dUnitsPerInch, UnitSymbol);
+				m_pDrawPanel->ClearPrerenderedLayers();
+			}
+
+			// Set memory budget of pre-rendered layers.
+			m_iLayerPrerenderBudget =
+				m_pOptionsDialog->m_pLayerPrerenderBudgetSpinCtrl->GetValue();
+
 #ifdef WR_WINDOWS // If platform is Windows.
 			// Set snap to edges of the screen distance and snap to other
 			// windows distance.
@@ -375,6 +474,10 @@ namespace WinRuler
 			// Save all settings of our application.
 			SaveApplicationSettings();
 
+			// Ruler's appearance could be changed, so invalidate cached
+			// layers of m_pDrawPanel.
+			m_pDrawPanel->InvalidateLayers();
+
 			// Refresh CMainFrame.
 			Refresh();
 		}
@@ -404,54 +507,20 @@ namespace WinRuler
 		wxDELETE(m_pNewRulerLengthDialog);
 	}
 
-	void CMainFrame::OnPixelsAsUnitClicked(wxCommandEvent& WXUNUSED(Event))
-	{
-#ifdef _DEBUG
-		wxLogInfo(wxString("Pixels as unit of measurement selected."));
-#endif
-
-		// Change ruler's unit of measurement to pixels.
-		ChangeRulerUnitOfMeasurement(ERulerUnits::ruPixels);
-
-		// Save all settings of our application.
-		SaveApplicationSettings();
-	}
-
-	void CMainFrame::OnCentimetresAsUnitClicked(
-		wxCommandEvent& WXUNUSED(Event))
+	void CMainFrame::OnUnitOfMeasurementClicked(wxCommandEvent& Event)
 	{
-#ifdef _DEBUG
-	    wxLogInfo(wxString("Centimetres as unit of measurement selected."));
-#endif
+		ERulerUnits NewUnit =
+			static_cast<ERulerUnits>(Event.GetId() - ID_UNIT_OF_MEASUREMENT);
 
-		// Change ruler's unit of measurement to centimetres.
-		ChangeRulerUnitOfMeasurement(ERulerUnits::ruCentimetres);
-
-		// Save all settings of our application.
-		SaveApplicationSettings();
-	}
-
-	void CMainFrame::OnInchesAsUnitClicked(wxCommandEvent& WXUNUSED(Event))
-	{
 #ifdef _DEBUG
-	    wxLogInfo(wxString("Inches as unit of measurement selected."));
+		wxLogInfo(
+			wxString::Format(
+				"%s as unit of measurement selected.",
+				wxStripMenuCodes(GetRulerUnitDesc(NewUnit).pszName)));
 #endif
 
-		// Change ruler's unit of measurement to inches.
-		ChangeRulerUnitOfMeasurement(ERulerUnits::ruInches);
-
-		// Save all settings of our application.
-		SaveApplicationSettings();
-	}
-
-	void CMainFrame::OnPicasAsUnitClicked(wxCommandEvent& WXUNUSED(Event))
-	{
-#ifdef _DEBUG
-	    wxLogInfo(wxString("Picas as unit of measurement selected."));
-#endif
-
-		// Change ruler's unit of measurement to picas.
-		ChangeRulerUnitOfMeasurement(ERulerUnits::ruPicas);
+		// Change ruler's unit of measurement to the selected one.
+		ChangeRulerUnitOfMeasurement(NewUnit);
 
 		// Save all settings of our application.
 		SaveApplicationSettings();
@@ -551,6 +620,37 @@ namespace WinRuler
 		OnExit(Event);
 	}
 
+	void CMainFrame::OnRenderStatisticsClicked(
+		wxCommandEvent& WXUNUSED(Event))
+	{
+		// Toggle render statistics overlay of m_pDrawPanel. Statistics are
+		// also written to the log window in Debug.
+		m_pDrawPanel->ShowRenderStatistics(
+			!m_pDrawPanel->IsRenderStatisticsShown());
+	}
+
+#ifdef _DEBUG
+	void CMainFrame::OnRenderBenchmarkClicked(wxCommandEvent& WXUNUSED(Event))
+	{
+		wxLogInfo(wxString("Render benchmark requested."));
+
+		// Run benchmark suite with current ruler's colours, then compare
+		// graphics backends, tick submission and kernels for current
+		// ruler's length and check steady-state allocations. Results are
+		// written to the log window.
+		wxBusyCursor BusyCursor;
+		CRenderBenchmark Benchmark;
+		Benchmark.Run(m_pDrawPanel->GetRenderConfig());
+		Benchmark.RunBackends(m_pDrawPanel->GetRenderConfig(), m_iRulerLength);
+		Benchmark.RunTickSubmission(
+			m_pDrawPanel->GetRenderConfig(), m_iRulerLength);
+		Benchmark.RunPixelKernels(m_iRulerLength);
+		Benchmark.RunConversionKernels(m_iRulerLength);
+		Benchmark.CheckSteadyStateAllocations(
+			m_pDrawPanel->GetRenderConfig());
+	}
+#endif
+
 	void CMainFrame::OnExit(wxCommandEvent& Event)
 	{
 		// If user decided that WinRuler should be closed, then ...
@@ -597,21 +697,10 @@ namespace WinRuler
 		m_eRulerPosition = NewPosition;
 
 		// ... set new size of CMainFrame.
-		switch (NewPosition)
-		{
-		case ERulerPosition::rpLeft:
-		case ERulerPosition::rpRight:
-			// Set vertical position.
-			SetSize(60, m_iRulerLength);
-
-			break;
-		case ERulerPosition::rpTop:
-		case ERulerPosition::rpBottom:
-			// Set horizontal position.
-			SetSize(m_iRulerLength, 60);
+		SetSize(GetRulerSize());
 
-			break;
-		}
+		// Invalidate cached layers of m_pDrawPanel.
+		m_pDrawPanel->InvalidateLayers();
 
 		// At end refresh CMainFrame.
 		Refresh();
@@ -650,6 +739,9 @@ namespace WinRuler
 		// Set new ruler units.
 		m_eRulerUnits = NewUnit;
 
+		// Invalidate cached layers of m_pDrawPanel.
+		m_pDrawPanel->InvalidateLayers();
+
 		// Refresh CMainFrame.
 		Refresh();
 	}
@@ -666,25 +758,31 @@ namespace WinRuler
 		// Set NewLength as current ruler's length.
 		m_iRulerLength = NewLength;
 
-		// Prepare new size for the ruler.
-		wxSize NewSize;
+		// Update size.
+		SetSize(GetRulerSize());
+
+		// Refresh CMainFrame.
+		Refresh();
+	}
+
+	wxSize CMainFrame::GetRulerSize() const
+	{
+		// Ruler's thickness is scaled the same way as the rest of ruler's
+		// metrics.
+		int iThickness =
+			GetRulerMetrics(
+				GetDPIScaleFactor() / GetContentScaleFactor()).iThickness;
+
 		switch (m_eRulerPosition)
 		{
 		case ERulerPosition::rpLeft:
 		case ERulerPosition::rpRight:
-			NewSize = wxSize(60, m_iRulerLength);
-			break;
+			return wxSize(iThickness, m_iRulerLength);
 		case ERulerPosition::rpTop:
 		case ERulerPosition::rpBottom:
-			NewSize = wxSize(m_iRulerLength, 60);
-			break;
+		default:
+			return wxSize(m_iRulerLength, iThickness);
 		}
-
-		// Update size.
-		SetSize(NewSize);
-
-		// Refresh CMainFrame.
-		Refresh();
 	}
 
 	bool CMainFrame::LoadSettingsFromDatabase(
@@ -958,6 +1056,7 @@ namespace WinRuler
 		}
 
 		// Process loaded settings.
+		unsigned int DisplayNo;
 		for (const auto& [Key, Value] : Settings)
 		{
 			if (Key == "ruler_position")
@@ -967,6 +1066,25 @@ namespace WinRuler
 			else if (Key == "ruler_units")
 			{
 				m_eRulerUnits = static_cast<ERulerUnits>(wxAtoi(Value));
+
+				// Units unknown to this version fall back to centimetres.
+				if ((m_eRulerUnits < 0) ||
+					(m_eRulerUnits >= ERulerUnits::ruCount))
+					m_eRulerUnits = ERulerUnits::ruCentimetres;
+			}
+			else if (Key == "user_unit_per_inch")
+			{
+				double dUnitsPerInch;
+
+				// Values out of supported range keep default unit.
+				if (Value.ToCDouble(&dUnitsPerInch) &&
+					IsValidUserDefinedUnitsPerInch(dUnitsPerInch))
+					SetUserDefinedUnit(
+						dUnitsPerInch, GetUserDefinedUnitSymbol());
+			}
+			else if (Key == "user_unit_symbol")
+			{
+				SetUserDefinedUnit(GetUserDefinedUnitsPerInch(), Value);
 			}
 			else if (Key == "ruler_background_type")
 			{
@@ -1009,6 +1127,20 @@ namespace WinRuler
 			{
 				m_iRulerTransparencyValue = static_cast<int>(wxAtoi(Value));
 			}
+			else if (Key == "render_backend")
+			{
+				m_eRenderBackend = static_cast<ERenderBackend>(wxAtoi(Value));
+
+				// Backends unknown to this version fall back to device
+				// context backend.
+				if ((m_eRenderBackend < ERenderBackend::rbDC) ||
+					(m_eRenderBackend > ERenderBackend::rbSoftware))
+					m_eRenderBackend = ERenderBackend::rbDC;
+			}
+			else if (Key == "layer_prerender_budget")
+			{
+				m_iLayerPrerenderBudget = static_cast<int>(wxAtoi(Value));
+			}
 			else if (Key == "ruler_first_marker_colour")
 			{
 				m_cFirstMarkerColour = static_cast<wxColour>(Value);
@@ -1021,13 +1153,27 @@ namespace WinRuler
 			{
 				m_sRulerBackgroundImagePath = static_cast<wxString>(Value);
 			}
-			else if (Key == "vertical_ppi")
+			else if (ParseDisplaySettingKey(Key, "vertical_ppi", DisplayNo))
 			{
-				g_vPixelPerInch[0].y = static_cast<int>(wxAtoi(Value));
+				double dPixelPerInch;
+
+				// Calibration of display which is not connected now stays
+				// in database, but it is not used. Values stored as whole
+				// numbers by older versions are parsed the same way. Values
+				// which are not valid keep PPI value of the system.
+				if ((DisplayNo < g_vPixelPerInch.size()) &&
+					Value.ToCDouble(&dPixelPerInch) &&
+					IsValidPixelPerInch(dPixelPerInch))
+					g_vPixelPerInch[DisplayNo].y = dPixelPerInch;
 			}
-			else if (Key == "horizontal_ppi")
+			else if (ParseDisplaySettingKey(Key, "horizontal_ppi", DisplayNo))
 			{
-				g_vPixelPerInch[0].x = static_cast<int>(wxAtoi(Value));
+				double dPixelPerInch;
+
+				if ((DisplayNo < g_vPixelPerInch.size()) &&
+					Value.ToCDouble(&dPixelPerInch) &&
+					IsValidPixelPerInch(dPixelPerInch))
+					g_vPixelPerInch[DisplayNo].x = dPixelPerInch;
 			}
 			else if (Key == "window_position")
 			{
@@ -1073,6 +1219,9 @@ namespace WinRuler
 		Settings["ruler_position"] = wxString::Format("%d", m_eRulerPosition);
 
 		Settings["ruler_units"] = wxString::Format("%d", m_eRulerUnits);
+		Settings["user_unit_per_inch"] =
+			wxString::FromCDouble(GetUserDefinedUnitsPerInch(), 6);
+		Settings["user_unit_symbol"] = GetUserDefinedUnitSymbol();
 
 		Settings["ruler_background_type"] =
 			wxString::Format("%d", m_eRulerBackgroundType);
@@ -1098,6 +1247,10 @@ namespace WinRuler
 		Settings["ruler_transparency_value"] =
 			wxString::Format("%d", m_iRulerTransparencyValue);
 
+		Settings["render_backend"] = wxString::Format("%d", m_eRenderBackend);
+		Settings["layer_prerender_budget"] =
+			wxString::Format("%d", m_iLayerPrerenderBudget);
+
 		Settings["ruler_first_marker_colour"] =
 			m_cFirstMarkerColour.GetAsString(wxC2S_HTML_SYNTAX);
 		Settings["ruler_second_marker_colour"] =
@@ -1105,10 +1258,14 @@ namespace WinRuler
 
 		Settings["ruler_background_image_path"] = m_sRulerBackgroundImagePath;
 
-		Settings["vertical_ppi"] =
-			wxString::Format("%d", g_vPixelPerInch[0].GetY());
-		Settings["horizontal_ppi"] =
-			wxString::Format("%d", g_vPixelPerInch[0].GetX());
+		// Every display has its own calibration.
+		for (unsigned int I = 0; I < g_vPixelPerInch.size(); I++)
+		{
+			Settings[GetDisplaySettingKey("vertical_ppi", I)] =
+				wxString::FromCDouble(g_vPixelPerInch[I].y, 2);
+			Settings[GetDisplaySettingKey("horizontal_ppi", I)] =
+				wxString::FromCDouble(g_vPixelPerInch[I].x, 2);
+		}
 
 		wxPoint WindowPosition = GetPosition();
 		Settings["window_position"] =
@@ -1374,10 +1531,27 @@ namespace WinRuler
 		if (m_bSnapToOtherWindows)
 			SnapToOtherWindows();
 
+		// Ruler could be moved to another display, which has its own PPI
+		// value, so its layers must be rebuilt.
+		if (m_pDrawPanel->UpdateDisplay())
+			m_pDrawPanel->Refresh(false);
+
 		// Continue event handling.
 		Event.Skip();
 	}
 
+	void CMainFrame::OnDPIChanged(wxDPIChangedEvent& WXUNUSED(Event))
+	{
+		// Ruler was moved to display with different DPI. Its thickness is
+		// updated, its length stays the same, so the event is not skipped
+		// and window is not rescaled proportionally. Cached layers of the
+		// previous display are kept by m_pDrawPanel.
+		SetSize(GetRulerSize());
+
+		// Refresh CMainFrame.
+		Refresh();
+	}
+
 	void CMainFrame::BorderDragInit()
 	{
 		// Initialize border dragging values.
@@ -35,13 +35,16 @@ enum EMenuIDs
 	ID_RULER_POSITION_SCALE_ON_RIGHT = 12,
 	ID_RULER_POSITION_SCALE_ON_TOP = 13,
 	ID_RULER_POSITION_SCALE_ON_BOTTOM = 14,
-	ID_PIXELS_AS_UNIT = 15,
-	ID_CENTIMETRES_AS_UNIT = 16,
-	ID_INCHES_AS_UNIT = 17,
-	ID_PICAS_AS_UNIT = 18,
 	ID_ALWAYS_ON_TOP = 19,
 	ID_NEW_RULER_LENGTH = 20,
-	ID_OPTIONS = 21
+	ID_OPTIONS = 21,
+	ID_RENDER_BENCHMARK = 22,
+	ID_RENDER_STATISTICS = 23,
+
+	// Units of measurement, ID of unit U is ID_UNIT_OF_MEASUREMENT + U.
+	ID_UNIT_OF_MEASUREMENT = 100,
+	ID_UNIT_OF_MEASUREMENT_LAST =
+		ID_UNIT_OF_MEASUREMENT + WinRuler::ERulerUnits::ruCount - 1
 };
 
 namespace WinRuler
@@ -59,10 +62,7 @@ namespace WinRuler
 		 **/
 		void OnOptionsClicked(wxCommandEvent& Event);
 		void OnNewRulerLengthClicked(wxCommandEvent& Event);
-		void OnPixelsAsUnitClicked(wxCommandEvent& Event);
-		void OnCentimetresAsUnitClicked(wxCommandEvent& Event);
-		void OnInchesAsUnitClicked(wxCommandEvent& Event);
-		void OnPicasAsUnitClicked(wxCommandEvent& Event);
+		void OnUnitOfMeasurementClicked(wxCommandEvent& Event);
 		void OnAlwaysOnTopClicked(wxCommandEvent& Event);
 		void OnScaleOnLeftClicked(wxCommandEvent& Event);
 		void OnScaleOnTopClicked(wxCommandEvent& Event);
@@ -70,6 +70,10 @@ namespace WinRuler
 		void OnScaleOnBottomClicked(wxCommandEvent& Event);
 		void OnAboutClicked(wxCommandEvent& Event);
 		void OnCloseClicked(wxCommandEvent& Event);
+		void OnRenderStatisticsClicked(wxCommandEvent& Event);
+#ifdef _DEBUG
+		void OnRenderBenchmarkClicked(wxCommandEvent& Event);
+#endif
 	public:
 		/**
 		 * CMainFrame constructor.
@@ -128,6 +132,15 @@ namespace WinRuler
 		 **/
 		void ChangeRulerLength(int NewLength);
 
+		/**
+		 * Returns size of the ruler's window for current ruler's position
+		 * and length. Ruler's thickness is scaled for display which shows
+		 * the ruler, ruler's length is a measurement and it is not scaled.
+		 *
+		 * \return	Returns size of the ruler's window.
+		 **/
+		wxSize GetRulerSize() const;
+
 		/**
 		 * Loads and prepare ruler's images for background image type drawing.
 		 *
@@ -202,6 +215,14 @@ namespace WinRuler
 		 * \param Event		Reference to wxMoveEvent instance.
 		 **/
 		void OnMove(wxMoveEvent& Event);
+
+		/**
+		 * OnDPIChanged() method event. It updates ruler's thickness for DPI
+		 * of the display which shows the ruler.
+		 *
+		 * \param Event		Reference to wxDPIChangedEvent instance.
+		 **/
+		void OnDPIChanged(wxDPIChangedEvent& Event);
 	protected:
 		/**
 		 * Performs initialization of border dragging.
@@ -291,6 +312,13 @@ namespace WinRuler
 		//! Ruler transparency value.
 		wxByte m_iRulerTransparencyValue = 255;
 
+		//! Graphics backend used for ruler's rendering.
+		ERenderBackend m_eRenderBackend = rbDC;
+
+		//! Memory budget of layers pre-rendered during idle time in MB, 0
+		//! disables pre-rendering.
+		int m_iLayerPrerenderBudget = 32;
+
 		//! First marker position.
 		int m_iFirstMarkerPosition = 0;
 
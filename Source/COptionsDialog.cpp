@@ -3,8 +3,11 @@
  * Licensed under the MIT license.
  **/
 
+#include <cmath>
+#include <algorithm>
 #include "COptionsDialog.h"
 #include "CMainFrame.h"
+#include "WRRulerUnits.h"
 
 namespace WinRuler
 {
@@ -78,6 +81,10 @@ namespace WinRuler
 		wxDELETE(m_pRulerTransparencyCheckBox);
 		wxDELETE(m_pRulerTransparencyText);
 		wxDELETE(m_pRulerTransparencySlider);
+		wxDELETE(m_pRenderBackendText);
+		wxDELETE(m_pRenderBackendChoice);
+		wxDELETE(m_pLayerPrerenderBudgetText);
+		wxDELETE(m_pLayerPrerenderBudgetSpinCtrl);
 		wxDELETE(m_pSpecialOptionsStaticBox);
 
 		wxDELETE(m_pRulerScaleColourText);
@@ -86,6 +93,9 @@ namespace WinRuler
 		wxDELETE(m_pRulerSecondMarkerColourText);
 		wxDELETE(m_pFirstMarkerColourPicker);
 		wxDELETE(m_pSecondMarkerColourPicker);
+		wxDELETE(m_pUserDefinedUnitText);
+		wxDELETE(m_pUserDefinedUnitSymbolTextCtrl);
+		wxDELETE(m_pUserDefinedUnitsPerInchTextCtrl);
 		wxDELETE(m_pScaleAndMarkersStaticBox);
 
 		wxDELETE(m_pBackgroundTypeText);
@@ -133,11 +143,19 @@ namespace WinRuler
 		m_pRulerSecondMarkerColourText = NULL;
 		m_pFirstMarkerColourPicker = NULL;
 		m_pSecondMarkerColourPicker = NULL;
+		m_pUserDefinedUnitText = NULL;
+		m_pUserDefinedUnitSymbolTextCtrl = NULL;
+		m_pUserDefinedUnitsPerInchTextCtrl = NULL;
 		m_pSpecialOptionsStaticBox = NULL;
 		m_pRulerTransparencyCheckBox = NULL;
 		m_pRulerTransparencyText = NULL;
+		m_pRenderBackendText = NULL;
+		m_pRenderBackendChoice = NULL;
+		m_pLayerPrerenderBudgetText = NULL;
+		m_pLayerPrerenderBudgetSpinCtrl = NULL;
 		m_pRulerTransparencySlider = NULL;
 		m_pCalibrateStaticBox = NULL;
+		m_uDisplayNo = 0;
 		m_pCalibrateInfoText = NULL;
 		m_pVRulerPanel = NULL;
 		m_pV_IncButton = NULL;
@@ -279,20 +297,15 @@ namespace WinRuler
 		wxSize size(m_pVRulerPanel->GetClientSize());
 		wxRect surfaceRect(0, 0, size.GetWidth(), size.GetHeight());
 
+		// Preview uses ruler's appearance of the main frame with fixed
+		// position and without markers.
+		SRulerRenderConfig Config = pMainFrame->m_pDrawPanel->GetRenderConfig();
+		Config.eRulerPosition = ERulerPosition::rpLeft;
+		Config.iFirstMarkerPosition = -1;
+		Config.iSecondMarkerPosition = -1;
+
 		// Draw ruler's surface on specified display context.
-		pMainFrame->m_pDrawPanel->DrawRulerSurface(
-			dc, surfaceRect,
-			ERulerPosition::rpLeft,
-			pMainFrame->m_eRulerBackgroundType,
-			pMainFrame->m_cRulerBackgroundColour,
-			pMainFrame->m_cRulerBackgroundStartColour,
-			pMainFrame->m_cRulerBackgroundEndColour,
-			pMainFrame->m_RulerBackgroundBitmapLeftH,
-			pMainFrame->m_RulerBackgroundBitmapMiddleH,
-			pMainFrame->m_RulerBackgroundBitmapRightH,
-			pMainFrame->m_RulerBackgroundBitmapTopV,
-			pMainFrame->m_RulerBackgroundBitmapMiddleV,
-			pMainFrame->m_RulerBackgroundBitmapBottomV);
+		m_VRulerRenderer.DrawSurface(dc, surfaceRect, Config);
 
 		// Draw ruler's scale.
 		int nSelection =
@@ -317,19 +330,8 @@ namespace WinRuler
 		else // If selection is invalid, set ruler units to default one.
 			rulerUnits = ERulerUnits::ruCentimetres;
 
-		pMainFrame->m_pDrawPanel->DrawRulerScale(
-			dc, surfaceRect, pMainFrame->m_cRulerScaleColour,
-			ERulerPosition::rpLeft, rulerUnits);
-
-		// Draw ruler's markers.
-		pMainFrame->m_pDrawPanel->DrawRulerMarkers(
-			dc, surfaceRect,
-			ERulerPosition::rpLeft,
-			pMainFrame->m_eRulerUnits,
-			pMainFrame->m_cRulerScaleColour,
-			pMainFrame->m_cFirstMarkerColour,
-			pMainFrame->m_cSecondMarkerColour,
-			-1, -1);
+		Config.eRulerUnits = rulerUnits;
+		m_VRulerRenderer.DrawScale(dc, surfaceRect, Config);
 	}
 
 	void COptionsDialog::HRulerPanel_Render(wxDC& dc)
@@ -341,20 +343,15 @@ namespace WinRuler
 		wxSize size(m_pHRulerPanel->GetClientSize());
 		wxRect surfaceRect(0, 0, size.GetWidth(), size.GetHeight());
 
-		// Draw ruler's surface.
-		pMainFrame->m_pDrawPanel->DrawRulerSurface(
-			dc, surfaceRect,
-			ERulerPosition::rpTop,
-			pMainFrame->m_eRulerBackgroundType,
-			pMainFrame->m_cRulerBackgroundColour,
-			pMainFrame->m_cRulerBackgroundStartColour,
-			pMainFrame->m_cRulerBackgroundEndColour,
-			pMainFrame->m_RulerBackgroundBitmapLeftH,
-			pMainFrame->m_RulerBackgroundBitmapMiddleH,
-			pMainFrame->m_RulerBackgroundBitmapRightH,
-			pMainFrame->m_RulerBackgroundBitmapTopV,
-			pMainFrame->m_RulerBackgroundBitmapMiddleV,
-			pMainFrame->m_RulerBackgroundBitmapBottomV);
+		// Preview uses ruler's appearance of the main frame with fixed
+		// position and without markers.
+		SRulerRenderConfig Config = pMainFrame->m_pDrawPanel->GetRenderConfig();
+		Config.eRulerPosition = ERulerPosition::rpTop;
+		Config.iFirstMarkerPosition = -1;
+		Config.iSecondMarkerPosition = -1;
+
+		// Draw ruler's surface on specified display context.
+		m_HRulerRenderer.DrawSurface(dc, surfaceRect, Config);
 
 		// Draw ruler's scale.
 		int nSelection =
@@ -379,19 +376,8 @@ namespace WinRuler
 		else // If selection is invalid, set ruler units to default one.
 			rulerUnits = ERulerUnits::ruCentimetres;
 
-		pMainFrame->m_pDrawPanel->DrawRulerScale(
-			dc, surfaceRect, pMainFrame->m_cRulerScaleColour,
-			ERulerPosition::rpTop, rulerUnits);
-
-		// Draw ruler's markers.
-		pMainFrame->m_pDrawPanel->DrawRulerMarkers(
-			dc, surfaceRect,
-			ERulerPosition::rpTop,
-			pMainFrame->m_eRulerUnits,
-			pMainFrame->m_cRulerScaleColour,
-			pMainFrame->m_cFirstMarkerColour,
-			pMainFrame->m_cSecondMarkerColour,
-			-1, -1);
+		Config.eRulerUnits = rulerUnits;
+		m_HRulerRenderer.DrawScale(dc, surfaceRect, Config);
 	}
 
 	void COptionsDialog::CreateRulerPageControls()
@@ -496,6 +482,20 @@ namespace WinRuler
 				m_pScaleAndMarkersStaticBox, wxID_ANY,
 				pMainFrame->m_cSecondMarkerColour);
 
+		// Create user-defined unit of measurement text controls.
+		m_pUserDefinedUnitText =
+			new wxStaticText(
+				m_pScaleAndMarkersStaticBox, wxID_ANY,
+				wxString("User-defined unit (symbol, units per inch):"));
+		m_pUserDefinedUnitSymbolTextCtrl =
+			new wxTextCtrl(
+				m_pScaleAndMarkersStaticBox, wxID_ANY,
+				GetUserDefinedUnitSymbol());
+		m_pUserDefinedUnitsPerInchTextCtrl =
+			new wxTextCtrl(
+				m_pScaleAndMarkersStaticBox, wxID_ANY,
+				wxString::FromCDouble(GetUserDefinedUnitsPerInch()));
+
 		// Create wxStaticBox for Special options.
 		m_pSpecialOptionsStaticBox =
 			new wxStaticBox(
@@ -522,6 +522,36 @@ namespace WinRuler
 				0, 255, wxDefaultPosition, wxDefaultSize,
 				wxSL_HORIZONTAL | wxSL_VALUE_LABEL);
 
+		// Create new rendering backend choice.
+		wxArrayString BackendChoices;
+		BackendChoices.Add(wxString("Classic (wxDC)"));
+		BackendChoices.Add(wxString("Anti-aliased (wxGraphicsContext)"));
+		BackendChoices.Add(wxString("Software (SIMD rasteriser)"));
+
+		m_pRenderBackendText =
+			new wxStaticText(
+				m_pSpecialOptionsStaticBox, wxID_ANY,
+				wxString("Rendering backend:"));
+		m_pRenderBackendChoice =
+			new wxChoice(
+				m_pSpecialOptionsStaticBox, wxID_ANY,
+				wxDefaultPosition, wxDefaultSize,
+				BackendChoices);
+
+		// Select current rendering backend.
+		m_pRenderBackendChoice->Select(pMainFrame->m_eRenderBackend);
+
+		// Create new pre-rendered layers memory budget spin control.
+		m_pLayerPrerenderBudgetText =
+			new wxStaticText(
+				m_pSpecialOptionsStaticBox, wxID_ANY,
+				wxString("Pre-rendered layers memory (MB, 0 = off):"));
+		m_pLayerPrerenderBudgetSpinCtrl =
+			new wxSpinCtrl(
+				m_pSpecialOptionsStaticBox, wxID_ANY,
+				wxString::Format("%d", pMainFrame->m_iLayerPrerenderBudget),
+				wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 512);
+
 		// At the end of ruler page creation, enable proper items depending on
 		// current settings.
 		switch (pMainFrame->m_eRulerBackgroundType)
@@ -572,10 +602,18 @@ namespace WinRuler
 
 	void COptionsDialog::CreateCalibrationPageControls()
 	{
+		// Retrieve pointer to CMainFrame class.
+		CMainFrame* pMainFrame = static_cast<CMainFrame*>(this->GetParent());
+
+		// Every display has its own calibration, the display which shows
+		// the ruler is calibrated.
+		m_uDisplayNo = pMainFrame->m_pDrawPanel->GetDisplayNo();
+
 		// Create Calibrate static box.
 		m_pCalibrateStaticBox =
 			new wxStaticBox(
-				m_pCalibrationPanel, wxID_ANY, wxString("Calibrate"));
+				m_pCalibrationPanel, wxID_ANY,
+				wxString::Format("Calibrate display %u", m_uDisplayNo + 1));
 
 		// Create Calibrate information text.
 		m_pCalibrateInfoText =
@@ -597,7 +635,9 @@ namespace WinRuler
 					"""Increase"" or ""Decrease"" button. Note that you must "
 					"calibrate horizontal and vertical PPI values. After "
 					"proper calibration, the ruler should indicate the "
-					"correct distances."));
+					"correct distances. Every display is calibrated "
+					"separately, this page calibrates the display which "
+					"shows the ruler."));
 
 		// Create unit of measurement type choice.
 		wxArrayString Choices;
@@ -660,12 +700,14 @@ namespace WinRuler
 			new wxStaticText(
 				m_pCalibrateStaticBox, wxID_ANY,
 				wxString::Format(
-					"Vertical PPI: %d", g_vPixelPerInch[0].GetY()));
+					"Vertical PPI: %.1f",
+					GetPixelPerInch(m_uDisplayNo).y));
 		m_pHPPIStaticText =
 			new wxStaticText(
 				m_pCalibrateStaticBox, wxID_ANY,
 				wxString::Format(
-					"Horizontal PPI: %d", g_vPixelPerInch[0].GetX()));
+					"Horizontal PPI: %.1f",
+					GetPixelPerInch(m_uDisplayNo).x));
 	}
 
 	void COptionsDialog::CreateAdditionalFeaturesPageControls()
@@ -792,6 +834,12 @@ namespace WinRuler
 		pScaleAndMarkersBoxSizer->Add(m_pFirstMarkerColourPicker, flags2);
 		pScaleAndMarkersBoxSizer->Add(m_pRulerSecondMarkerColourText, flags1);
 		pScaleAndMarkersBoxSizer->Add(m_pSecondMarkerColourPicker, flags2);
+		pScaleAndMarkersBoxSizer->AddSpacer(5);
+		pScaleAndMarkersBoxSizer->Add(m_pUserDefinedUnitText, flags1);
+		pScaleAndMarkersBoxSizer->Add(
+			m_pUserDefinedUnitSymbolTextCtrl, flags2);
+		pScaleAndMarkersBoxSizer->Add(
+			m_pUserDefinedUnitsPerInchTextCtrl, flags2);
 		pScaleAndMarkersBoxSizer->AddSpacer(20);
 
 		m_pScaleAndMarkersStaticBox->SetSizerAndFit(pScaleAndMarkersBoxSizer);
@@ -804,6 +852,12 @@ namespace WinRuler
 		pSpecialOptionsBoxSizer->Add(m_pRulerTransparencyCheckBox, flags1);
 		pSpecialOptionsBoxSizer->Add(m_pRulerTransparencyText, flags1);
 		pSpecialOptionsBoxSizer->Add(m_pRulerTransparencySlider, flags2);
+		pSpecialOptionsBoxSizer->AddSpacer(5);
+		pSpecialOptionsBoxSizer->Add(m_pRenderBackendText, flags1);
+		pSpecialOptionsBoxSizer->Add(m_pRenderBackendChoice, flags2);
+		pSpecialOptionsBoxSizer->AddSpacer(5);
+		pSpecialOptionsBoxSizer->Add(m_pLayerPrerenderBudgetText, flags1);
+		pSpecialOptionsBoxSizer->Add(m_pLayerPrerenderBudgetSpinCtrl, flags2);
 		pSpecialOptionsBoxSizer->AddSpacer(20);
 
 		m_pSpecialOptionsStaticBox->SetSizerAndFit(pSpecialOptionsBoxSizer);
@@ -930,12 +984,14 @@ namespace WinRuler
 	void COptionsDialog::OnVerticalRulerIncreaseButtonClicked(
         wxCommandEvent& Event)
 	{
-		// Increment vertical PPI value by 1.
-		g_vPixelPerInch[0].y++;
+		// Increment vertical PPI value by 0.1. Value is rounded to
+		// tenths, so repeated steps do not accumulate error.
+		wxRealPoint& PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+		PixelPerInch.y = std::round((PixelPerInch.y * 10.0) + 1.0) / 10.0;
 
 		// Update m_pVPPIStaticText label text.
 		m_pVPPIStaticText->SetLabel(
-			wxString::Format("Vertical PPI: %d", g_vPixelPerInch[0].GetY()));
+			wxString::Format("Vertical PPI: %.1f", PixelPerInch.y));
 
 		// Redraw vertical ruler panel.
 		m_pVRulerPanel->Refresh();
@@ -944,12 +1000,18 @@ namespace WinRuler
 	void COptionsDialog::OnVerticalRulerDecreaseButtonClicked(
         wxCommandEvent& Event)
 	{
-		// Decrement vertical PPI value by 1.
-		g_vPixelPerInch[0].y--;
+		// Decrement vertical PPI value by 0.1, but not below
+		// PixelPerInchMin. Value is rounded to tenths, so repeated steps do
+		// not accumulate error.
+		wxRealPoint& PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+		PixelPerInch.y =
+			std::max(
+				PixelPerInchMin,
+				std::round((PixelPerInch.y * 10.0) - 1.0) / 10.0);
 
 		// Update m_pVPPIStaticText label text.
 		m_pVPPIStaticText->SetLabel(
-			wxString::Format("Vertical PPI: %d", g_vPixelPerInch[0].GetY()));
+			wxString::Format("Vertical PPI: %.1f", PixelPerInch.y));
 
 		// Redraw vertical ruler panel.
 		m_pVRulerPanel->Refresh();
@@ -958,12 +1020,14 @@ namespace WinRuler
 	void COptionsDialog::OnHorizontalRulerIncreaseButtonClicked(
         wxCommandEvent& Event)
 	{
-		// Increment horizontal PPI value by 1.
-		g_vPixelPerInch[0].x++;
+		// Increment horizontal PPI value by 0.1. Value is rounded to
+		// tenths, so repeated steps do not accumulate error.
+		wxRealPoint& PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+		PixelPerInch.x = std::round((PixelPerInch.x * 10.0) + 1.0) / 10.0;
 
 		// Update m_pHPPIStaticText label text.
 		m_pHPPIStaticText->SetLabel(
-			wxString::Format("Horizontal PPI: %d", g_vPixelPerInch[0].GetX()));
+			wxString::Format("Horizontal PPI: %.1f", PixelPerInch.x));
 
 		// Redraw horizontal ruler panel.
 		m_pHRulerPanel->Refresh();
@@ -972,12 +1036,18 @@ namespace WinRuler
 	void COptionsDialog::OnHorizontalRulerDecreaseButtonClicked(
         wxCommandEvent& Event)
 	{
-		// Decrement horizontal PPI value by 1.
-		g_vPixelPerInch[0].x--;
+		// Decrement horizontal PPI value by 0.1, but not below
+		// PixelPerInchMin. Value is rounded to tenths, so repeated steps do
+		// not accumulate error.
+		wxRealPoint& PixelPerInch = GetPixelPerInch(m_uDisplayNo);
+		PixelPerInch.x =
+			std::max(
+				PixelPerInchMin,
+				std::round((PixelPerInch.x * 10.0) - 1.0) / 10.0);
 
 		// Update m_pHPPIStaticText label text.
 		m_pHPPIStaticText->SetLabel(
-			wxString::Format("Horizontal PPI: %d", g_vPixelPerInch[0].GetX()));
+			wxString::Format("Horizontal PPI: %.1f", PixelPerInch.x));
 
 		// Redraw horizontal ruler panel.
 		m_pHRulerPanel->Refresh();
@@ -11,6 +11,7 @@
 #include <wx/clrpicker.h>
 #include <wx/filepicker.h>
 #include <wx/spinctrl.h>
+#include "CRulerRenderer.h"
 
 /**
  * Enumeration of options ids.
@@ -264,6 +265,13 @@ namespace WinRuler
 		wxColourPickerCtrl* m_pFirstMarkerColourPicker;
 		wxColourPickerCtrl* m_pSecondMarkerColourPicker;
 
+		//! User-defined unit of measurement text.
+		wxStaticText* m_pUserDefinedUnitText;
+
+		//! User-defined unit's symbol and number of units per inch.
+		wxTextCtrl* m_pUserDefinedUnitSymbolTextCtrl;
+		wxTextCtrl* m_pUserDefinedUnitsPerInchTextCtrl;
+
 		//! Special options static box.
 		wxStaticBox* m_pSpecialOptionsStaticBox;
 
@@ -276,9 +284,24 @@ namespace WinRuler
 		//! Ruler transparency value.
 		wxSlider* m_pRulerTransparencySlider;
 
+		//! Rendering backend text.
+		wxStaticText* m_pRenderBackendText;
+
+		//! Rendering backend choice.
+		wxChoice* m_pRenderBackendChoice;
+
+		//! Pre-rendered layers memory budget text.
+		wxStaticText* m_pLayerPrerenderBudgetText;
+
+		//! Pre-rendered layers memory budget spin control.
+		wxSpinCtrl* m_pLayerPrerenderBudgetSpinCtrl;
+
 		//! Calibrate static box.
 		wxStaticBox* m_pCalibrateStaticBox;
 
+		//! Number of calibrated display (the one which shows the ruler).
+		unsigned int m_uDisplayNo;
+
 		//! Calibrate info text.
 		wxStaticText* m_pCalibrateInfoText;
 
@@ -292,6 +315,11 @@ namespace WinRuler
 		wxPanel* m_pVRulerPanel;
 		wxPanel* m_pHRulerPanel;
 
+		//! Renderers of vertical and horizontal panels. Every panel has its
+		//! own, so their scale layouts are not rebuilt on every paint.
+		CRulerRenderer m_VRulerRenderer;
+		CRulerRenderer m_HRulerRenderer;
+
 		//! Vertical increse & decrese buttons.
 		wxButton* m_pV_IncButton;
 		wxButton* m_pV_DecButton;
@@ -0,0 +1,164 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <algorithm>
+#include <wx/wx.h>
+#include <wx/rawbmp.h>
+#include "CPixelBuffer.h"
+
+namespace WinRuler
+{
+    CPixelBuffer::CPixelBuffer() :
+        m_Size(0, 0)
+    {
+        // No code.
+    }
+
+    void CPixelBuffer::Resize(const wxSize& Size)
+    {
+        m_Size =
+            wxSize(
+                std::max(Size.GetWidth(), 0), std::max(Size.GetHeight(), 0));
+
+        // Vector keeps its capacity, so shrinking does not allocate.
+        m_vPixels.resize(
+            static_cast<size_t>(m_Size.GetWidth()) *
+            static_cast<size_t>(m_Size.GetHeight()));
+    }
+
+    const wxSize& CPixelBuffer::GetSize() const
+    {
+        return m_Size;
+    }
+
+    wxUint32* CPixelBuffer::GetRow(int iY)
+    {
+        return m_vPixels.data() +
+            (static_cast<size_t>(iY) * static_cast<size_t>(m_Size.GetWidth()));
+    }
+
+    const wxUint32* CPixelBuffer::GetRow(int iY) const
+    {
+        return m_vPixels.data() +
+            (static_cast<size_t>(iY) * static_cast<size_t>(m_Size.GetWidth()));
+    }
+
+    void CPixelBuffer::CopyFrom(
+        const CPixelBuffer& Source, const wxRect& SourceRect)
+    {
+        Resize(SourceRect.GetSize());
+
+        for (int Y = 0; Y < m_Size.GetHeight(); Y++)
+        {
+            const wxUint32* pSource =
+                Source.GetRow(SourceRect.GetY() + Y) + SourceRect.GetX();
+
+            std::copy(pSource, pSource + m_Size.GetWidth(), GetRow(Y));
+        }
+    }
+
+    void CPixelBuffer::DrawImage(const wxImage& Image, const wxPoint& Point)
+    {
+        if (!Image.IsOk())
+            return;
+
+        // Clip image to the buffer.
+        wxRect Rect(Point, Image.GetSize());
+        Rect.Intersect(wxRect(m_Size));
+        if (Rect.IsEmpty())
+            return;
+
+        const unsigned char* pRGB = Image.GetData();
+        const unsigned char* pAlpha =
+            Image.HasAlpha() ? Image.GetAlpha() : nullptr;
+        bool bMask = Image.HasMask();
+        unsigned char MaskRed = bMask ? Image.GetMaskRed() : 0;
+        unsigned char MaskGreen = bMask ? Image.GetMaskGreen() : 0;
+        unsigned char MaskBlue = bMask ? Image.GetMaskBlue() : 0;
+
+        // Images are drawn only during composition of cached surface, so
+        // simple per pixel loop is good enough.
+        for (int Y = Rect.GetTop(); Y <= Rect.GetBottom(); Y++)
+        {
+            wxUint32* pDst = GetRow(Y);
+            size_t Offset =
+                (static_cast<size_t>(Y - Point.y) *
+                    static_cast<size_t>(Image.GetWidth())) +
+                static_cast<size_t>(Rect.GetLeft() - Point.x);
+
+            for (int X = Rect.GetLeft(); X <= Rect.GetRight(); X++, Offset++)
+            {
+                wxUint32 uRed = pRGB[(Offset * 3) + 0];
+                wxUint32 uGreen = pRGB[(Offset * 3) + 1];
+                wxUint32 uBlue = pRGB[(Offset * 3) + 2];
+                wxUint32 uAlpha = (pAlpha != nullptr) ? pAlpha[Offset] : 255;
+
+                if (bMask &&
+                    (uRed == MaskRed) &&
+                    (uGreen == MaskGreen) &&
+                    (uBlue == MaskBlue))
+                    uAlpha = 0;
+
+                if (uAlpha == 0)
+                    continue;
+
+                // Source over destination, destination stays opaque.
+                wxUint32 uDst = pDst[X];
+                auto Blend = [uAlpha](wxUint32 uSrc, wxUint32 uDst)
+                {
+                    return
+                        ((uSrc * uAlpha) + (uDst * (255 - uAlpha)) + 127) /
+                        255;
+                };
+
+                pDst[X] = 0xFF000000u |
+                    (Blend(uRed, (uDst >> 16) & 0xFF) << 16) |
+                    (Blend(uGreen, (uDst >> 8) & 0xFF) << 8) |
+                    Blend(uBlue, uDst & 0xFF);
+            }
+        }
+    }
+
+    void CPixelBuffer::CopyToBitmap(wxBitmap& Bitmap) const
+    {
+        if (m_Size.GetWidth() <= 0 || m_Size.GetHeight() <= 0)
+            return;
+
+        if (!Bitmap.IsOk() ||
+            (Bitmap.GetSize() != m_Size) ||
+            (Bitmap.GetDepth() != 32))
+            Bitmap.Create(m_Size, 32);
+
+        wxAlphaPixelData Data(Bitmap);
+        if (!Data)
+            return;
+
+        // Pixels are opaque, so they are the same premultiplied or not.
+        wxAlphaPixelData::Iterator RowStart(Data);
+        for (int Y = 0; Y < m_Size.GetHeight(); Y++)
+        {
+            const wxUint32* pSrc = GetRow(Y);
+            wxAlphaPixelData::Iterator P = RowStart;
+
+            for (int X = 0; X < m_Size.GetWidth(); X++, ++P)
+            {
+                wxUint32 uPixel = pSrc[X];
+
+                P.Red() = static_cast<unsigned char>(uPixel >> 16);
+                P.Green() = static_cast<unsigned char>(uPixel >> 8);
+                P.Blue() = static_cast<unsigned char>(uPixel);
+                P.Alpha() = static_cast<unsigned char>(uPixel >> 24);
+            }
+
+            RowStart.OffsetY(Data, 1);
+        }
+    }
+
+    void CPixelBuffer::Swap(CPixelBuffer& Other)
+    {
+        m_vPixels.swap(Other.m_vPixels);
+        std::swap(m_Size, Other.m_Size);
+    }
+} // end namespace WinRuler
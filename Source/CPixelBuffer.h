@@ -0,0 +1,95 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+
+namespace WinRuler
+{
+    /**
+     * CPixelBuffer class definition. It is 2D array of opaque 32-bit
+     * 0xAARRGGBB pixels stored row by row without padding. Memory is kept
+     * when buffer shrinks, so resizing to the same or smaller size does not
+     * allocate.
+     **/
+    class CPixelBuffer
+    {
+    public:
+        /**
+         * Default constructor. It creates empty buffer.
+         **/
+        CPixelBuffer();
+
+        /**
+         * Changes size of the buffer. Content of the buffer is undefined
+         * after resize.
+         *
+         * \param Size  New size of the buffer.
+         **/
+        void Resize(const wxSize& Size);
+
+        /**
+         * Returns size of the buffer.
+         **/
+        const wxSize& GetSize() const;
+
+        /**
+         * Returns pointer to the first pixel of the row.
+         *
+         * \param iY    Index of the row.
+         **/
+        wxUint32* GetRow(int iY);
+
+        /**
+         * Returns pointer to the first pixel of the row.
+         *
+         * \param iY    Index of the row.
+         **/
+        const wxUint32* GetRow(int iY) const;
+
+        /**
+         * Copies rectangle of another buffer. This buffer is resized to
+         * size of the rectangle.
+         *
+         * \param Source        The source buffer.
+         * \param SourceRect    The rectangle of the source buffer. It must
+         *                      lie inside of the source buffer.
+         **/
+        void CopyFrom(const CPixelBuffer& Source, const wxRect& SourceRect);
+
+        /**
+         * Draws image over the buffer. Image's alpha channel or mask is
+         * used if image has it. Parts of the image outside of the buffer are
+         * clipped.
+         *
+         * \param Image     The image to draw.
+         * \param Point     Top left point of the image in the buffer.
+         **/
+        void DrawImage(const wxImage& Image, const wxPoint& Point);
+
+        /**
+         * Copies whole buffer into 32-bit bitmap through wxAlphaPixelData.
+         * Bitmap is (re)created only if its size or depth differs.
+         *
+         * \param Bitmap    Receives content of the buffer.
+         **/
+        void CopyToBitmap(wxBitmap& Bitmap) const;
+
+        /**
+         * Exchanges pixels and size with another buffer without copying.
+         *
+         * \param Other     The buffer to exchange content with.
+         **/
+        void Swap(CPixelBuffer& Other);
+    private:
+        //! Pixels of the buffer.
+        std::vector<wxUint32> m_vPixels;
+
+        //! Size of the buffer.
+        wxSize m_Size;
+    };
+} // end namespace WinRuler
@@ -0,0 +1,447 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <wx/wx.h>
+#include "CRasterRenderBackend.h"
+#include "CRulerRenderer.h"
+
+namespace WinRuler
+{
+    CRasterRenderBackend::CRasterRenderBackend() :
+        m_pKernels(&GetPixelKernels()),
+        m_pDC(nullptr),
+        m_uPenColour(0xFF000000u),
+        m_uTextColour(0xFF000000u)
+    {
+        // No code.
+    }
+
+    void CRasterRenderBackend::SetKernelLevel(EPixelKernelLevel eLevel)
+    {
+        m_pKernels = &GetPixelKernels(eLevel);
+    }
+
+    const SPixelKernels& CRasterRenderBackend::GetKernels() const
+    {
+        return *m_pKernels;
+    }
+
+    void CRasterRenderBackend::ComposeSurface(
+        const wxRect& SurfaceRect, const SRulerRenderConfig& Config)
+    {
+        m_Surface.Resize(SurfaceRect.GetSize());
+        m_SurfaceOrigin = SurfaceRect.GetTopLeft();
+
+        SRasterSurfaceDesc Desc;
+        DescribeSurface(Config, 1.0, Desc);
+        ComposeSurface(m_Surface, Desc, *m_pKernels);
+    }
+
+    void CRasterRenderBackend::SetSurface(
+        CPixelBuffer& Surface, const wxPoint& Origin)
+    {
+        m_Surface.Swap(Surface);
+        m_SurfaceOrigin = Origin;
+    }
+
+    void CRasterRenderBackend::DescribeSurface(
+        const SRulerRenderConfig& Config, double dScale,
+        SRasterSurfaceDesc& Desc)
+    {
+        Desc.eRulerPosition = Config.eRulerPosition;
+        Desc.eRulerBackgroundType = Config.eRulerBackgroundType;
+        Desc.uBackgroundColour = PackPixel(Config.cRulerBackgroundColour);
+        Desc.uStartColour = PackPixel(Config.cRulerBackgroundStartColour);
+        Desc.uEndColour = PackPixel(Config.cRulerBackgroundEndColour);
+        Desc.uClearColour = PackPixel(Config.cClearColour);
+
+        if (Config.eRulerBackgroundType != ERulerBackgroundType::btImage)
+            return;
+
+        Desc.LeftH = ScaleImage(Config.RulerBackgroundBitmapLeftH, dScale);
+        Desc.MiddleH =
+            ScaleImage(Config.RulerBackgroundBitmapMiddleH, dScale);
+        Desc.RightH = ScaleImage(Config.RulerBackgroundBitmapRightH, dScale);
+        Desc.TopV = ScaleImage(Config.RulerBackgroundBitmapTopV, dScale);
+        Desc.MiddleV =
+            ScaleImage(Config.RulerBackgroundBitmapMiddleV, dScale);
+        Desc.BottomV =
+            ScaleImage(Config.RulerBackgroundBitmapBottomV, dScale);
+    }
+
+    void CRasterRenderBackend::ComposeSurface(
+        CPixelBuffer& Surface, const SRasterSurfaceDesc& Desc,
+        const SPixelKernels& Kernels)
+    {
+        wxSize Size = Surface.GetSize();
+        if ((Size.GetWidth() <= 0) || (Size.GetHeight() <= 0))
+            return;
+
+        bool bVertical =
+            (Desc.eRulerPosition == ERulerPosition::rpLeft) ||
+            (Desc.eRulerPosition == ERulerPosition::rpRight);
+
+        switch (Desc.eRulerBackgroundType)
+        {
+        // Ruler's background as solid.
+        case ERulerBackgroundType::btSolid:
+            FillRect(Kernels, Surface, wxRect(Size), Desc.uBackgroundColour);
+
+            break;
+        // Ruler's background as gradient. Start colour is at the scale's
+        // edge, like with wxDC::GradientFillLinear().
+        case ERulerBackgroundType::btGradient:
+        {
+            wxDirection eDirection = wxRIGHT;
+            switch (Desc.eRulerPosition)
+            {
+            case ERulerPosition::rpLeft:
+                eDirection = wxRIGHT;
+
+                break;
+            case ERulerPosition::rpTop:
+                eDirection = wxDOWN;
+
+                break;
+            case ERulerPosition::rpRight:
+                eDirection = wxLEFT;
+
+                break;
+            case ERulerPosition::rpBottom:
+                eDirection = wxUP;
+
+                break;
+            }
+
+            FillGradient(
+                Kernels, Surface, Desc.uStartColour, Desc.uEndColour,
+                eDirection);
+
+            break;
+        }
+        // Ruler's background as image. Parts are placed by the same helper
+        // as by CRulerRenderer::DrawBackgroundImage().
+        case ERulerBackgroundType::btImage:
+            FillRect(Kernels, Surface, wxRect(Size), Desc.uClearColour);
+
+            if (bVertical)
+            {
+                const wxImage* apParts[] =
+                    { &Desc.TopV, &Desc.MiddleV, &Desc.BottomV };
+
+                PlaceBackgroundImageParts(
+                    Size.GetHeight(), Desc.TopV.GetHeight(),
+                    Desc.MiddleV.GetHeight(), Desc.BottomV.GetHeight(),
+                    [&](EBackgroundImagePart ePart, int iOffset)
+                    {
+                        Surface.DrawImage(*apParts[ePart], wxPoint(0, iOffset));
+                    });
+            }
+            else
+            {
+                const wxImage* apParts[] =
+                    { &Desc.LeftH, &Desc.MiddleH, &Desc.RightH };
+
+                PlaceBackgroundImageParts(
+                    Size.GetWidth(), Desc.LeftH.GetWidth(),
+                    Desc.MiddleH.GetWidth(), Desc.RightH.GetWidth(),
+                    [&](EBackgroundImagePart ePart, int iOffset)
+                    {
+                        Surface.DrawImage(*apParts[ePart], wxPoint(iOffset, 0));
+                    });
+            }
+
+            // Image has its own outline.
+            return;
+        }
+
+        // Draw black outline around ruler.
+        const wxUint32 uBlack = 0xFF000000u;
+        FillRect(Kernels, Surface, wxRect(0, 0, Size.GetWidth(), 1), uBlack);
+        FillRect(
+            Kernels, Surface,
+            wxRect(0, Size.GetHeight() - 1, Size.GetWidth(), 1), uBlack);
+        FillRect(Kernels, Surface, wxRect(0, 0, 1, Size.GetHeight()), uBlack);
+        FillRect(
+            Kernels, Surface,
+            wxRect(Size.GetWidth() - 1, 0, 1, Size.GetHeight()), uBlack);
+    }
+
+    void CRasterRenderBackend::GetSurfaceBitmap(wxBitmap& Bitmap) const
+    {
+        m_Surface.CopyToBitmap(Bitmap);
+    }
+
+    bool CRasterRenderBackend::Begin(wxDC& dc)
+    {
+        End();
+
+        // Backend draws only over its own surface.
+        if (m_Surface.GetSize().GetWidth() <= 0 ||
+            m_Surface.GetSize().GetHeight() <= 0)
+            return false;
+
+        // Without clipping region, clipping box is the whole device
+        // context.
+        wxRect ClipBox;
+        dc.GetClippingBox(ClipBox);
+
+        m_FrameRect = wxRect(m_SurfaceOrigin, m_Surface.GetSize());
+        m_FrameRect.Intersect(ClipBox);
+
+        // Frame starts as copy of the surface.
+        if (!m_FrameRect.IsEmpty())
+            m_Frame.CopyFrom(
+                m_Surface,
+                wxRect(
+                    m_FrameRect.GetTopLeft() - m_SurfaceOrigin,
+                    m_FrameRect.GetSize()));
+
+        m_pDC = &dc;
+
+        return true;
+    }
+
+    void CRasterRenderBackend::End()
+    {
+        if (m_pDC == nullptr)
+            return;
+
+        // Whole frame is handed over with single bitmap draw.
+        if (!m_FrameRect.IsEmpty())
+        {
+            m_Frame.CopyToBitmap(m_FrameBitmap);
+            m_pDC->DrawBitmap(m_FrameBitmap, m_FrameRect.GetTopLeft(), false);
+        }
+
+        m_pDC = nullptr;
+    }
+
+    void CRasterRenderBackend::SetPen(const wxPen& Pen)
+    {
+        m_uPenColour = PackPixel(Pen.GetColour());
+    }
+
+    void CRasterRenderBackend::SetTextStyle(
+        const wxFont& Font, const wxColour& Colour)
+    {
+        // Cached masks are valid only for the font they were rasterised
+        // with.
+        if (!m_Font.IsOk() || (m_Font != Font))
+        {
+            m_Font = Font;
+            m_mCoverageMasks.clear();
+        }
+
+        m_uTextColour = PackPixel(Colour);
+    }
+
+    void CRasterRenderBackend::DrawLine(const SRenderLine& Line)
+    {
+        DrawLines(&Line, 1);
+    }
+
+    void CRasterRenderBackend::DrawLines(
+        const SRenderLine* pLines, size_t uCount)
+    {
+        for (size_t I = 0; I < uCount; I++)
+        {
+            const wxPoint& Start = pLines[I].Start;
+            const wxPoint& End = pLines[I].End;
+
+            // Line covers pixels from its start up to its end, end itself
+            // is excluded.
+            wxRect Rect;
+            if (Start.y == End.y)
+                Rect = wxRect(
+                    (Start.x <= End.x) ? Start.x : End.x + 1,
+                    Start.y,
+                    std::abs(End.x - Start.x),
+                    1);
+            else if (Start.x == End.x)
+                Rect = wxRect(
+                    Start.x,
+                    (Start.y <= End.y) ? Start.y : End.y + 1,
+                    1,
+                    std::abs(End.y - Start.y));
+            else
+                continue;
+
+            Rect.Offset(-m_FrameRect.GetX(), -m_FrameRect.GetY());
+            FillRect(*m_pKernels, m_Frame, Rect, m_uPenColour);
+        }
+    }
+
+    void CRasterRenderBackend::DrawText(
+        const wxString& Text, const wxPoint& Point)
+    {
+        const SCoverageMask& Mask = GetCoverageMask(Text);
+
+        // Clip mask to the frame.
+        wxPoint Origin = Point - m_FrameRect.GetTopLeft();
+        wxRect Rect(Origin, Mask.Size);
+        Rect.Intersect(wxRect(m_Frame.GetSize()));
+        if (Rect.IsEmpty())
+            return;
+
+        for (int Y = Rect.GetTop(); Y <= Rect.GetBottom(); Y++)
+        {
+            const wxByte* pCoverage =
+                Mask.vCoverage.data() +
+                (static_cast<size_t>(Y - Origin.y) *
+                    static_cast<size_t>(Mask.Size.GetWidth())) +
+                static_cast<size_t>(Rect.GetLeft() - Origin.x);
+
+            m_pKernels->pBlendCoverageSpan(
+                m_Frame.GetRow(Y) + Rect.GetLeft(), pCoverage,
+                static_cast<size_t>(Rect.GetWidth()), m_uTextColour);
+        }
+    }
+
+    void CRasterRenderBackend::DrawBitmap(
+        const wxBitmap& Bitmap, const wxPoint& Point, bool bUseMask)
+    {
+        // Bitmaps are not drawn by ruler's scale in this backend, so
+        // conversion to image on every call is acceptable.
+        wxImage Image = Bitmap.ConvertToImage();
+        if (!bUseMask)
+            Image.SetMask(false);
+
+        m_Frame.DrawImage(Image, Point - m_FrameRect.GetTopLeft());
+    }
+
+    const wxChar* CRasterRenderBackend::GetName() const
+    {
+        return wxT("Software");
+    }
+
+    void CRasterRenderBackend::FillRect(
+        const SPixelKernels& Kernels, CPixelBuffer& Buffer,
+        const wxRect& Rect, wxUint32 uColour)
+    {
+        wxRect Clipped(Rect);
+        Clipped.Intersect(wxRect(Buffer.GetSize()));
+        if (Clipped.IsEmpty())
+            return;
+
+        for (int Y = Clipped.GetTop(); Y <= Clipped.GetBottom(); Y++)
+            Kernels.pFillSpan(
+                Buffer.GetRow(Y) + Clipped.GetLeft(),
+                static_cast<size_t>(Clipped.GetWidth()), uColour);
+    }
+
+    void CRasterRenderBackend::FillGradient(
+        const SPixelKernels& Kernels, CPixelBuffer& Buffer,
+        wxUint32 uStart, wxUint32 uEnd, wxDirection eDirection)
+    {
+        int iWidth = Buffer.GetSize().GetWidth();
+        int iHeight = Buffer.GetSize().GetHeight();
+
+        switch (eDirection)
+        {
+        case wxRIGHT:
+        case wxLEFT:
+        {
+            if (eDirection == wxLEFT)
+                std::swap(uStart, uEnd);
+
+            // All rows are the same, so the first one is rasterised and
+            // copied to the others.
+            wxUint32* pFirst = Buffer.GetRow(0);
+            Kernels.pFillGradientSpan(
+                pFirst, static_cast<size_t>(iWidth), uStart, uEnd, 0,
+                static_cast<size_t>(iWidth));
+
+            for (int Y = 1; Y < iHeight; Y++)
+                std::copy(pFirst, pFirst + iWidth, Buffer.GetRow(Y));
+
+            break;
+        }
+        case wxDOWN:
+        case wxUP:
+            // Every row has one colour.
+            for (int Y = 0; Y < iHeight; Y++)
+            {
+                size_t Index = static_cast<size_t>(
+                    (eDirection == wxDOWN) ? Y : iHeight - 1 - Y);
+
+                Kernels.pFillSpan(
+                    Buffer.GetRow(Y), static_cast<size_t>(iWidth),
+                    GetGradientPixel(
+                        uStart, uEnd, Index, static_cast<size_t>(iHeight)));
+            }
+
+            break;
+        default:
+            break;
+        }
+    }
+
+    wxImage CRasterRenderBackend::ScaleImage(
+        const wxBitmap& Bitmap, double dScale)
+    {
+        if (!Bitmap.IsOk())
+            return wxImage();
+
+        wxImage Image = Bitmap.ConvertToImage();
+        if (dScale == 1.0)
+            return Image;
+
+        int iWidth = std::max(
+            1, static_cast<int>(std::lround(Image.GetWidth() * dScale)));
+        int iHeight = std::max(
+            1, static_cast<int>(std::lround(Image.GetHeight() * dScale)));
+
+        return Image.Scale(iWidth, iHeight, wxIMAGE_QUALITY_HIGH);
+    }
+
+    const SCoverageMask& CRasterRenderBackend::GetCoverageMask(
+        const wxString& Text)
+    {
+        auto It = m_mCoverageMasks.find(Text);
+        if (It != m_mCoverageMasks.end())
+            return It->second;
+
+        SCoverageMask& Mask = m_mCoverageMasks[Text];
+
+        // Let the toolkit draw white text on black background once, its
+        // brightness is the coverage.
+        wxMemoryDC MemoryDC;
+        MemoryDC.SetFont(m_Font);
+
+        wxCoord TextWidth, TextHeight;
+        MemoryDC.GetTextExtent(Text, &TextWidth, &TextHeight);
+        if ((TextWidth <= 0) || (TextHeight <= 0))
+            return Mask;
+
+        wxBitmap Bitmap(TextWidth, TextHeight, 24);
+        MemoryDC.SelectObject(Bitmap);
+        MemoryDC.SetBackground(*wxBLACK_BRUSH);
+        MemoryDC.Clear();
+        MemoryDC.SetTextForeground(*wxWHITE);
+        MemoryDC.DrawText(Text, 0, 0);
+        MemoryDC.SelectObject(wxNullBitmap);
+
+        wxImage Image = Bitmap.ConvertToImage();
+        const unsigned char* pRGB = Image.GetData();
+
+        Mask.Size = wxSize(TextWidth, TextHeight);
+        Mask.vCoverage.resize(
+            static_cast<size_t>(TextWidth) * static_cast<size_t>(TextHeight));
+
+        // With subpixel antialiasing channels differ, the brightest one is
+        // used.
+        for (size_t I = 0; I < Mask.vCoverage.size(); I++)
+            Mask.vCoverage[I] =
+                std::max(
+                    pRGB[(I * 3) + 0],
+                    std::max(pRGB[(I * 3) + 1], pRGB[(I * 3) + 2]));
+
+        return Mask;
+    }
+} // end namespace WinRuler
@@ -0,0 +1,249 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "WRPixelKernels.h"
+#include "CRenderBackend.h"
+#include "CPixelBuffer.h"
+
+namespace WinRuler
+{
+    struct SRulerRenderConfig;
+
+    /**
+     * Text rasterised once into 8-bit coverage mask.
+     **/
+    struct SCoverageMask
+    {
+        //! Size of the mask.
+        wxSize Size;
+
+        //! Coverage of every pixel of the mask, row by row.
+        std::vector<wxByte> vCoverage;
+    };
+
+    /**
+     * Description of the ruler's surface for the rasteriser. It does not
+     * reference any GDI object and its images are not shared with any other
+     * image, so surface can be composed from it on any thread.
+     **/
+    struct SRasterSurfaceDesc
+    {
+        //! Position of the ruler's scale.
+        ERulerPosition eRulerPosition;
+
+        //! Type of the ruler's background.
+        ERulerBackgroundType eRulerBackgroundType;
+
+        //! Packed colour of the ruler's background (btSolid only).
+        wxUint32 uBackgroundColour;
+
+        //! Packed start and end colours of the ruler's background
+        //! (btGradient only).
+        wxUint32 uStartColour;
+        wxUint32 uEndColour;
+
+        //! Packed colour behind the ruler's surface.
+        wxUint32 uClearColour;
+
+        //! Parts of the ruler's background image (btImage only), already
+        //! scaled for the surface.
+        wxImage LeftH;
+        wxImage MiddleH;
+        wxImage RightH;
+        wxImage TopV;
+        wxImage MiddleV;
+        wxImage BottomV;
+    };
+
+    /**
+     * CRasterRenderBackend class definition. Software backend which
+     * rasterises ruler into its own 32-bit pixel buffer with SIMD kernels
+     * (fills, gradients and text coverage) selected at runtime. It composes
+     * ruler's surface itself, so it draws only over ruler's surface: Begin()
+     * starts with copy of the surface in clipping box of the device context
+     * and End() hands the result to the device context with single bitmap
+     * draw. Lines must be horizontal or vertical and they are 1 pixel wide.
+     **/
+    class CRasterRenderBackend :
+        public CRenderBackend
+    {
+    public:
+        /**
+         * Default constructor. It selects the best kernels supported by CPU.
+         **/
+        CRasterRenderBackend();
+
+        /**
+         * Selects pixel kernels. If instruction set is not supported, the
+         * best supported one is used instead.
+         *
+         * \param eLevel    Requested instruction set.
+         **/
+        void SetKernelLevel(EPixelKernelLevel eLevel);
+
+        /**
+         * Returns currently used pixel kernels.
+         **/
+        const SPixelKernels& GetKernels() const;
+
+        /**
+         * Composes ruler's surface (background and outline) into surface
+         * buffer. It is used by all following Begin() calls.
+         *
+         * \param SurfaceRect   The rectangle of ruler's surface in device
+         *                      coordinates.
+         * \param Config        The ruler's appearance.
+         **/
+        void ComposeSurface(
+            const wxRect& SurfaceRect, const SRulerRenderConfig& Config);
+
+        /**
+         * Takes over surface composed elsewhere (e.g. by worker thread)
+         * instead of composing it. Content of specified buffer is exchanged
+         * with the old surface.
+         *
+         * \param Surface   The composed surface.
+         * \param Origin    Top left point of the ruler's surface in device
+         *                  coordinates.
+         **/
+        void SetSurface(CPixelBuffer& Surface, const wxPoint& Origin);
+
+        /**
+         * Describes ruler's surface for ComposeSurface(). It must be called
+         * on the main thread, because background image parts are converted
+         * from bitmaps.
+         *
+         * \param Config    The ruler's appearance.
+         * \param dScale    Scale factor of background image parts.
+         * \param Desc      Receives description of the surface.
+         **/
+        static void DescribeSurface(
+            const SRulerRenderConfig& Config, double dScale,
+            SRasterSurfaceDesc& Desc);
+
+        /**
+         * Composes ruler's surface (background and outline) described by
+         * DescribeSurface() into buffer. It uses only the buffer, the
+         * description and the kernels, so it can run on any thread.
+         *
+         * \param Surface   The buffer to compose in. It must already have
+         *                  size of the surface.
+         * \param Desc      Description of the surface.
+         * \param Kernels   Pixel kernels used for drawing.
+         **/
+        static void ComposeSurface(
+            CPixelBuffer& Surface, const SRasterSurfaceDesc& Desc,
+            const SPixelKernels& Kernels);
+
+        /**
+         * Copies composed surface into bitmap.
+         *
+         * \param Bitmap    Receives the surface.
+         **/
+        void GetSurfaceBitmap(wxBitmap& Bitmap) const;
+
+        // Implementation of CRenderBackend interface, see its documentation.
+        // Begin() fails if surface was not composed yet.
+        bool Begin(wxDC& dc) override;
+        void End() override;
+        void SetPen(const wxPen& Pen) override;
+        void SetTextStyle(
+            const wxFont& Font, const wxColour& Colour) override;
+        void DrawLine(const SRenderLine& Line) override;
+        void DrawLines(const SRenderLine* pLines, size_t uCount) override;
+        void DrawText(const wxString& Text, const wxPoint& Point) override;
+        void DrawBitmap(
+            const wxBitmap& Bitmap, const wxPoint& Point,
+            bool bUseMask) override;
+        const wxChar* GetName() const override;
+    private:
+        /**
+         * Fills rectangle of the buffer with solid colour. Rectangle is
+         * clipped to the buffer.
+         *
+         * \param Kernels   Pixel kernels used for drawing.
+         * \param Buffer    The buffer to draw on.
+         * \param Rect      The rectangle in buffer's coordinates.
+         * \param uColour   The colour.
+         **/
+        static void FillRect(
+            const SPixelKernels& Kernels, CPixelBuffer& Buffer,
+            const wxRect& Rect, wxUint32 uColour);
+
+        /**
+         * Fills whole buffer with linear gradient.
+         *
+         * \param Kernels       Pixel kernels used for drawing.
+         * \param Buffer        The buffer to draw on.
+         * \param uStart        The start colour of the gradient.
+         * \param uEnd          The end colour of the gradient.
+         * \param eDirection    Direction from start to end colour (wxRIGHT,
+         *                      wxDOWN, wxLEFT or wxUP).
+         **/
+        static void FillGradient(
+            const SPixelKernels& Kernels, CPixelBuffer& Buffer,
+            wxUint32 uStart, wxUint32 uEnd, wxDirection eDirection);
+
+        /**
+         * Converts part of background image to image and scales it.
+         *
+         * \param Bitmap    The part of background image.
+         * \param dScale    The scale factor.
+         *
+         * \return  Returns converted image, not shared with any other one.
+         **/
+        static wxImage ScaleImage(const wxBitmap& Bitmap, double dScale);
+
+        /**
+         * Returns coverage mask of the text drawn with current font. Mask
+         * is rasterised by the toolkit on the first use of the text and
+         * cached until font changes.
+         *
+         * \param Text  The text.
+         *
+         * \return  Returns reference to cached mask.
+         **/
+        const SCoverageMask& GetCoverageMask(const wxString& Text);
+    private:
+        //! Pixel kernels used for drawing.
+        const SPixelKernels* m_pKernels;
+
+        //! Composed ruler's surface.
+        CPixelBuffer m_Surface;
+
+        //! Top left point of the ruler's surface in device coordinates.
+        wxPoint m_SurfaceOrigin;
+
+        //! Frame buffer which covers m_FrameRect.
+        CPixelBuffer m_Frame;
+
+        //! Rectangle covered by frame buffer in device coordinates.
+        wxRect m_FrameRect;
+
+        //! Bitmap used for hand over of frame buffer to device context.
+        wxBitmap m_FrameBitmap;
+
+        //! Device context bound by Begin().
+        wxDC* m_pDC;
+
+        //! Colour of lines.
+        wxUint32 m_uPenColour;
+
+        //! Colour of text.
+        wxUint32 m_uTextColour;
+
+        //! Font of text.
+        wxFont m_Font;
+
+        //! Cached coverage masks of texts drawn with m_Font.
+        std::map<wxString, SCoverageMask> m_mCoverageMasks;
+    };
+} // end namespace WinRuler
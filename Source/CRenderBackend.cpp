@@ -0,0 +1,50 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <wx/wx.h>
+#include <wx/graphics.h>
+#include "CRenderBackend.h"
+
+namespace WinRuler
+{
+    CRenderBackend::~CRenderBackend()
+    {
+        // No code.
+    }
+
+    void CRenderBackend::StrokeLines(
+        wxGraphicsContext& Context,
+        const SRenderLine* pLines, size_t uCount,
+        std::vector<wxPoint2DDouble>& vBegins,
+        std::vector<wxPoint2DDouble>& vEnds)
+    {
+        if (uCount == 0)
+            return;
+
+        vBegins.resize(uCount);
+        vEnds.resize(uCount);
+
+        // Lines moved to pixel centres stay sharp even with antialiasing.
+        for (size_t I = 0; I < uCount; I++)
+        {
+            const wxPoint& Start = pLines[I].Start;
+            const wxPoint& End = pLines[I].End;
+
+            if (Start.y == End.y)
+            {
+                vBegins[I] = wxPoint2DDouble(Start.x, Start.y + 0.5);
+                vEnds[I] = wxPoint2DDouble(End.x, End.y + 0.5);
+            }
+            else
+            {
+                vBegins[I] = wxPoint2DDouble(Start.x + 0.5, Start.y);
+                vEnds[I] = wxPoint2DDouble(End.x + 0.5, End.y);
+            }
+        }
+
+        // Submit all lines as one path.
+        Context.StrokeLines(uCount, vBegins.data(), vEnds.data());
+    }
+} // end namespace WinRuler
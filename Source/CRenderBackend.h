@@ -0,0 +1,131 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include <wx/graphics.h>
+
+namespace WinRuler
+{
+    /**
+     * Single line ready to draw, for example tick of the ruler's scale. Line
+     * covers pixels from Start up to End, End itself is excluded.
+     **/
+    struct SRenderLine
+    {
+        //! Start point of the line.
+        wxPoint Start;
+
+        //! End point of the line.
+        wxPoint End;
+    };
+
+    /**
+     * CRenderBackend class definition. It is interface of graphics backend
+     * used by CRulerRenderer. Backend is bound to device context by Begin()
+     * and all drawing goes through it until End() is called. State (pen,
+     * font and text colour) is set explicitly, backend does not read it from
+     * the device context.
+     **/
+    class CRenderBackend
+    {
+    public:
+        /**
+         * Virtual destructor.
+         **/
+        virtual ~CRenderBackend();
+
+        /**
+         * Binds backend to the device context. Clipping region of the
+         * device context is respected.
+         *
+         * \param dc    The device context to draw on.
+         *
+         * \return  Returns true if backend can draw on the device context,
+         *          otherwise false.
+         **/
+        virtual bool Begin(wxDC& dc) = 0;
+
+        /**
+         * Finishes drawing and releases the device context.
+         **/
+        virtual void End() = 0;
+
+        /**
+         * Sets pen used for lines.
+         *
+         * \param Pen   The pen.
+         **/
+        virtual void SetPen(const wxPen& Pen) = 0;
+
+        /**
+         * Sets font and colour used for text.
+         *
+         * \param Font      The font.
+         * \param Colour    The colour of the text.
+         **/
+        virtual void SetTextStyle(
+            const wxFont& Font, const wxColour& Colour) = 0;
+
+        /**
+         * Draws single line.
+         *
+         * \param Line  The line to draw.
+         **/
+        virtual void DrawLine(const SRenderLine& Line) = 0;
+
+        /**
+         * Draws many lines. Backend may submit all of them in one batch.
+         *
+         * \param pLines    Array of lines.
+         * \param uCount    Number of lines in the array.
+         **/
+        virtual void DrawLines(const SRenderLine* pLines, size_t uCount) = 0;
+
+        /**
+         * Draws text.
+         *
+         * \param Text      The text to draw.
+         * \param Point     Top left point of the text.
+         **/
+        virtual void DrawText(const wxString& Text, const wxPoint& Point) = 0;
+
+        /**
+         * Draws bitmap in its natural size.
+         *
+         * \param Bitmap    The bitmap to draw.
+         * \param Point     Top left point of the bitmap.
+         * \param bUseMask  If true, bitmap's mask or alpha is used.
+         **/
+        virtual void DrawBitmap(
+            const wxBitmap& Bitmap, const wxPoint& Point, bool bUseMask) = 0;
+
+        /**
+         * Returns human readable name of the backend.
+         **/
+        virtual const wxChar* GetName() const = 0;
+    protected:
+        /**
+         * Strokes many lines through graphics context as one path. Lines
+         * are horizontal or vertical, so they are moved by half of pixel
+         * across their direction and hit pixel centres. Scratch buffers keep
+         * their capacity, so only the first batches allocate.
+         *
+         * \param Context   The graphics context to stroke lines with. Its
+         *                  pen must be already set.
+         * \param pLines    Array of lines.
+         * \param uCount    Number of lines in the array.
+         * \param vBegins   Scratch buffer for start points of lines.
+         * \param vEnds     Scratch buffer for end points of lines.
+         **/
+        static void StrokeLines(
+            wxGraphicsContext& Context,
+            const SRenderLine* pLines, size_t uCount,
+            std::vector<wxPoint2DDouble>& vBegins,
+            std::vector<wxPoint2DDouble>& vEnds);
+    };
+} // end namespace WinRuler
@@ -0,0 +1,749 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cstring>
+#include <algorithm>
+#include <wx/wx.h>
+#include <wx/stopwatch.h>
+#include "CRenderBenchmark.h"
+#include "CFrameCompositor.h"
+#include "CDCRenderBackend.h"
+#include "WRRulerUnits.h"
+#include "WRAllocationCounter.h"
+#include "WRPixelKernels.h"
+#include "WRConversionKernels.h"
+
+namespace WinRuler
+{
+    CRenderBenchmark::CRenderBenchmark(unsigned int uIterations) :
+        m_uIterations(uIterations)
+    {
+        // No code.
+    }
+
+    void CRenderBenchmark::Run(SRulerRenderConfig Config)
+    {
+        static const ERulerPosition Positions[] =
+        {
+            ERulerPosition::rpLeft,
+            ERulerPosition::rpTop,
+            ERulerPosition::rpRight,
+            ERulerPosition::rpBottom
+        };
+        static const wxChar* PositionNames[] =
+            { wxT("left"), wxT("top"), wxT("right"), wxT("bottom") };
+        static const ERulerBackgroundType Backgrounds[] =
+        {
+            ERulerBackgroundType::btSolid,
+            ERulerBackgroundType::btGradient,
+            ERulerBackgroundType::btImage
+        };
+        static const wxChar* BackgroundNames[] =
+            { wxT("solid"), wxT("gradient"), wxT("image") };
+        static const int Lengths[] = { 200, 800, 2000 };
+
+        // Image background can not be drawn without image.
+        if (!Config.RulerBackgroundBitmapLeftH.IsOk() ||
+            !Config.RulerBackgroundBitmapTopV.IsOk())
+            SetSyntheticBackgroundImage(Config);
+
+        // Nothing to measure.
+        if (m_uIterations == 0)
+            return;
+
+        std::vector<double> vSurface, vScale, vMarkers;
+        vSurface.reserve(m_uIterations);
+        vScale.reserve(m_uIterations);
+        vMarkers.reserve(m_uIterations);
+
+        wxLogMessage(
+            "Render benchmark suite: %u frames per measurement, latency "
+            "p50/p90/p99/max in us.", m_uIterations);
+
+        for (size_t P = 0; P < WXSIZEOF(Positions); P++)
+        for (size_t L = 0; L < WXSIZEOF(Lengths); L++)
+        {
+            // Prepare off-screen surface of the ruler with thickness of its
+            // metrics.
+            bool bVertical =
+                (Positions[P] == ERulerPosition::rpLeft) ||
+                (Positions[P] == ERulerPosition::rpRight);
+            wxSize SurfaceSize =
+                bVertical ?
+                    wxSize(Config.Metrics.iThickness, Lengths[L]) :
+                    wxSize(Lengths[L], Config.Metrics.iThickness);
+            wxRect SurfaceRect(SurfaceSize);
+            wxBitmap Surface(SurfaceSize);
+            wxMemoryDC MemoryDC(Surface);
+
+            Config.eRulerPosition = Positions[P];
+
+            for (int U = 0; U < ERulerUnits::ruCount; U++)
+            for (size_t B = 0; B < WXSIZEOF(Backgrounds); B++)
+            {
+                Config.eRulerUnits = static_cast<ERulerUnits>(U);
+                Config.eRulerBackgroundType = Backgrounds[B];
+
+                // Every combination starts with empty caches, first frame
+                // warms them up and is not measured.
+                CRulerRenderer Renderer;
+                Config.iFirstMarkerPosition = 0;
+                Config.iSecondMarkerPosition = Lengths[L] / 2;
+                Renderer.Render(MemoryDC, SurfaceRect, Config);
+
+                vSurface.clear();
+                vScale.clear();
+                vMarkers.clear();
+
+                wxStopWatch StopWatch;
+                for (unsigned int I = 0; I < m_uIterations; I++)
+                {
+                    // Markers move on every frame like during dragging.
+                    Config.iFirstMarkerPosition =
+                        static_cast<int>((I * 7) % Lengths[L]);
+                    Config.iSecondMarkerPosition =
+                        static_cast<int>((I * 13) % Lengths[L]);
+
+                    // Surface and scale are measured as full rebuild of the
+                    // static layer, so their caches are invalidated on every
+                    // frame.
+                    Renderer.InvalidateSurface();
+                    StopWatch.Start();
+                    Renderer.DrawSurface(MemoryDC, SurfaceRect, Config);
+                    vSurface.push_back(StopWatch.TimeInMicro().ToDouble());
+
+                    Renderer.InvalidateScale();
+                    StopWatch.Start();
+                    Renderer.DrawScale(MemoryDC, SurfaceRect, Config);
+                    vScale.push_back(StopWatch.TimeInMicro().ToDouble());
+
+                    StopWatch.Start();
+                    Renderer.DrawMarkers(MemoryDC, SurfaceRect, Config);
+                    vMarkers.push_back(StopWatch.TimeInMicro().ToDouble());
+                }
+
+                SRenderLatency SurfaceLatency = ComputeLatency(vSurface);
+                SRenderLatency ScaleLatency = ComputeLatency(vScale);
+                SRenderLatency MarkersLatency = ComputeLatency(vMarkers);
+
+                wxLogMessage(
+                    "%s %s %s %d px: "
+                    "surface %.1f/%.1f/%.1f/%.1f, "
+                    "scale %.1f/%.1f/%.1f/%.1f, "
+                    "markers %.1f/%.1f/%.1f/%.1f",
+                    PositionNames[P],
+                    GetRulerUnitDesc(Config.eRulerUnits).pszSymbol,
+                    BackgroundNames[B], Lengths[L],
+                    SurfaceLatency.P50, SurfaceLatency.P90,
+                    SurfaceLatency.P99, SurfaceLatency.Max,
+                    ScaleLatency.P50, ScaleLatency.P90,
+                    ScaleLatency.P99, ScaleLatency.Max,
+                    MarkersLatency.P50, MarkersLatency.P90,
+                    MarkersLatency.P99, MarkersLatency.Max);
+            }
+
+            MemoryDC.SelectObject(wxNullBitmap);
+        }
+    }
+
+    void CRenderBenchmark::RunBackends(SRulerRenderConfig Config, int iLength)
+    {
+        static const ERulerPosition Positions[] =
+        {
+            ERulerPosition::rpLeft,
+            ERulerPosition::rpTop,
+            ERulerPosition::rpRight,
+            ERulerPosition::rpBottom
+        };
+        static const wxChar* PositionNames[] =
+            { wxT("left"), wxT("top"), wxT("right"), wxT("bottom") };
+
+        // Nothing to measure.
+        if ((iLength <= 0) || (m_uIterations == 0))
+            return;
+
+        // Image background can not be drawn without image.
+        if (!Config.RulerBackgroundBitmapLeftH.IsOk() ||
+            !Config.RulerBackgroundBitmapTopV.IsOk())
+            SetSyntheticBackgroundImage(Config);
+
+        wxLogMessage(
+            "Backend benchmark: %d px, %u frames per measurement, average "
+            "frame time in us.", iLength, m_uIterations);
+
+        for (size_t P = 0; P < WXSIZEOF(Positions); P++)
+        {
+            // Prepare off-screen surface of the ruler with thickness of its
+            // metrics.
+            bool bVertical =
+                (Positions[P] == ERulerPosition::rpLeft) ||
+                (Positions[P] == ERulerPosition::rpRight);
+            wxSize SurfaceSize =
+                bVertical ?
+                    wxSize(Config.Metrics.iThickness, iLength) :
+                    wxSize(iLength, Config.Metrics.iThickness);
+            wxRect SurfaceRect(SurfaceSize);
+            wxBitmap Surface(SurfaceSize);
+            wxMemoryDC MemoryDC(Surface);
+
+            Config.eRulerPosition = Positions[P];
+            Config.iFirstMarkerPosition = iLength / 3;
+            Config.iSecondMarkerPosition = (iLength * 2) / 3;
+
+            for (int U = 0; U < ERulerUnits::ruCount; U++)
+            {
+                Config.eRulerUnits = static_cast<ERulerUnits>(U);
+
+                Config.eRenderBackend = ERenderBackend::rbDC;
+                double DC = MeasureFrames(MemoryDC, SurfaceRect, Config);
+
+                Config.eRenderBackend = ERenderBackend::rbGraphicsContext;
+                double GC = MeasureFrames(MemoryDC, SurfaceRect, Config);
+
+                Config.eRenderBackend = ERenderBackend::rbSoftware;
+                double SW = MeasureFrames(MemoryDC, SurfaceRect, Config);
+
+                wxLogMessage(
+                    "%s %s: wxDC %.1f, wxGraphicsContext %.1f (%.2fx), "
+                    "software %.1f (%.2fx).",
+                    PositionNames[P],
+                    GetRulerUnitDesc(Config.eRulerUnits).pszSymbol, DC, GC,
+                    (GC > 0.0) ? DC / GC : 0.0, SW,
+                    (SW > 0.0) ? DC / SW : 0.0);
+            }
+
+            MemoryDC.SelectObject(wxNullBitmap);
+        }
+    }
+
+    void CRenderBenchmark::RunTickSubmission(
+        const SRulerRenderConfig& Config, int iLength)
+    {
+        // Nothing to measure.
+        if ((iLength <= 0) || (m_uIterations == 0))
+            return;
+
+        // Prepare off-screen surface of horizontal ruler with thickness of
+        // its metrics.
+        wxSize SurfaceSize(iLength, Config.Metrics.iThickness);
+        wxRect SurfaceRect(SurfaceSize);
+        wxBitmap Surface(SurfaceSize);
+        wxMemoryDC MemoryDC(Surface);
+
+        // Labels are measured with the same font as renderer uses.
+        CRulerRenderer Renderer;
+        Renderer.Render(MemoryDC, SurfaceRect, Config);
+        MemoryDC.SetFont(Renderer.GetFont());
+
+        CRulerLabelCache LabelCache;
+        LabelCache.SetFont(Renderer.GetFont());
+        CUnitLookupTable LookupTable;
+        wxPen Pen(Config.cRulerScaleColour, 1, wxPENSTYLE_SOLID);
+
+        wxLogMessage(
+            "Tick submission benchmark: %d px, %u frames per measurement, "
+            "average frame time in us.", iLength, m_uIterations);
+
+        for (int U = 0; U < ERulerUnits::ruCount; U++)
+        {
+            // Build layout for current unit of measurement.
+            CRulerScaleLayout Layout;
+            Layout.Update(
+                MemoryDC, LabelCache, LookupTable, SurfaceRect,
+                ERulerPosition::rpTop, static_cast<ERulerUnits>(U),
+                Config.PixelPerInch, Config.Metrics);
+
+            // Measure both ways of ticks' submission.
+            double PerTick = MeasureTicks(MemoryDC, Layout, Pen, false);
+            double Batched = MeasureTicks(MemoryDC, Layout, Pen, true);
+
+            wxLogMessage(
+                "%s: %lu ticks, per-tick %.1f, batched %.1f (%.2fx).",
+                GetRulerUnitDesc(static_cast<ERulerUnits>(U)).pszSymbol,
+                static_cast<unsigned long>(Layout.GetTickCount()),
+                PerTick, Batched,
+                (Batched > 0.0) ? PerTick / Batched : 0.0);
+        }
+
+        MemoryDC.SelectObject(wxNullBitmap);
+    }
+
+    void CRenderBenchmark::RunPixelKernels(int iLength)
+    {
+        // Spans are filled row by row like surface of horizontal ruler with
+        // default thickness.
+        static const int Thickness = 60;
+
+        // Nothing to measure.
+        if ((iLength <= 0) || (m_uIterations == 0))
+            return;
+
+        size_t uCount = static_cast<size_t>(iLength);
+        std::vector<wxUint32> vPixels(uCount);
+        std::vector<wxByte> vCoverage(uCount);
+
+        // Coverage of text: mostly partial, with gaps between glyphs.
+        for (size_t I = 0; I < uCount; I++)
+            vCoverage[I] =
+                ((I % 8) < 2) ? 0 : static_cast<wxByte>((I * 37) & 0xFF);
+
+        wxLogMessage(
+            "Pixel kernel benchmark: %d px spans, %u iterations, throughput "
+            "in Mpx/s.", iLength, m_uIterations);
+
+        for (int L = EPixelKernelLevel::pkScalar;
+            L <= GetSupportedPixelKernelLevel(); L++)
+        {
+            const SPixelKernels& Kernels =
+                GetPixelKernels(static_cast<EPixelKernelLevel>(L));
+
+            // Returns throughput of the kernel in pixels per microsecond.
+            auto Measure = [&](auto Kernel)
+            {
+                wxStopWatch StopWatch;
+                for (unsigned int I = 0; I < m_uIterations; I++)
+                    for (int Row = 0; Row < Thickness; Row++)
+                        Kernel(Row);
+
+                double dPixels =
+                    static_cast<double>(uCount) * Thickness * m_uIterations;
+
+                return dPixels /
+                    std::max(StopWatch.TimeInMicro().ToDouble(), 1.0);
+            };
+
+            double Fill = Measure(
+                [&](int Row)
+                {
+                    Kernels.pFillSpan(
+                        vPixels.data(), uCount,
+                        0xFF000000u | static_cast<wxUint32>(Row));
+                });
+            double Gradient = Measure(
+                [&](int Row)
+                {
+                    Kernels.pFillGradientSpan(
+                        vPixels.data(), uCount, 0xFFFFC477u,
+                        0xFFFF8E3Du | static_cast<wxUint32>(Row), 0, uCount);
+                });
+            double Blend = Measure(
+                [&](int WXUNUSED(Row))
+                {
+                    Kernels.pBlendCoverageSpan(
+                        vPixels.data(), vCoverage.data(), uCount,
+                        0xFF000000u);
+                });
+
+            wxLogMessage(
+                "%s: fill %.0f, gradient %.0f, text blend %.0f.",
+                Kernels.Name, Fill, Gradient, Blend);
+        }
+    }
+
+    bool CRenderBenchmark::RunConversionKernels(int iLength)
+    {
+        // Nothing to measure.
+        if ((iLength <= 0) || (m_uIterations == 0))
+            return true;
+
+        size_t uCount = static_cast<size_t>(iLength);
+        std::vector<int> vPixels(uCount), vPixelResults(uCount);
+        std::vector<int> vReferencePixels(uCount), vExpectedPixels(uCount);
+        std::vector<double> vUnits(uCount), vReferenceUnits(uCount);
+        std::vector<double> vExpectedUnits(uCount);
+        double PixelPerInch = GetPixelPerInch(0).x;
+        bool bIdentical = true;
+
+        // Every pixel offset along the ruler.
+        for (size_t I = 0; I < uCount; I++)
+            vPixels[I] = static_cast<int>(I);
+
+        // Returns throughput of the conversion in values per microsecond.
+        auto Measure = [&](auto Conversion)
+        {
+            wxStopWatch StopWatch;
+            for (unsigned int I = 0; I < m_uIterations; I++)
+                Conversion();
+
+            double dValues = static_cast<double>(uCount) * m_uIterations;
+
+            return dValues /
+                std::max(StopWatch.TimeInMicro().ToDouble(), 1.0);
+        };
+
+        wxLogMessage(
+            "Unit conversion benchmark: %d values, %u iterations, "
+            "throughput in Mvalues/s.", iLength, m_uIterations);
+
+        // Existing routines convert one value per call.
+        double ToUnits = Measure(
+            [&]()
+            {
+                for (size_t I = 0; I < uCount; I++)
+                    vReferenceUnits[I] =
+                        PixelsToCentimetresHorizontal(0, vPixels[I]);
+            });
+        double ToPixels = Measure(
+            [&]()
+            {
+                for (size_t I = 0; I < uCount; I++)
+                    vReferencePixels[I] =
+                        CentimetresToPixelsHorizontal(
+                            0, vReferenceUnits[I]);
+            });
+
+        wxLogMessage(
+            "single value routines: to units %.0f, to pixels %.0f.",
+            ToUnits, ToPixels);
+
+        for (int L = EPixelKernelLevel::pkScalar;
+            L <= GetSupportedPixelKernelLevel(); L++)
+        {
+            EPixelKernelLevel eLevel = static_cast<EPixelKernelLevel>(L);
+            const SRulerUnitDesc& Desc =
+                GetRulerUnitDesc(ERulerUnits::ruCentimetres);
+
+            ToUnits = Measure(
+                [&]()
+                {
+                    ConvertPixelSpanToUnits(
+                        Desc, PixelPerInch, vPixels.data(), vUnits.data(),
+                        uCount, eLevel);
+                });
+            ToPixels = Measure(
+                [&]()
+                {
+                    ConvertUnitSpanToPixels(
+                        Desc, PixelPerInch, vReferenceUnits.data(),
+                        vPixelResults.data(), uCount, eLevel);
+                });
+
+            // Results must be bit-identical to single value conversions of
+            // every unit of measurement.
+            bool bLevelIdentical = true;
+            for (int U = 0; U < ERulerUnits::ruCount; U++)
+            {
+                const SRulerUnitDesc& UnitDesc =
+                    GetRulerUnitDesc(static_cast<ERulerUnits>(U));
+
+                for (size_t I = 0; I < uCount; I++)
+                {
+                    vExpectedUnits[I] =
+                        ConvertPixelsToUnits(
+                            UnitDesc, PixelPerInch, vPixels[I]);
+                    vExpectedPixels[I] =
+                        ConvertUnitsToPixels(
+                            UnitDesc, PixelPerInch, vExpectedUnits[I]);
+                }
+
+                ConvertPixelSpanToUnits(
+                    UnitDesc, PixelPerInch, vPixels.data(), vUnits.data(),
+                    uCount, eLevel);
+                ConvertUnitSpanToPixels(
+                    UnitDesc, PixelPerInch, vExpectedUnits.data(),
+                    vPixelResults.data(), uCount, eLevel);
+
+                if ((std::memcmp(
+                        vUnits.data(), vExpectedUnits.data(),
+                        uCount * sizeof(double)) != 0) ||
+                    (vPixelResults != vExpectedPixels))
+                    bLevelIdentical = false;
+            }
+
+            wxLogMessage(
+                "%s: to units %.0f, to pixels %.0f, results %s.",
+                GetConversionKernels(eLevel).Name, ToUnits, ToPixels,
+                bLevelIdentical ? wxT("identical") : wxT("DIFFER"));
+
+            bIdentical = bIdentical && bLevelIdentical;
+        }
+
+        return bIdentical;
+    }
+
+    ECheckResult CRenderBenchmark::CheckSteadyStateAllocations(
+        SRulerRenderConfig Config)
+    {
+        static const ERulerBackgroundType Backgrounds[] =
+        {
+            ERulerBackgroundType::btSolid,
+            ERulerBackgroundType::btGradient,
+            ERulerBackgroundType::btImage
+        };
+        static const wxChar* BackgroundNames[] =
+            { wxT("solid"), wxT("gradient"), wxT("image") };
+
+        if (!IsAllocationCountingEnabled())
+        {
+            wxLogMessage(
+                "Steady-state allocation check: SKIPPED, allocations are "
+                "counted only in build with WR_COUNT_ALLOCATIONS defined.");
+
+            return crSkipped;
+        }
+
+        // Image background can not be drawn without image.
+        if (!Config.RulerBackgroundBitmapLeftH.IsOk() ||
+            !Config.RulerBackgroundBitmapTopV.IsOk())
+            SetSyntheticBackgroundImage(Config);
+
+        unsigned long long ullAllocations = 0;
+        for (int U = 0; U < ERulerUnits::ruCount; U++)
+        for (size_t B = 0; B < WXSIZEOF(Backgrounds); B++)
+        {
+            Config.eRulerUnits = static_cast<ERulerUnits>(U);
+            Config.eRulerBackgroundType = Backgrounds[B];
+
+            unsigned long long ullFrameAllocations =
+                CountFrameAllocations(Config);
+            if (ullFrameAllocations != 0)
+                wxLogMessage(
+                    "%s %s: %llu allocations in %u frames.",
+                    GetRulerUnitDesc(Config.eRulerUnits).pszSymbol,
+                    BackgroundNames[B], ullFrameAllocations, m_uIterations);
+
+            ullAllocations += ullFrameAllocations;
+        }
+
+        wxLogMessage(
+            "Steady-state allocation check: %llu allocations in %u frames "
+            "of every unit and background type (%s), %s.",
+            ullAllocations, m_uIterations,
+            IsCRuntimeAllocationCountingEnabled() ?
+                "C++ and C runtime allocations counted" :
+                "only C++ allocations counted",
+            (ullAllocations == 0) ? "PASSED" : "FAILED");
+
+        return (ullAllocations == 0) ? crPassed : crFailed;
+    }
+
+    unsigned long long CRenderBenchmark::CountFrameAllocations(
+        const SRulerRenderConfig& Config)
+    {
+        // Prepare off-screen window surface and static layer of the ruler
+        // with thickness of its metrics.
+        static const int Length = 800;
+        bool bVertical =
+            (Config.eRulerPosition == ERulerPosition::rpLeft) ||
+            (Config.eRulerPosition == ERulerPosition::rpRight);
+        wxSize SurfaceSize =
+            bVertical ?
+                wxSize(Config.Metrics.iThickness, Length) :
+                wxSize(Length, Config.Metrics.iThickness);
+        wxRect SurfaceRect(SurfaceSize);
+        wxBitmap Surface(SurfaceSize);
+        wxMemoryDC MemoryDC(Surface);
+        wxBitmap Layer(SurfaceSize);
+        wxMemoryDC LayerDC(Layer);
+
+        CRulerRenderer Renderer;
+        SRulerRenderConfig FrameConfig = Config;
+        Renderer.DrawSurface(LayerDC, SurfaceRect, FrameConfig);
+        Renderer.DrawScale(LayerDC, SurfaceRect, FrameConfig);
+
+        // Bounds of markers are computed the same way as in CDrawPanel.
+        LayerDC.SetFont(Renderer.GetFont());
+        wxSize LabelExtent =
+            CRulerRenderer::MeasureMarkerLabel(
+                LayerDC, SurfaceSize, Config.eRulerUnits,
+                Config.PixelPerInch);
+        auto GetMarkerBounds = [&](int iMarkerPosition)
+        {
+            return CRulerRenderer::GetMarkerBounds(
+                SurfaceRect, Config.eRulerPosition, iMarkerPosition,
+                Config.Metrics, LabelExtent);
+        };
+
+        // Markers move like during dragging.
+        auto GetFirstMarkerPosition = [](unsigned int I)
+        {
+            return static_cast<int>((I * 7) % Length);
+        };
+        auto GetSecondMarkerPosition = [](unsigned int I)
+        {
+            return static_cast<int>((I * 13) % Length);
+        };
+
+        // Update region of every frame covers old and new bounds of both
+        // markers, as invalidated by CDrawPanel. Window system creates
+        // update regions, so they are prepared before measurement.
+        std::vector<wxRegion> vUpdateRegions(Length);
+        for (unsigned int I = 0; I < static_cast<unsigned int>(Length); I++)
+        {
+            unsigned int Previous = (I + Length - 1) % Length;
+            wxRegion& Region = vUpdateRegions[I];
+
+            Region.Union(GetMarkerBounds(GetFirstMarkerPosition(Previous)));
+            Region.Union(GetMarkerBounds(GetSecondMarkerPosition(Previous)));
+            Region.Union(GetMarkerBounds(GetFirstMarkerPosition(I)));
+            Region.Union(GetMarkerBounds(GetSecondMarkerPosition(I)));
+        }
+
+        // Frames are composed with render statistics, but without overlay.
+        CFrameCompositor Compositor;
+        CRenderStatistics Statistics;
+        SFrameContent Content;
+        Content.SurfaceRect = SurfaceRect;
+        Content.dScaleFactor = 1.0;
+        Content.pScaleLayerDC = &LayerDC;
+        Content.pRenderer = &Renderer;
+        Content.pRenderConfig = &FrameConfig;
+        Content.pOverlay = nullptr;
+
+        // One frame of steady-state repaint.
+        auto RenderFrame = [&](unsigned int I)
+        {
+            FrameConfig.iFirstMarkerPosition = GetFirstMarkerPosition(I);
+            FrameConfig.iSecondMarkerPosition = GetSecondMarkerPosition(I);
+            Content.FirstMarkerBounds =
+                GetMarkerBounds(FrameConfig.iFirstMarkerPosition);
+            Content.SecondMarkerBounds =
+                GetMarkerBounds(FrameConfig.iSecondMarkerPosition);
+
+            Compositor.Compose(
+                MemoryDC, vUpdateRegions[I % Length], Content, Statistics);
+        };
+
+        // Warm-up visits every marker position, so back buffer, all pooled
+        // objects and cached labels are created before measurement.
+        for (unsigned int I = 0; I < static_cast<unsigned int>(Length); I++)
+            RenderFrame(I);
+
+        unsigned long long ullAllocations = GetAllocationCount();
+        for (unsigned int I = 0; I < m_uIterations; I++)
+            RenderFrame(I);
+        ullAllocations = GetAllocationCount() - ullAllocations;
+
+        LayerDC.SelectObject(wxNullBitmap);
+        MemoryDC.SelectObject(wxNullBitmap);
+
+        return ullAllocations;
+    }
+
+    SRulerRenderConfig CRenderBenchmark::GetDefaultConfig()
+    {
+        SRulerRenderConfig Config;
+
+        // The same values as CMainFrame::Init() sets.
+        Config.eRulerPosition = ERulerPosition::rpTop;
+        Config.eRulerUnits = ERulerUnits::ruCentimetres;
+        Config.eRulerBackgroundType = ERulerBackgroundType::btGradient;
+        Config.cRulerScaleColour = wxColour(0, 0, 0);
+        Config.cRulerBackgroundColour = wxColour(255, 164, 119);
+        Config.cRulerBackgroundStartColour = wxColour(255, 196, 119);
+        Config.cRulerBackgroundEndColour = wxColour(255, 142, 61);
+        Config.cFirstMarkerColour = wxColour(0, 0, 255);
+        Config.cSecondMarkerColour = wxColour(255, 0, 0);
+        Config.iFirstMarkerPosition = 0;
+        Config.iSecondMarkerPosition = -1;
+        Config.cClearColour = *wxWHITE;
+        Config.eRenderBackend = ERenderBackend::rbDC;
+        Config.Metrics = GetRulerMetrics(1.0);
+        Config.dContentScale = 1.0;
+        Config.PixelPerInch = GetPixelPerInch(0);
+
+        SetSyntheticBackgroundImage(Config);
+
+        return Config;
+    }
+
+    double CRenderBenchmark::MeasureFrames(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        // Warm up, so caches are filled and one-time initialisation is not
+        // measured.
+        CRulerRenderer Renderer;
+        Renderer.Render(dc, SurfaceRect, Config);
+
+        wxStopWatch StopWatch;
+        for (unsigned int I = 0; I < m_uIterations; I++)
+            Renderer.Render(dc, SurfaceRect, Config);
+
+        return
+            StopWatch.TimeInMicro().ToDouble() /
+            static_cast<double>(m_uIterations);
+    }
+
+    double CRenderBenchmark::MeasureTicks(
+        wxDC& dc, const CRulerScaleLayout& Layout, const wxPen& Pen,
+        bool bBatched)
+    {
+        CDCRenderBackend Backend;
+        Backend.SetBatchLines(bBatched);
+        Backend.Begin(dc);
+        Backend.SetPen(Pen);
+
+        // Warm up, so one-time initialisation is not measured.
+        Layout.DrawTicks(Backend);
+
+        wxStopWatch StopWatch;
+        for (unsigned int I = 0; I < m_uIterations; I++)
+            Layout.DrawTicks(Backend);
+
+        double dTime = StopWatch.TimeInMicro().ToDouble();
+
+        Backend.End();
+
+        return dTime / static_cast<double>(m_uIterations);
+    }
+
+    SRenderLatency CRenderBenchmark::ComputeLatency(
+        std::vector<double>& vSamples)
+    {
+        SRenderLatency Latency = { 0.0, 0.0, 0.0, 0.0 };
+
+        if (vSamples.empty())
+            return Latency;
+
+        std::sort(vSamples.begin(), vSamples.end());
+
+        // Nearest rank percentile: the smallest sample which is greater or
+        // equal to Percent % of all samples.
+        auto Percentile = [&vSamples](size_t Percent) -> double
+        {
+            size_t Rank = (Percent * vSamples.size() + 99) / 100;
+
+            return vSamples[(Rank > 0) ? Rank - 1 : 0];
+        };
+
+        Latency.P50 = Percentile(50);
+        Latency.P90 = Percentile(90);
+        Latency.P99 = Percentile(99);
+        Latency.Max = vSamples.back();
+
+        return Latency;
+    }
+
+    void CRenderBenchmark::SetSyntheticBackgroundImage(
+        SRulerRenderConfig& Config)
+    {
+        // Parts have the same sizes as parts cut by
+        // CMainFrame::LoadAndPrepareRulerBackgroundImage().
+        auto CreatePart = [](int iWidth, int iHeight, const wxColour& Colour)
+        {
+            wxBitmap Bitmap(iWidth, iHeight);
+            wxMemoryDC MemoryDC(Bitmap);
+            MemoryDC.SetBackground(wxBrush(Colour));
+            MemoryDC.Clear();
+            MemoryDC.SelectObject(wxNullBitmap);
+
+            return Bitmap;
+        };
+
+        Config.RulerBackgroundBitmapLeftH =
+            CreatePart(4, 60, Config.cRulerBackgroundStartColour);
+        Config.RulerBackgroundBitmapMiddleH =
+            CreatePart(2, 60, Config.cRulerBackgroundColour);
+        Config.RulerBackgroundBitmapRightH =
+            CreatePart(4, 60, Config.cRulerBackgroundEndColour);
+        Config.RulerBackgroundBitmapTopV =
+            CreatePart(60, 4, Config.cRulerBackgroundStartColour);
+        Config.RulerBackgroundBitmapMiddleV =
+            CreatePart(60, 2, Config.cRulerBackgroundColour);
+        Config.RulerBackgroundBitmapBottomV =
+            CreatePart(60, 4, Config.cRulerBackgroundEndColour);
+    }
+} // end namespace WinRuler
@@ -0,0 +1,212 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "CRulerScaleLayout.h"
+#include "CRulerRenderer.h"
+
+namespace WinRuler
+{
+    /**
+     * Result of benchmark's check.
+     **/
+    typedef enum ECheckResult
+    {
+        //! Check passed.
+        crPassed,
+
+        //! Check failed.
+        crFailed,
+
+        //! Check can not be done in this build and it was skipped.
+        crSkipped
+    } ECheckResult;
+
+    /**
+     * Per-frame latency percentiles of one rendering stage in microseconds.
+     **/
+    struct SRenderLatency
+    {
+        //! Median latency.
+        double P50;
+
+        //! 90th percentile of latency.
+        double P90;
+
+        //! 99th percentile of latency.
+        double P99;
+
+        //! The worst latency.
+        double Max;
+    };
+
+    /**
+     * CRenderBenchmark class definition. It renders ruler off-screen through
+     * CRulerRenderer for every combination of ruler's position, unit of
+     * measurement, background type and several lengths, and reports
+     * per-frame latency percentiles of surface, scale and markers rendering.
+     * It also compares graphics backends for every ruler's position and unit
+     * of measurement, per-tick and batched submission of ticks for every
+     * unit of measurement, and measures pixel kernels of software backend and
+     * unit conversion kernels for every supported instruction set. Results
+     * are written to the log.
+     **/
+    class CRenderBenchmark
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * \param uIterations   Number of frames rendered for every
+         *                      measurement.
+         **/
+        CRenderBenchmark(unsigned int uIterations = 100);
+
+        /**
+         * Runs benchmark suite for all combinations of ruler's position,
+         * unit of measurement, background type and length. Colours are
+         * taken from specified configuration, position, units, background
+         * type and markers are overridden. If configuration has no
+         * background image, synthetic one is used.
+         *
+         * \param Config    The ruler's appearance.
+         **/
+        void Run(SRulerRenderConfig Config);
+
+        /**
+         * Compares graphics backends for all combinations of ruler's
+         * position and unit of measurement. Every frame draws the whole
+         * ruler (surface, scale and markers) with warm caches. Colours and
+         * background are taken from specified configuration.
+         *
+         * \param Config    The ruler's appearance.
+         * \param iLength   Length of the ruler in pixels.
+         **/
+        void RunBackends(SRulerRenderConfig Config, int iLength);
+
+        /**
+         * Compares per-tick and batched submission of ticks of the wxDC
+         * backend for all units of measurement. Only ticks of horizontal
+         * ruler's scale are drawn.
+         *
+         * \param Config    The ruler's appearance.
+         * \param iLength   Length of the ruler in pixels.
+         **/
+        void RunTickSubmission(const SRulerRenderConfig& Config, int iLength);
+
+        /**
+         * Measures throughput of pixel kernels of software backend for every
+         * instruction set supported by CPU.
+         *
+         * \param iLength   Length of filled spans in pixels.
+         **/
+        void RunPixelKernels(int iLength);
+
+        /**
+         * Measures throughput of unit conversion kernels for every
+         * instruction set supported by CPU against existing single value
+         * conversion routines, and checks that all instruction sets give
+         * bit-identical results for every unit of measurement.
+         *
+         * \param iLength   Number of converted values (pixel offsets along
+         *                  ruler of this length).
+         *
+         * \return  Returns false if results of any instruction set differ
+         *          from results of single value routines, otherwise true.
+         **/
+        bool RunConversionKernels(int iLength);
+
+        /**
+         * Checks that steady-state repaint of the ruler does not allocate
+         * memory for every unit of measurement and background type. Frames
+         * are composed by CFrameCompositor, the same one which composes
+         * paints of CDrawPanel, while markers move like during dragging and
+         * update regions cover their old and new bounds. Heap allocations
+         * made by frames composed after warm-up are counted, see
+         * GetAllocationCount() for allocations which are counted. Colours
+         * and ruler's position are taken from specified configuration. If
+         * configuration has no background image, synthetic one is used.
+         * Result is written to the log.
+         *
+         * \param Config    The ruler's appearance.
+         *
+         * \return  Returns crFailed if any steady-state frame allocated
+         *          memory, otherwise crPassed. If allocations are not
+         *          counted in this build, returns crSkipped.
+         **/
+        ECheckResult CheckSteadyStateAllocations(SRulerRenderConfig Config);
+
+        /**
+         * Returns default ruler's appearance (the same as the one used by
+         * main frame on the first run) with synthetic background image.
+         **/
+        static SRulerRenderConfig GetDefaultConfig();
+    private:
+        /**
+         * Renders the whole ruler m_uIterations times and measures time.
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         *
+         * \return  Returns average time of one frame in microseconds.
+         **/
+        double MeasureFrames(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Draws all ticks of the layout m_uIterations times and measures
+         * time.
+         *
+         * \param dc            The device context to use for rendering.
+         * \param Layout        The layout which ticks are drawn.
+         * \param Pen           The pen of ticks.
+         * \param bBatched      Selects batched submission of ticks.
+         *
+         * \return  Returns average time of one frame in microseconds.
+         **/
+        double MeasureTicks(
+            wxDC& dc, const CRulerScaleLayout& Layout, const wxPen& Pen,
+            bool bBatched);
+
+        /**
+         * Composes steady-state frames of the ruler with moving markers and
+         * counts heap allocations made by frames composed after warm-up.
+         *
+         * \param Config    The ruler's appearance.
+         *
+         * \return  Returns number of allocations.
+         **/
+        unsigned long long CountFrameAllocations(
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Computes latency percentiles (nearest rank) of measured frames.
+         * Samples are sorted in place.
+         *
+         * \param vSamples  Measured frame times in microseconds.
+         *
+         * \return  Returns latency percentiles.
+         **/
+        static SRenderLatency ComputeLatency(std::vector<double>& vSamples);
+
+        /**
+         * Sets synthetic background image parts on configuration. Their
+         * sizes are the same as sizes of parts cut from background image.
+         *
+         * \param Config    The ruler's appearance to update.
+         **/
+        static void SetSyntheticBackgroundImage(SRulerRenderConfig& Config);
+    private:
+        //! Number of frames rendered for every measurement.
+        unsigned int m_uIterations;
+    };
+} // end namespace WinRuler
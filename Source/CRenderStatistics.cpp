@@ -0,0 +1,200 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <wx/wx.h>
+#include "CRenderStatistics.h"
+
+namespace WinRuler
+{
+    CRenderStatistics::CRenderStatistics() :
+        m_ullPaintedPixels(0),
+        m_ullPaintedPixelsPerSecond(0),
+        m_ullPaints(0),
+        m_ullMotionEvents(0),
+        m_ullRepaintRequests(0),
+        m_ullCoalescedEvents(0),
+        m_ullWindowMoves(0),
+        m_uPaintsPerSecond(0),
+        m_uMotionEventsPerSecond(0),
+        m_uCoalescedEventsPerSecond(0),
+        m_uWindowMovesPerSecond(0),
+        m_ullLayerCacheHits(0),
+        m_ullLayerCacheMisses(0)
+    {
+        for (int I = 0; I < rsCount; I++)
+        {
+            m_adStageTime[I] = 0.0;
+            m_adMaxStageTime[I] = 0.0;
+            m_adLastMaxStageTime[I] = 0.0;
+        }
+
+        // Open first measurement window.
+        m_StopWatch.Start();
+    }
+
+    void CRenderStatistics::AddPaintedPixels(unsigned long long ullPixels)
+    {
+        m_ullPaintedPixels += ullPixels;
+    }
+
+    void CRenderStatistics::AddPaint()
+    {
+        m_ullPaints++;
+    }
+
+    void CRenderStatistics::AddMotionEvent()
+    {
+        m_ullMotionEvents++;
+    }
+
+    void CRenderStatistics::AddRepaintRequest()
+    {
+        m_ullRepaintRequests++;
+    }
+
+    void CRenderStatistics::AddCoalescedEvent()
+    {
+        m_ullCoalescedEvents++;
+    }
+
+    void CRenderStatistics::AddWindowMove()
+    {
+        m_ullWindowMoves++;
+    }
+
+    void CRenderStatistics::AddLayerCacheHit()
+    {
+        m_ullLayerCacheHits++;
+    }
+
+    void CRenderStatistics::AddLayerCacheMiss()
+    {
+        m_ullLayerCacheMisses++;
+    }
+
+    void CRenderStatistics::AddStageTime(
+        ERenderStage eStage, double dMicroseconds)
+    {
+        m_adStageTime[eStage] = dMicroseconds;
+
+        if (dMicroseconds > m_adMaxStageTime[eStage])
+            m_adMaxStageTime[eStage] = dMicroseconds;
+    }
+
+    bool CRenderStatistics::Update()
+    {
+        // Retrieve time elapsed since measurement window was opened.
+        long lElapsed = m_StopWatch.Time();
+
+        // If less than one second elapsed, there is nothing to do.
+        if (lElapsed < 1000)
+            return false;
+
+        // Compute per second values of the closed measurement window.
+        m_ullPaintedPixelsPerSecond =
+            (m_ullPaintedPixels * 1000) /
+            static_cast<unsigned long long>(lElapsed);
+
+        m_uPaintsPerSecond = PerSecond(m_ullPaints, lElapsed);
+        m_uMotionEventsPerSecond = PerSecond(m_ullMotionEvents, lElapsed);
+
+        m_uWindowMovesPerSecond = PerSecond(m_ullWindowMoves, lElapsed);
+
+        // Every paint serves at least one request, so requests above number
+        // of paints were merged into other paints by the system. Together
+        // with input events superseded before they were applied, they are
+        // coalesced events.
+        unsigned long long ullCoalesced = m_ullCoalescedEvents;
+        if (m_ullRepaintRequests > m_ullPaints)
+            ullCoalesced += m_ullRepaintRequests - m_ullPaints;
+        m_uCoalescedEventsPerSecond = PerSecond(ullCoalesced, lElapsed);
+
+        for (int I = 0; I < rsCount; I++)
+        {
+            m_adLastMaxStageTime[I] = m_adMaxStageTime[I];
+            m_adMaxStageTime[I] = 0.0;
+        }
+
+        // Reset counters and open new measurement window.
+        m_ullPaintedPixels = 0;
+        m_ullPaints = 0;
+        m_ullMotionEvents = 0;
+        m_ullRepaintRequests = 0;
+        m_ullCoalescedEvents = 0;
+        m_ullWindowMoves = 0;
+        m_StopWatch.Start();
+
+        return true;
+    }
+
+    unsigned long long CRenderStatistics::GetPaintedPixelsPerSecond() const
+    {
+        return m_ullPaintedPixelsPerSecond;
+    }
+
+    unsigned int CRenderStatistics::GetPaintsPerSecond() const
+    {
+        return m_uPaintsPerSecond;
+    }
+
+    unsigned int CRenderStatistics::GetMotionEventsPerSecond() const
+    {
+        return m_uMotionEventsPerSecond;
+    }
+
+    unsigned int CRenderStatistics::GetCoalescedEventsPerSecond() const
+    {
+        return m_uCoalescedEventsPerSecond;
+    }
+
+    unsigned int CRenderStatistics::GetWindowMovesPerSecond() const
+    {
+        return m_uWindowMovesPerSecond;
+    }
+
+    unsigned long long CRenderStatistics::GetLayerCacheHits() const
+    {
+        return m_ullLayerCacheHits;
+    }
+
+    unsigned long long CRenderStatistics::GetLayerCacheMisses() const
+    {
+        return m_ullLayerCacheMisses;
+    }
+
+    double CRenderStatistics::GetStageTime(ERenderStage eStage) const
+    {
+        return m_adStageTime[eStage];
+    }
+
+    double CRenderStatistics::GetMaxStageTime(ERenderStage eStage) const
+    {
+        return m_adLastMaxStageTime[eStage];
+    }
+
+    void CRenderStatistics::FormatSummary(wxString& Summary) const
+    {
+        Summary.Printf(
+            wxT("Render: %u paints/s, %u motion events/s, %u coalesced/s, ")
+            wxT("%u window moves/s, %llu box px/s; ")
+            wxT("surface %.0f us (max %.0f), scale %.0f us (max %.0f), ")
+            wxT("markers %.0f us (max %.0f); ")
+            wxT("layer cache %llu hits, %llu misses."),
+            m_uPaintsPerSecond, m_uMotionEventsPerSecond,
+            m_uCoalescedEventsPerSecond, m_uWindowMovesPerSecond,
+            m_ullPaintedPixelsPerSecond,
+            m_adStageTime[rsSurface], m_adLastMaxStageTime[rsSurface],
+            m_adStageTime[rsScale], m_adLastMaxStageTime[rsScale],
+            m_adStageTime[rsMarkers], m_adLastMaxStageTime[rsMarkers],
+            m_ullLayerCacheHits, m_ullLayerCacheMisses);
+    }
+
+    unsigned int CRenderStatistics::PerSecond(
+        unsigned long long ullCount, long lElapsed)
+    {
+        return static_cast<unsigned int>(
+            (ullCount * 1000) / static_cast<unsigned long long>(lElapsed));
+    }
+} // end namespace WinRuler
@@ -0,0 +1,225 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/stopwatch.h>
+
+namespace WinRuler
+{
+    /**
+     * Stages of the ruler's rendering which are timed separately.
+     **/
+    typedef enum ERenderStage
+    {
+        //! Drawing of the ruler's surface.
+        rsSurface,
+
+        //! Drawing of the ruler's scale.
+        rsScale,
+
+        //! Drawing of the ruler's markers.
+        rsMarkers,
+
+        //! Number of stages.
+        rsCount
+    } ERenderStage;
+
+    /**
+     * CRenderStatistics class definition. It collects counters and stage
+     * timings of the ruler's rendering and converts them into per second
+     * values once per second.
+     **/
+    class CRenderStatistics
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CRenderStatistics();
+
+        /**
+         * Adds specified number of pixels to the painted pixels counter.
+         * Painted pixels are pixels of bounding box of the update region,
+         * so they are upper bound of really repainted pixels.
+         *
+         * \param ullPixels     Number of pixels of update region's bounding
+         *                      box.
+         **/
+        void AddPaintedPixels(unsigned long long ullPixels);
+
+        /**
+         * Counts one paint of the ruler.
+         **/
+        void AddPaint();
+
+        /**
+         * Counts one mouse motion event received by the ruler.
+         **/
+        void AddMotionEvent();
+
+        /**
+         * Counts one repaint requested by an input event. Requests which are
+         * not followed by their own paint were coalesced by the system.
+         **/
+        void AddRepaintRequest();
+
+        /**
+         * Counts one input event which was superseded by a later one before
+         * it was applied.
+         **/
+        void AddCoalescedEvent();
+
+        /**
+         * Counts one move of the ruler's window.
+         **/
+        void AddWindowMove();
+
+        /**
+         * Counts one rebuild of the ruler's layer which was served by
+         * pre-rendered layer.
+         **/
+        void AddLayerCacheHit();
+
+        /**
+         * Counts one rebuild of the ruler's layer which had to render the
+         * layer.
+         **/
+        void AddLayerCacheMiss();
+
+        /**
+         * Stores time spent in specified rendering stage.
+         *
+         * \param eStage        The rendering stage.
+         * \param dMicroseconds Time spent in the stage in microseconds.
+         **/
+        void AddStageTime(ERenderStage eStage, double dMicroseconds);
+
+        /**
+         * Closes current measurement window if at least one second elapsed
+         * since it was opened and computes per second values.
+         *
+         * \return  Returns true if new per second values were computed,
+         *          otherwise false.
+         **/
+        bool Update();
+
+        /**
+         * Returns number of painted pixels (pixels of bounding boxes of
+         * update regions) per second computed for the last closed
+         * measurement window.
+         *
+         * \return  Returns painted bounding box pixels per second.
+         **/
+        unsigned long long GetPaintedPixelsPerSecond() const;
+
+        /**
+         * Returns number of paints per second of the last closed
+         * measurement window.
+         **/
+        unsigned int GetPaintsPerSecond() const;
+
+        /**
+         * Returns number of mouse motion events per second of the last
+         * closed measurement window.
+         **/
+        unsigned int GetMotionEventsPerSecond() const;
+
+        /**
+         * Returns number of coalesced (dropped) repaint requests per second
+         * of the last closed measurement window.
+         **/
+        unsigned int GetCoalescedEventsPerSecond() const;
+
+        /**
+         * Returns number of ruler's window moves per second of the last
+         * closed measurement window.
+         **/
+        unsigned int GetWindowMovesPerSecond() const;
+
+        /**
+         * Returns number of layer rebuilds served by pre-rendered layers
+         * since the start.
+         **/
+        unsigned long long GetLayerCacheHits() const;
+
+        /**
+         * Returns number of layer rebuilds which had to render the layer
+         * since the start.
+         **/
+        unsigned long long GetLayerCacheMisses() const;
+
+        /**
+         * Returns the last time spent in specified rendering stage.
+         *
+         * \param eStage    The rendering stage.
+         *
+         * \return  Returns time in microseconds.
+         **/
+        double GetStageTime(ERenderStage eStage) const;
+
+        /**
+         * Returns the worst time spent in specified rendering stage during
+         * the last closed measurement window.
+         *
+         * \param eStage    The rendering stage.
+         *
+         * \return  Returns time in microseconds.
+         **/
+        double GetMaxStageTime(ERenderStage eStage) const;
+
+        /**
+         * Formats all per second values and stage timings into single line
+         * suitable for the log.
+         *
+         * \param Summary   Receives formatted summary.
+         **/
+        void FormatSummary(wxString& Summary) const;
+    private:
+        /**
+         * Converts counter of the measurement window to per second value.
+         **/
+        static unsigned int PerSecond(
+            unsigned long long ullCount, long lElapsed);
+    private:
+        //! Stop watch that measures current measurement window.
+        wxStopWatch m_StopWatch;
+
+        //! Painted pixels (of update regions' bounding boxes) in current
+        //! measurement window.
+        unsigned long long m_ullPaintedPixels;
+
+        //! Painted pixels per second of the last measurement window.
+        unsigned long long m_ullPaintedPixelsPerSecond;
+
+        //! Paints, motion events, repaint requests, coalesced input events
+        //! and window moves in current measurement window.
+        unsigned long long m_ullPaints;
+        unsigned long long m_ullMotionEvents;
+        unsigned long long m_ullRepaintRequests;
+        unsigned long long m_ullCoalescedEvents;
+        unsigned long long m_ullWindowMoves;
+
+        //! Per second values of the last measurement window.
+        unsigned int m_uPaintsPerSecond;
+        unsigned int m_uMotionEventsPerSecond;
+        unsigned int m_uCoalescedEventsPerSecond;
+        unsigned int m_uWindowMovesPerSecond;
+
+        //! Layer cache hits and misses since the start. They are not reset
+        //! by measurement windows.
+        unsigned long long m_ullLayerCacheHits;
+        unsigned long long m_ullLayerCacheMisses;
+
+        //! The last time of every rendering stage in microseconds.
+        double m_adStageTime[rsCount];
+
+        //! The worst time of every rendering stage in current measurement
+        //! window and in the last closed one.
+        double m_adMaxStageTime[rsCount];
+        double m_adLastMaxStageTime[rsCount];
+    };
+} // end namespace WinRuler
@@ -0,0 +1,173 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cmath>
+#include <wx/wx.h>
+#include "CRulerLabelCache.h"
+#include "WRUtilities.h"
+
+namespace WinRuler
+{
+    CRulerLabelCache::CRulerLabelCache() :
+        m_bRasterise(false),
+        m_dContentScale(1.0)
+    {
+        Clear();
+    }
+
+    bool CRulerLabelCache::SetFont(const wxFont& Font)
+    {
+        // Font is usually the same object, so comparison is cheap.
+        if (m_Font.IsOk() && (m_Font == Font))
+            return false;
+
+        m_Font = Font;
+        Clear();
+
+        return true;
+    }
+
+    bool CRulerLabelCache::SetRasterisation(
+        bool bRasterise,
+        const wxColour& cTextColour,
+        const wxColour& cBackgroundColour,
+        double dContentScale)
+    {
+        // If nothing changed, cached labels are still valid.
+        if ((m_bRasterise == bRasterise) &&
+            (m_cTextColour == cTextColour) &&
+            (m_cBackgroundColour == cBackgroundColour) &&
+            (m_dContentScale == dContentScale))
+            return false;
+
+        m_bRasterise = bRasterise;
+        m_cTextColour = cTextColour;
+        m_cBackgroundColour = cBackgroundColour;
+        m_dContentScale = dContentScale;
+
+        // Bitmaps of cached labels are not valid anymore.
+        m_mLabels.clear();
+
+        return true;
+    }
+
+    const SRulerLabelEntry& CRulerLabelCache::GetLabel(
+        wxDC& dc, double Value, unsigned int Decimals)
+    {
+        static const double Scales[] =
+            { 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0 };
+
+        // Limit number of decimal places.
+        if (Decimals > 6)
+            Decimals = 6;
+
+        // Build key of the label.
+        SRulerLabelKey Key;
+        Key.Value =
+            static_cast<long long>(std::nearbyint(Value * Scales[Decimals]));
+        Key.Decimals = Decimals;
+
+        // If label is already cached, return it.
+        std::map<SRulerLabelKey, SRulerLabelEntry>::iterator It =
+            m_mLabels.find(Key);
+        if (It != m_mLabels.end())
+            return It->second;
+
+        // Otherwise format, measure and rasterise new label.
+        wxChar Buffer[32];
+        size_t Length = FormatFixedPoint(Value, Decimals, Buffer, 32);
+
+        SRulerLabelEntry& Entry = m_mLabels[Key];
+        Entry.Text = wxString(Buffer, Length);
+
+        wxCoord TextWidth, TextHeight;
+        dc.GetTextExtent(Entry.Text, &TextWidth, &TextHeight);
+        Entry.Extent = wxSize(TextWidth, TextHeight);
+
+        if (m_bRasterise)
+            Rasterise(Entry);
+
+        return Entry;
+    }
+
+    void CRulerLabelCache::GetTextExtent(
+        wxDC& dc, const wxString& Text,
+        wxCoord* pWidth, wxCoord* pHeight)
+    {
+        wxCoord TextWidth = 0;
+
+        for (wxString::const_iterator It = Text.begin(); It != Text.end(); ++It)
+        {
+            wxChar Glyph = *It;
+
+            // Glyphs outside of cached range are not supported, so measure
+            // whole text by device context.
+            if ((Glyph < FirstGlyph) || (Glyph > LastGlyph))
+            {
+                dc.GetTextExtent(Text, pWidth, pHeight);
+
+                return;
+            }
+
+            // Measure glyph if it was not measured yet.
+            wxCoord& GlyphWidth = m_aGlyphWidths[Glyph - FirstGlyph];
+            if (GlyphWidth == -1)
+            {
+                wxCoord GlyphHeight;
+                dc.GetTextExtent(wxString(1, Glyph), &GlyphWidth, &GlyphHeight);
+
+                if (GlyphHeight > m_iGlyphHeight)
+                    m_iGlyphHeight = GlyphHeight;
+            }
+
+            TextWidth += GlyphWidth;
+        }
+
+        // Measure height of the font if no glyph was measured yet.
+        if (m_iGlyphHeight == -1)
+        {
+            wxCoord GlyphWidth;
+            dc.GetTextExtent(
+                wxString(1, wxT('0')), &GlyphWidth, &m_iGlyphHeight);
+        }
+
+        *pWidth = TextWidth;
+        *pHeight = m_iGlyphHeight;
+    }
+
+    void CRulerLabelCache::Clear()
+    {
+        m_mLabels.clear();
+
+        for (wxCoord& GlyphWidth : m_aGlyphWidths)
+            GlyphWidth = -1;
+
+        m_iGlyphHeight = -1;
+    }
+
+    void CRulerLabelCache::Rasterise(SRulerLabelEntry& Entry)
+    {
+        // Empty labels can not be rasterised.
+        if ((Entry.Extent.GetWidth() <= 0) || (Entry.Extent.GetHeight() <= 0))
+            return;
+
+        // Draw text on solid background colour. Extent is in logical pixels,
+        // so bitmap has physical resolution of the target.
+        wxBitmap Bitmap;
+        Bitmap.CreateWithLogicalSize(Entry.Extent, m_dContentScale);
+        wxMemoryDC MemoryDC(Bitmap);
+        MemoryDC.SetBackground(wxBrush(m_cBackgroundColour));
+        MemoryDC.Clear();
+        MemoryDC.SetFont(m_Font);
+        MemoryDC.SetTextForeground(m_cTextColour);
+        MemoryDC.DrawText(Entry.Text, 0, 0);
+        MemoryDC.SelectObject(wxNullBitmap);
+
+        // Background pixels are transparent.
+        Bitmap.SetMask(new wxMask(Bitmap, m_cBackgroundColour));
+
+        Entry.Bitmap = Bitmap;
+    }
+} // end namespace WinRuler
@@ -0,0 +1,169 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <map>
+#include <wx/wx.h>
+
+namespace WinRuler
+{
+    /**
+     * Single entry of the label cache.
+     **/
+    struct SRulerLabelEntry
+    {
+        //! Preformatted text of the label.
+        wxString Text;
+
+        //! Measured extent of the label's text.
+        wxSize Extent;
+
+        //! Pre-rasterised label with mask. It is valid only if rasterisation
+        //! is enabled in the cache.
+        wxBitmap Bitmap;
+    };
+
+    /**
+     * Key of the label cache. Unit of measurement affects label only by
+     * number of decimal places, so labels with the same text are shared
+     * between units.
+     **/
+    struct SRulerLabelKey
+    {
+        //! Value of the label scaled by 10^Decimals and rounded.
+        long long Value;
+
+        //! Number of decimal places.
+        unsigned int Decimals;
+
+        /**
+         * Comparison operator required by std::map.
+         **/
+        bool operator<(const SRulerLabelKey& Other) const
+        {
+            return (Value < Other.Value) ||
+                ((Value == Other.Value) && (Decimals < Other.Decimals));
+        }
+    };
+
+    /**
+     * CRulerLabelCache class definition. It caches formatted texts of the
+     * ruler's scale labels, their extents and optionally pre-rasterised
+     * bitmaps, so the common case is a table lookup plus a blit. It also
+     * caches advance widths of single glyphs, which are used for measurement
+     * of marker labels that change on every frame. Cache is cleared when
+     * font changes.
+     **/
+    class CRulerLabelCache
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CRulerLabelCache();
+
+        /**
+         * Selects font used by the cache. It must be the same font as font
+         * set on the device contexts passed to other methods. If font
+         * differs from the current one, whole cache is cleared.
+         *
+         * \param Font  The font of the labels.
+         *
+         * \return  Returns true if cache was cleared, otherwise false.
+         **/
+        bool SetFont(const wxFont& Font);
+
+        /**
+         * Enables or disables pre-rasterisation of labels. Labels are
+         * rasterised onto solid background colour and masked, so result is
+         * the same as text drawn directly on that background. If any of the
+         * values differs from the current ones, cached labels are cleared.
+         *
+         * \param bRasterise            Enables pre-rasterisation.
+         * \param cTextColour           The colour of the labels' text.
+         * \param cBackgroundColour     The solid colour behind the labels.
+         * \param dContentScale         Content scale factor of bitmaps of
+         *                              rasterised labels.
+         *
+         * \return  Returns true if cached labels were cleared, otherwise false.
+         **/
+        bool SetRasterisation(
+            bool bRasterise,
+            const wxColour& cTextColour,
+            const wxColour& cBackgroundColour,
+            double dContentScale = 1.0);
+
+        /**
+         * Returns cached label for specified value. If label is not cached
+         * yet, it is formatted, measured and (if enabled) rasterised.
+         *
+         * \param dc        The device context used for measurement. Its font
+         *                  must be the cache's font.
+         * \param Value     Value of the label.
+         * \param Decimals  Number of decimal places.
+         *
+         * \return  Returns reference to cached label. It stays valid until
+         *          cache is cleared.
+         **/
+        const SRulerLabelEntry& GetLabel(
+            wxDC& dc, double Value, unsigned int Decimals);
+
+        /**
+         * Measures text as sum of cached advance widths of its glyphs. It does
+         * not allocate memory once all glyphs of the text were measured.
+         * Text with non-ASCII characters is measured by the device context.
+         *
+         * \param dc        The device context used for measurement of not yet
+         *                  cached glyphs. Its font must be the cache's font.
+         * \param Text      Text to measure.
+         * \param pWidth    Receives width of the text.
+         * \param pHeight   Receives height of the text.
+         **/
+        void GetTextExtent(
+            wxDC& dc, const wxString& Text,
+            wxCoord* pWidth, wxCoord* pHeight);
+
+        /**
+         * Clears all cached labels and glyphs.
+         **/
+        void Clear();
+    private:
+        /**
+         * Rasterises label's text into masked bitmap.
+         *
+         * \param Entry     The label entry to rasterise.
+         **/
+        void Rasterise(SRulerLabelEntry& Entry);
+    private:
+        //! First and last glyph with cached advance width.
+        static const wxChar FirstGlyph = wxT(' ');
+        static const wxChar LastGlyph = wxT('~');
+
+        //! Font used for all cached data.
+        wxFont m_Font;
+
+        //! Pre-rasterisation flag.
+        bool m_bRasterise;
+
+        //! Colour of rasterised text.
+        wxColour m_cTextColour;
+
+        //! Colour of background of rasterised text.
+        wxColour m_cBackgroundColour;
+
+        //! Content scale factor of rasterised text.
+        double m_dContentScale;
+
+        //! Cached labels.
+        std::map<SRulerLabelKey, SRulerLabelEntry> m_mLabels;
+
+        //! Cached advance widths of glyphs, -1 if not measured yet.
+        wxCoord m_aGlyphWidths[LastGlyph - FirstGlyph + 1];
+
+        //! Height of the font's text, -1 if not measured yet.
+        wxCoord m_iGlyphHeight;
+    };
+} // end namespace WinRuler
@@ -0,0 +1,784 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cmath>
+#include <algorithm>
+#include <wx/wx.h>
+#include "CRulerRenderer.h"
+#include "WRRulerAxis.h"
+#include "WRRulerUnits.h"
+
+namespace WinRuler
+{
+    CRulerRenderer::CRulerRenderer() :
+        m_RulerFont(
+            6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL),
+        m_iFontHeight(0),
+        m_bSurfaceLayerValid(false)
+    {
+        // Reserve space for marker's label, so its formatting does not
+        // allocate memory.
+        m_sMarkerLabel.reserve(48);
+    }
+
+    void CRulerRenderer::DrawSurface(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        // Empty surface can not be drawn.
+        if (SurfaceRect.IsEmpty())
+            return;
+
+        UpdateSurfaceLayer(SurfaceRect, Config);
+
+        // Draw whole surface with single blit. Bitmap of software backend is
+        // already rasterised, so it is blitted by classic wxDC backend.
+        CRenderBackend& Backend =
+            BeginBackend(
+                dc,
+                (Config.eRenderBackend == ERenderBackend::rbSoftware) ?
+                    ERenderBackend::rbDC : Config.eRenderBackend);
+        Backend.DrawBitmap(m_SurfaceLayer, SurfaceRect.GetTopLeft(), false);
+        Backend.End();
+    }
+
+    void CRulerRenderer::UpdateSurfaceLayer(
+        const wxRect& SurfaceRect, const SRulerRenderConfig& Config)
+    {
+        // Recompose cached surface only if it is not valid anymore.
+        if (!IsSurfaceLayerValid(SurfaceRect, Config))
+        {
+            // Parts of background image are designed in DIPs, so they are
+            // scaled the same way as the rest of the ruler.
+            SRulerRenderConfig SurfaceConfig(Config);
+            if ((Config.eRulerBackgroundType ==
+                    ERulerBackgroundType::btImage) &&
+                (Config.Metrics.dScale != 1.0))
+            {
+                double dScale = Config.Metrics.dScale;
+
+                SurfaceConfig.RulerBackgroundBitmapLeftH =
+                    ScaleBitmap(Config.RulerBackgroundBitmapLeftH, dScale);
+                SurfaceConfig.RulerBackgroundBitmapMiddleH =
+                    ScaleBitmap(Config.RulerBackgroundBitmapMiddleH, dScale);
+                SurfaceConfig.RulerBackgroundBitmapRightH =
+                    ScaleBitmap(Config.RulerBackgroundBitmapRightH, dScale);
+                SurfaceConfig.RulerBackgroundBitmapTopV =
+                    ScaleBitmap(Config.RulerBackgroundBitmapTopV, dScale);
+                SurfaceConfig.RulerBackgroundBitmapMiddleV =
+                    ScaleBitmap(Config.RulerBackgroundBitmapMiddleV, dScale);
+                SurfaceConfig.RulerBackgroundBitmapBottomV =
+                    ScaleBitmap(Config.RulerBackgroundBitmapBottomV, dScale);
+            }
+
+            if (Config.eRenderBackend == ERenderBackend::rbSoftware)
+            {
+                // Rasteriser keeps its own copy of the surface, bitmap is
+                // created from it. It rasterises in logical pixels.
+                m_RasterBackend.ComposeSurface(SurfaceRect, SurfaceConfig);
+                m_RasterBackend.GetSurfaceBitmap(m_SurfaceLayer);
+            }
+            else
+            {
+                // Layer has physical resolution of the target, so it is not
+                // resampled when it is drawn.
+                if (!m_SurfaceLayer.IsOk() ||
+                    (m_SurfaceLayer.GetLogicalSize() !=
+                        SurfaceRect.GetSize()) ||
+                    (m_SurfaceLayer.GetScaleFactor() != Config.dContentScale))
+                {
+                    m_SurfaceLayer.CreateWithLogicalSize(
+                        SurfaceRect.GetSize(), Config.dContentScale);
+                }
+
+                wxMemoryDC MemoryDC(m_SurfaceLayer);
+                MemoryDC.SetBackground(
+                    m_GDIPool.GetBrush(Config.cClearColour));
+                MemoryDC.Clear();
+
+                ComposeSurface(
+                    MemoryDC, wxRect(SurfaceRect.GetSize()), SurfaceConfig);
+
+                MemoryDC.SelectObject(wxNullBitmap);
+            }
+
+            m_SurfaceConfig = Config;
+            m_bSurfaceLayerValid = true;
+        }
+    }
+
+    bool CRulerRenderer::IsSurfaceLayerValid(
+        const wxRect& SurfaceRect, const SRulerRenderConfig& Config) const
+    {
+        return
+            m_bSurfaceLayerValid &&
+            m_SurfaceLayer.IsOk() &&
+            (m_SurfaceLayer.GetLogicalSize() == SurfaceRect.GetSize()) &&
+            IsSameSurface(m_SurfaceConfig, Config);
+    }
+
+    void CRulerRenderer::DescribeSurfaceLayer(
+        const wxSize& SurfaceSize, const SRulerRenderConfig& Config,
+        SRasterSurfaceDesc& Desc, CPixelBuffer& Surface)
+    {
+        // Software backend rasterises in logical pixels, other backends
+        // keep surface in physical pixels of the target.
+        double dContentScale =
+            (Config.eRenderBackend == ERenderBackend::rbSoftware) ?
+                1.0 : Config.dContentScale;
+
+        CRasterRenderBackend::DescribeSurface(
+            Config, Config.Metrics.dScale * dContentScale, Desc);
+        Surface.Resize(
+            wxSize(
+                static_cast<int>(
+                    std::lround(SurfaceSize.GetWidth() * dContentScale)),
+                static_cast<int>(
+                    std::lround(SurfaceSize.GetHeight() * dContentScale))));
+    }
+
+    void CRulerRenderer::SetSurfaceLayer(
+        CPixelBuffer& Surface, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        if (Config.eRenderBackend == ERenderBackend::rbSoftware)
+        {
+            // Rasteriser keeps its own copy of the surface.
+            m_RasterBackend.SetSurface(Surface, SurfaceRect.GetTopLeft());
+            m_RasterBackend.GetSurfaceBitmap(m_SurfaceLayer);
+        }
+        else
+        {
+            Surface.CopyToBitmap(m_SurfaceLayer);
+            m_SurfaceLayer.SetScaleFactor(Config.dContentScale);
+        }
+
+        m_SurfaceConfig = Config;
+        m_bSurfaceLayerValid = true;
+    }
+
+    CRenderBackend& CRulerRenderer::BeginBackend(
+        wxDC& dc, ERenderBackend eRenderBackend)
+    {
+        if ((eRenderBackend == ERenderBackend::rbGraphicsContext) &&
+            m_GCBackend.Begin(dc))
+            return m_GCBackend;
+
+        if ((eRenderBackend == ERenderBackend::rbSoftware) &&
+            m_RasterBackend.Begin(dc))
+            return m_RasterBackend;
+
+        m_DCBackend.Begin(dc);
+
+        return m_DCBackend;
+    }
+
+    void CRulerRenderer::ComposeSurface(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        // Draw surface of ruler:
+        switch (Config.eRulerPosition)
+        {
+        case ERulerPosition::rpLeft:    // Ruler's position on left side.
+            switch (Config.eRulerBackgroundType)
+            {
+            // Ruler's background as solid.
+            case ERulerBackgroundType::btSolid:
+				// Prepare display context's brush.
+                dc.SetBrush(m_GDIPool.GetBrush(Config.cRulerBackgroundColour));
+
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw rectangle on whole surface size.
+                dc.DrawRectangle(SurfaceRect);
+
+                break;
+            // Ruler's background as gradient.
+            case ERulerBackgroundType::btGradient:
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw gradient rectangle on whole surface size.
+                dc.GradientFillLinear(
+                    SurfaceRect,
+                    Config.cRulerBackgroundStartColour,
+                    Config.cRulerBackgroundEndColour,
+                    wxRIGHT);
+
+                break;
+               // Ruler's background as image.
+            case ERulerBackgroundType::btImage:
+                DrawBackgroundImage(dc, SurfaceRect, Config);
+
+                break;
+            }
+
+            break;
+        // Ruler's position on top.
+        case ERulerPosition::rpTop:
+            switch (Config.eRulerBackgroundType)
+            {
+            // Ruler's background as solid.
+            case ERulerBackgroundType::btSolid:
+				// Prepare display context's brush.
+                dc.SetBrush(m_GDIPool.GetBrush(Config.cRulerBackgroundColour));
+
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw rectangle on whole surface size.
+                dc.DrawRectangle(SurfaceRect);
+
+                break;
+            // Ruler's background as gradient.
+            case ERulerBackgroundType::btGradient:
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw gradient rectangle on whole surface size.
+                dc.GradientFillLinear(
+                    SurfaceRect,
+                    Config.cRulerBackgroundStartColour,
+                    Config.cRulerBackgroundEndColour,
+                    wxDOWN);
+
+                break;
+            // Ruler's background as image.
+            case ERulerBackgroundType::btImage:
+                DrawBackgroundImage(dc, SurfaceRect, Config);
+
+                break;
+            }
+
+            break;
+        // Ruler's position on right side.
+        case ERulerPosition::rpRight:
+            switch (Config.eRulerBackgroundType)
+            {
+            // Ruler's background as solid.
+            case ERulerBackgroundType::btSolid:
+				// Prepare display context's brush.
+                dc.SetBrush(m_GDIPool.GetBrush(Config.cRulerBackgroundColour));
+
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw rectangle on whole surface size.
+                dc.DrawRectangle(SurfaceRect);
+
+                break;
+            // Ruler's background as gradient.
+            case ERulerBackgroundType::btGradient:
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw gradient rectangle on whole surface size.
+                dc.GradientFillLinear(
+                    SurfaceRect,
+                    Config.cRulerBackgroundStartColour,
+                    Config.cRulerBackgroundEndColour,
+                    wxLEFT);
+
+                break;
+            // Ruler's background as image.
+            case ERulerBackgroundType::btImage:
+                DrawBackgroundImage(dc, SurfaceRect, Config);
+
+                break;
+            }
+
+            break;
+        // Ruler's position on bottom.
+        case ERulerPosition::rpBottom:
+            switch (Config.eRulerBackgroundType)
+            {
+            // Ruler's background as solid.
+            case ERulerBackgroundType::btSolid:
+				// Prepare display context's brush.
+                dc.SetBrush(m_GDIPool.GetBrush(Config.cRulerBackgroundColour));
+
+				// Prepare display context's pen.
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw rectangle on whole surface size.
+                dc.DrawRectangle(SurfaceRect);
+
+                break;
+            // Ruler's background as gradient.
+            case ERulerBackgroundType::btGradient:
+				// Prepare display context's pen
+                dc.SetPen(*wxTRANSPARENT_PEN);
+
+                // Draw gradient rectangle on whole surface size.
+                dc.GradientFillLinear(
+                    SurfaceRect,
+                    Config.cRulerBackgroundStartColour,
+                    Config.cRulerBackgroundEndColour,
+                    wxUP);
+
+                break;
+            // Ruler's background as image.
+            case ERulerBackgroundType::btImage:
+                DrawBackgroundImage(dc, SurfaceRect, Config);
+
+                break;
+            }
+
+            break;
+        }
+
+        // If m_eRulerBackgroundType is btImage, then return. Otherwise we will
+		// draw black outline around ruler.
+		if (Config.eRulerBackgroundType == ERulerBackgroundType::btImage)
+			return;
+
+        dc.SetPen(*wxBLACK_PEN);
+        dc.SetBrush(*wxTRANSPARENT_BRUSH);
+        dc.DrawRectangle(
+            wxRect(0, 0, SurfaceRect.GetWidth(), SurfaceRect.GetHeight()));
+    }
+
+    void CRulerRenderer::DrawBackgroundImage(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        // Vertical ruler uses top, middle and bottom parts, horizontal one
+        // uses left, middle and right parts.
+        if ((Config.eRulerPosition == ERulerPosition::rpLeft) ||
+            (Config.eRulerPosition == ERulerPosition::rpRight))
+        {
+            const wxBitmap* apParts[] =
+            {
+                &Config.RulerBackgroundBitmapTopV,
+                &Config.RulerBackgroundBitmapMiddleV,
+                &Config.RulerBackgroundBitmapBottomV
+            };
+
+            PlaceBackgroundImageParts(
+                SurfaceRect.GetHeight(), apParts[bpStart]->GetHeight(),
+                apParts[bpMiddle]->GetHeight(), apParts[bpEnd]->GetHeight(),
+                [&](EBackgroundImagePart ePart, int iOffset)
+                {
+                    dc.DrawBitmap(
+                        *apParts[ePart],
+                        wxPoint(
+                            SurfaceRect.GetX(), SurfaceRect.GetY() + iOffset));
+                });
+        }
+        else
+        {
+            const wxBitmap* apParts[] =
+            {
+                &Config.RulerBackgroundBitmapLeftH,
+                &Config.RulerBackgroundBitmapMiddleH,
+                &Config.RulerBackgroundBitmapRightH
+            };
+
+            PlaceBackgroundImageParts(
+                SurfaceRect.GetWidth(), apParts[bpStart]->GetWidth(),
+                apParts[bpMiddle]->GetWidth(), apParts[bpEnd]->GetWidth(),
+                [&](EBackgroundImagePart ePart, int iOffset)
+                {
+                    dc.DrawBitmap(
+                        *apParts[ePart],
+                        wxPoint(
+                            SurfaceRect.GetX() + iOffset, SurfaceRect.GetY()));
+                });
+        }
+    }
+
+    bool CRulerRenderer::IsSameSurface(
+        const SRulerRenderConfig& First,
+        const SRulerRenderConfig& Second)
+    {
+        if ((First.eRulerPosition != Second.eRulerPosition) ||
+            (First.eRulerBackgroundType != Second.eRulerBackgroundType) ||
+            (First.cClearColour != Second.cClearColour) ||
+            (First.Metrics.dScale != Second.Metrics.dScale) ||
+            (First.dContentScale != Second.dContentScale))
+            return false;
+
+        // Software backend composes surface by itself.
+        if ((First.eRenderBackend == ERenderBackend::rbSoftware) !=
+            (Second.eRenderBackend == ERenderBackend::rbSoftware))
+            return false;
+
+        switch (First.eRulerBackgroundType)
+        {
+        case ERulerBackgroundType::btSolid:
+            return First.cRulerBackgroundColour ==
+                Second.cRulerBackgroundColour;
+        case ERulerBackgroundType::btGradient:
+            return
+                (First.cRulerBackgroundStartColour ==
+                    Second.cRulerBackgroundStartColour) &&
+                (First.cRulerBackgroundEndColour ==
+                    Second.cRulerBackgroundEndColour);
+        case ERulerBackgroundType::btImage:
+            // Bitmaps are shared, so new image has new bitmaps.
+            return
+                First.RulerBackgroundBitmapLeftH.IsSameAs(
+                    Second.RulerBackgroundBitmapLeftH) &&
+                First.RulerBackgroundBitmapMiddleH.IsSameAs(
+                    Second.RulerBackgroundBitmapMiddleH) &&
+                First.RulerBackgroundBitmapRightH.IsSameAs(
+                    Second.RulerBackgroundBitmapRightH) &&
+                First.RulerBackgroundBitmapTopV.IsSameAs(
+                    Second.RulerBackgroundBitmapTopV) &&
+                First.RulerBackgroundBitmapMiddleV.IsSameAs(
+                    Second.RulerBackgroundBitmapMiddleV) &&
+                First.RulerBackgroundBitmapBottomV.IsSameAs(
+                    Second.RulerBackgroundBitmapBottomV);
+        }
+
+        return false;
+    }
+
+    void CRulerRenderer::DrawScale(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        bool bSoftware = Config.eRenderBackend == ERenderBackend::rbSoftware;
+
+        // Labels can be pre-rasterised only if ruler's background is solid.
+        // Software backend has its own coverage masks of labels. If
+        // rasterisation parameters were changed, scale layout holds stale
+        // bitmaps and must be rebuilt.
+        if (m_LabelCache.SetRasterisation(
+                !bSoftware &&
+                (Config.eRulerBackgroundType ==
+                    ERulerBackgroundType::btSolid),
+                Config.cRulerScaleColour,
+                Config.cRulerBackgroundColour,
+                Config.dContentScale))
+            m_ScaleLayout.Invalidate();
+
+        // Software backend draws scale over its own copy of the surface, so
+        // surface must be up to date.
+        if (bSoftware)
+            UpdateSurfaceLayer(SurfaceRect, Config);
+
+        // Set device context font. Labels are measured with it.
+        SelectFont(dc, Config.Metrics);
+
+        // Rebuild scale layout only if ruler's position, unit of measurement,
+        // surface size, PPI value or ruler's metrics were changed since the
+        // last draw.
+        m_ScaleLayout.Update(
+            dc, m_LabelCache, m_LookupTable, SurfaceRect,
+            Config.eRulerPosition, Config.eRulerUnits, Config.PixelPerInch,
+            Config.Metrics);
+
+        // Draw ticks and labels stored in scale layout which lie inside
+        // clipping box with pen and text colour of ruler's scale. Without
+        // clipping region, clipping box is the whole device context.
+        wxRect ClipBox;
+        dc.GetClippingBox(ClipBox);
+
+        CRenderBackend& Backend = BeginBackend(dc, Config.eRenderBackend);
+        Backend.SetPen(m_GDIPool.GetPen(Config.cRulerScaleColour));
+        Backend.SetTextStyle(m_RulerFont, Config.cRulerScaleColour);
+        m_ScaleLayout.Draw(Backend, ClipBox);
+        Backend.End();
+    }
+
+    void CRulerRenderer::DrawMarkers(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        // If first marker position is -1, do not draw anything and return.
+        if (Config.iFirstMarkerPosition == -1)
+            return;
+
+        // Set device context font. Markers' labels are measured with it.
+        SelectFont(dc, Config.Metrics);
+
+        // Prepare backend. Pen is set for every marker. Software backend
+        // draws only over ruler's surface, markers are drawn over the scale.
+        CRenderBackend& Backend =
+            BeginBackend(
+                dc,
+                (Config.eRenderBackend == ERenderBackend::rbSoftware) ?
+                    ERenderBackend::rbDC : Config.eRenderBackend);
+        Backend.SetTextStyle(m_RulerFont, Config.cRulerScaleColour);
+
+        // Draw first marker.
+        DrawMarker(
+            dc, Backend, SurfaceRect, Config.eRulerPosition,
+            Config.eRulerUnits, Config.PixelPerInch, Config.Metrics,
+            Config.cFirstMarkerColour, Config.iFirstMarkerPosition);
+
+        // If second marker's position is other than -1, we can draw it.
+        if (Config.iSecondMarkerPosition != -1)
+        {
+            DrawMarker(
+                dc, Backend, SurfaceRect, Config.eRulerPosition,
+                Config.eRulerUnits, Config.PixelPerInch, Config.Metrics,
+                Config.cSecondMarkerColour, Config.iSecondMarkerPosition);
+        }
+
+        Backend.End();
+    }
+
+    void CRulerRenderer::Render(
+        wxDC& dc, const wxRect& SurfaceRect,
+        const SRulerRenderConfig& Config)
+    {
+        DrawSurface(dc, SurfaceRect, Config);
+        DrawScale(dc, SurfaceRect, Config);
+        DrawMarkers(dc, SurfaceRect, Config);
+    }
+
+    wxBitmap CRulerRenderer::RenderToBitmap(
+        const wxSize& Size, const SRulerRenderConfig& Config)
+    {
+        // Empty surface can not be rendered.
+        if ((Size.GetWidth() <= 0) || (Size.GetHeight() <= 0))
+            return wxBitmap();
+
+        // Render whole ruler into memory device context.
+        wxBitmap Bitmap;
+        Bitmap.CreateWithLogicalSize(Size, Config.dContentScale);
+        wxMemoryDC MemoryDC(Bitmap);
+        MemoryDC.SetBackground(m_GDIPool.GetBrush(Config.cClearColour));
+        MemoryDC.Clear();
+
+        Render(MemoryDC, wxRect(Size), Config);
+
+        MemoryDC.SelectObject(wxNullBitmap);
+
+        return Bitmap;
+    }
+
+    void CRulerRenderer::InvalidateSurface()
+    {
+        m_bSurfaceLayerValid = false;
+    }
+
+    void CRulerRenderer::InvalidateScale()
+    {
+        m_ScaleLayout.Invalidate();
+    }
+
+    const wxFont& CRulerRenderer::GetFont() const
+    {
+        return m_RulerFont;
+    }
+
+    const CRulerScaleLayout& CRulerRenderer::GetScaleLayout() const
+    {
+        return m_ScaleLayout;
+    }
+
+    wxSize CRulerRenderer::MeasureMarkerLabel(
+        wxDC& dc, const wxSize& SurfaceSize, ERulerUnits eRulerUnits,
+        const wxRealPoint& PixelPerInch)
+    {
+        const SRulerUnitDesc& Desc = GetRulerUnitDesc(eRulerUnits);
+        wxCoord TextWidth, TextHeight;
+        wxChar Buffer[48];
+
+        // Label of the ruler's end is the widest one.
+        size_t Length =
+            FormatUnitValue(
+                Desc,
+                ConvertPixelsToUnits(
+                    Desc,
+                    std::min(PixelPerInch.x, PixelPerInch.y),
+                    std::max(SurfaceSize.GetWidth(), SurfaceSize.GetHeight())),
+                Buffer, WXSIZEOF(Buffer));
+
+        dc.GetTextExtent(wxString(Buffer, Length), &TextWidth, &TextHeight);
+
+        return wxSize(TextWidth, TextHeight);
+    }
+
+    wxRect CRulerRenderer::GetMarkerBounds(
+        const wxRect& SurfaceRect,
+        ERulerPosition eRulerPosition,
+        int iMarkerPosition,
+        const SRulerMetrics& Metrics,
+        const wxSize& LabelExtent)
+    {
+        // Marker which is not set has no bounds.
+        if (iMarkerPosition == -1)
+            return wxRect();
+
+        int iAlong = Metrics.iInset + iMarkerPosition;
+        int iGap = Metrics.iMarkerLabelGap;
+
+        switch (eRulerPosition)
+        {
+        case ERulerPosition::rpLeft:
+        case ERulerPosition::rpRight:
+            return wxRect(
+                SurfaceRect.GetLeft(),
+                SurfaceRect.GetTop() + iAlong - iGap -
+                LabelExtent.GetHeight() - 2,
+                SurfaceRect.GetWidth(),
+                (iGap + LabelExtent.GetHeight() + 2) * 2 + 1);
+        case ERulerPosition::rpTop:
+        case ERulerPosition::rpBottom:
+        default:
+            return wxRect(
+                SurfaceRect.GetLeft() + iAlong - iGap -
+                LabelExtent.GetWidth() - 2,
+                SurfaceRect.GetTop(),
+                (iGap + LabelExtent.GetWidth() + 2) * 2 + 1,
+                SurfaceRect.GetHeight());
+        }
+    }
+
+    void CRulerRenderer::UpdateFont(const SRulerMetrics& Metrics)
+    {
+        // Font is changed only when scale was changed, so label cache is not
+        // cleared on every draw.
+        if (m_iFontHeight != Metrics.iFontHeight)
+        {
+            m_RulerFont.SetPixelSize(wxSize(0, Metrics.iFontHeight));
+            m_iFontHeight = Metrics.iFontHeight;
+        }
+    }
+
+    wxBitmap CRulerRenderer::ScaleBitmap(const wxBitmap& Bitmap, double dScale)
+    {
+        if (!Bitmap.IsOk() || (dScale == 1.0))
+            return Bitmap;
+
+        // Parts are small, so high quality resampling is cheap.
+        wxImage Image = Bitmap.ConvertToImage();
+        return wxBitmap(
+            Image.Scale(
+                std::max(
+                    1,
+                    static_cast<int>(std::lround(Image.GetWidth() * dScale))),
+                std::max(
+                    1,
+                    static_cast<int>(std::lround(Image.GetHeight() * dScale))),
+                wxIMAGE_QUALITY_HIGH));
+    }
+
+    void CRulerRenderer::SelectFont(wxDC& dc, const SRulerMetrics& Metrics)
+    {
+        // Set device context font to ruler's font (height 8 DIPs, style
+        // normal, weight normal and family default).
+        UpdateFont(Metrics);
+        dc.SetFont(m_RulerFont);
+
+        // If font was changed, cached labels are not valid anymore.
+        if (m_LabelCache.SetFont(m_RulerFont))
+            m_ScaleLayout.Invalidate();
+    }
+
+    void CRulerRenderer::DrawMarker(
+        wxDC& dc, CRenderBackend& Backend, const wxRect& SurfaceRect,
+        ERulerPosition eRulerPosition,
+        ERulerUnits eRulerUnits,
+        const wxRealPoint& PixelPerInch,
+        const SRulerMetrics& Metrics,
+        const wxColour& cMarkerColour,
+        int iMarkerPosition)
+    {
+        // Select specialization for ruler's position.
+        switch (eRulerPosition)
+        {
+        case ERulerPosition::rpLeft:
+            DrawMarkerAxis<TRulerAxis<ERulerPosition::rpLeft>>(
+                dc, Backend, SurfaceRect, eRulerUnits, PixelPerInch, Metrics,
+                cMarkerColour, iMarkerPosition);
+
+            break;
+        case ERulerPosition::rpTop:
+            DrawMarkerAxis<TRulerAxis<ERulerPosition::rpTop>>(
+                dc, Backend, SurfaceRect, eRulerUnits, PixelPerInch, Metrics,
+                cMarkerColour, iMarkerPosition);
+
+            break;
+        case ERulerPosition::rpRight:
+            DrawMarkerAxis<TRulerAxis<ERulerPosition::rpRight>>(
+                dc, Backend, SurfaceRect, eRulerUnits, PixelPerInch, Metrics,
+                cMarkerColour, iMarkerPosition);
+
+            break;
+        case ERulerPosition::rpBottom:
+            DrawMarkerAxis<TRulerAxis<ERulerPosition::rpBottom>>(
+                dc, Backend, SurfaceRect, eRulerUnits, PixelPerInch, Metrics,
+                cMarkerColour, iMarkerPosition);
+
+            break;
+        }
+    }
+
+    template <class Axis>
+    void CRulerRenderer::DrawMarkerAxis(
+        wxDC& dc, CRenderBackend& Backend, const wxRect& SurfaceRect,
+        ERulerUnits eRulerUnits,
+        const wxRealPoint& PixelPerInch,
+        const SRulerMetrics& Metrics,
+        const wxColour& cMarkerColour,
+        int iMarkerPosition)
+    {
+        SRenderLine Line;
+        wxCoord TextWidth, TextHeight;
+        int iAlong = Metrics.iInset + iMarkerPosition;
+
+        // Draw marker's line across whole ruler's surface.
+        Backend.SetPen(m_GDIPool.GetPen(cMarkerColour));
+        Axis::MapLine(
+            SurfaceRect, iAlong, 0, Axis::GetThickness(SurfaceRect),
+            Line.Start, Line.End);
+        Backend.DrawLine(Line);
+
+        // Prepare marker's label. It is converted with PPI value of ruler's
+        // direction. Lookup table is rebuilt only if unit, PPI value or
+        // direction was changed since the last marker or scale.
+        m_LookupTable.Update(
+            GetRulerUnitDesc(eRulerUnits),
+            Axis::GetPixelPerInchAlong(PixelPerInch),
+            Axis::GetLength(SurfaceRect));
+        FormatMarkerLabel(m_sMarkerLabel, eRulerUnits, iMarkerPosition);
+        m_LabelCache.GetTextExtent(
+            dc, m_sMarkerLabel, &TextWidth, &TextHeight);
+        wxSize Extent(TextWidth, TextHeight);
+
+        // Label is drawn after marker's line, or before it if it does not
+        // fit in the ruler.
+        int iLabelAlong = iAlong + Metrics.iMarkerLabelGap;
+        if (iLabelAlong + Axis::GetAlong(Extent) >
+            Axis::GetLength(SurfaceRect) - 1)
+            iLabelAlong =
+                iAlong - Metrics.iMarkerLabelGap - Axis::GetAlong(Extent);
+
+        // Label is centred at 2/3 of ruler's thickness from scale's edge.
+        int iLabelAcross =
+            ((Axis::GetThickness(SurfaceRect) / 3) * 2) -
+            (Axis::GetAcross(Extent) / 2);
+
+        Backend.DrawText(
+            m_sMarkerLabel,
+            Axis::MapLabel(SurfaceRect, iLabelAlong, iLabelAcross, Extent));
+    }
+
+    void CRulerRenderer::FormatMarkerLabel(
+        wxString& Label,
+        ERulerUnits eRulerUnits,
+        int iMarkerPosition)
+    {
+        wxChar Buffer[48];
+        const SRulerUnitDesc& Desc = GetRulerUnitDesc(eRulerUnits);
+
+        // Format marker's position in ruler's unit of measurement followed
+        // by unit's symbol. Position is just loaded from lookup table.
+        size_t Length =
+            FormatUnitValue(
+                Desc, m_LookupTable.PixelsToUnits(iMarkerPosition),
+                Buffer, WXSIZEOF(Buffer));
+
+        // Label has reserved capacity, so assignment does not allocate.
+        Label.assign(Buffer, Length);
+    }
+} // end namespace WinRuler
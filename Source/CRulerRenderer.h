@@ -0,0 +1,468 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "CRulerScaleLayout.h"
+#include "CRulerLabelCache.h"
+#include "CUnitLookupTable.h"
+#include "CGDIObjectPool.h"
+#include "CDCRenderBackend.h"
+#include "CGCRenderBackend.h"
+#include "CRasterRenderBackend.h"
+#include "WRRulerMetrics.h"
+
+namespace WinRuler
+{
+    /**
+     * Complete description of the ruler's appearance needed for rendering.
+     * It does not depend on CMainFrame, so ruler can be rendered without
+     * any window.
+     **/
+    struct SRulerRenderConfig
+    {
+        //! Position of the ruler's scale.
+        ERulerPosition eRulerPosition;
+
+        //! Unit of measurement of the ruler's scale.
+        ERulerUnits eRulerUnits;
+
+        //! Type of the ruler's background.
+        ERulerBackgroundType eRulerBackgroundType;
+
+        //! Colour of the ruler's background (btSolid only).
+        wxColour cRulerBackgroundColour;
+
+        //! Start colour of the ruler's background (btGradient only).
+        wxColour cRulerBackgroundStartColour;
+
+        //! End colour of the ruler's background (btGradient only).
+        wxColour cRulerBackgroundEndColour;
+
+        //! Colour of the ruler's scale and markers' labels.
+        wxColour cRulerScaleColour;
+
+        //! Colour of the first marker.
+        wxColour cFirstMarkerColour;
+
+        //! Colour of the second marker.
+        wxColour cSecondMarkerColour;
+
+        //! Parts of the ruler's background image (btImage only).
+        wxBitmap RulerBackgroundBitmapLeftH;
+        wxBitmap RulerBackgroundBitmapMiddleH;
+        wxBitmap RulerBackgroundBitmapRightH;
+        wxBitmap RulerBackgroundBitmapTopV;
+        wxBitmap RulerBackgroundBitmapMiddleV;
+        wxBitmap RulerBackgroundBitmapBottomV;
+
+        //! Position of the first marker, -1 if it is not set.
+        int iFirstMarkerPosition;
+
+        //! Position of the second marker, -1 if it is not set.
+        int iSecondMarkerPosition;
+
+        //! Colour behind the ruler's surface. It is visible through
+        //! transparent parts of the background image.
+        wxColour cClearColour;
+
+        //! Graphics backend used for drawing of surface, scale and markers.
+        ERenderBackend eRenderBackend;
+
+        //! Geometry of ticks, labels and markers scaled for display which
+        //! shows the ruler.
+        SRulerMetrics Metrics;
+
+        //! Content scale factor (physical pixels per logical pixel) of
+        //! bitmaps created by renderer.
+        double dContentScale;
+
+        //! Calibrated PPI value of the display which shows the ruler. It is
+        //! used for all unit conversions of the scale and markers.
+        wxRealPoint PixelPerInch;
+    };
+
+    /**
+     * CRulerRenderer class definition. It draws ruler's surface, scale and
+     * markers described by SRulerRenderConfig on any device context. It owns
+     * scale layout, label cache and pens and brushes, so repeated rendering
+     * of the same ruler reuses them and does not allocate memory. All
+     * drawing goes through graphics backend selected by configuration.
+     **/
+    class CRulerRenderer
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CRulerRenderer();
+
+        /**
+         * Draws the ruler's surface (background and outline). Surface is
+         * composed once into cached bitmap and then drawn with single blit.
+         * Cached bitmap is recomposed only if surface size, ruler's position,
+         * any background setting, scale factor or software backend selection
+         * was changed. Parts of background image are scaled by ruler's
+         * metrics.
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void DrawSurface(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Draws the ruler's scale. Scale layout is rebuilt only if it was
+         * invalidated or geometry of the ruler was changed. Only ticks and
+         * labels inside clipping box of the device context are drawn. Font
+         * of the device context is left set to ruler's font. Software
+         * backend rasterises surface and scale of clipping box together and
+         * draws them with single bitmap draw.
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void DrawScale(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Draws the ruler's markers (their lines and labels). Markers are
+         * drawn over the scale, so software backend uses classic wxDC
+         * backend for them.
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void DrawMarkers(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Draws the whole ruler (surface, scale and markers).
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void Render(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Renders the whole ruler into a new bitmap. It does not need any
+         * window, so it can be used before main frame is created.
+         *
+         * \param Size        Size of the ruler's surface.
+         * \param Config      The ruler's appearance.
+         *
+         * \return  Returns rendered bitmap or invalid bitmap if size is
+         *          empty.
+         **/
+        wxBitmap RenderToBitmap(
+            const wxSize& Size, const SRulerRenderConfig& Config);
+
+        /**
+         * Checks if cached surface can be drawn for specified surface and
+         * configuration without recomposition.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         *
+         * \return  Returns true if cached surface is valid, otherwise false.
+         **/
+        bool IsSurfaceLayerValid(
+            const wxRect& SurfaceRect, const SRulerRenderConfig& Config) const;
+
+        /**
+         * Describes ruler's surface for composition by rasteriser outside of
+         * the renderer (e.g. by CLayerRenderWorker). Buffer is sized for
+         * resolution of cached surface of the configured backend: logical
+         * pixels for software backend, physical pixels otherwise. It must
+         * be called on the main thread.
+         *
+         * \param SurfaceSize   Size of the ruler's surface.
+         * \param Config        The ruler's appearance.
+         * \param Desc          Receives description of the surface.
+         * \param Surface       Buffer resized for composition.
+         **/
+        static void DescribeSurfaceLayer(
+            const wxSize& SurfaceSize, const SRulerRenderConfig& Config,
+            SRasterSurfaceDesc& Desc, CPixelBuffer& Surface);
+
+        /**
+         * Takes over surface composed from DescribeSurfaceLayer()
+         * description as cached surface, so the next DrawSurface() does not
+         * recompose it. Content of specified buffer is exchanged with the
+         * old surface of software backend.
+         *
+         * \param Surface       The composed surface.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance used for description.
+         **/
+        void SetSurfaceLayer(
+            CPixelBuffer& Surface, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Checks if two configurations produce the same ruler's surface.
+         * Only settings used by their background type are compared.
+         *
+         * \param First     The first ruler's appearance.
+         * \param Second    The second ruler's appearance.
+         *
+         * \return  Returns true if surfaces are the same, otherwise false.
+         **/
+        static bool IsSameSurface(
+            const SRulerRenderConfig& First,
+            const SRulerRenderConfig& Second);
+
+        /**
+         * Invalidates cached surface, so it is recomposed on next
+         * DrawSurface().
+         **/
+        void InvalidateSurface();
+
+        /**
+         * Invalidates scale layout, so it is rebuilt on next DrawScale().
+         **/
+        void InvalidateScale();
+
+        /**
+         * Returns font of ruler's scale and markers' labels.
+         **/
+        const wxFont& GetFont() const;
+
+        /**
+         * Sets size of ruler's font to size of specified metrics. Font is
+         * also updated by every draw, so this is needed only to measure
+         * text before the first draw.
+         *
+         * \param Metrics   Ruler's metrics.
+         **/
+        void UpdateFont(const SRulerMetrics& Metrics);
+
+        /**
+         * Returns layout of the ruler's scale built by the last DrawScale().
+         **/
+        const CRulerScaleLayout& GetScaleLayout() const;
+
+        /**
+         * Measures the widest marker's label possible for the ruler. The
+         * smaller PPI value gives the larger value, so it is used for both
+         * axes.
+         *
+         * \param dc                The device context used for measurement.
+         *                          Ruler's font must be already set.
+         * \param SurfaceSize       Size of the ruler's surface.
+         * \param eRulerUnits       The units of the ruler.
+         * \param PixelPerInch      The PPI value used for unit conversion.
+         *
+         * \return  Returns extent of the widest marker's label.
+         **/
+        static wxSize MeasureMarkerLabel(
+            wxDC& dc, const wxSize& SurfaceSize, ERulerUnits eRulerUnits,
+            const wxRealPoint& PixelPerInch);
+
+        /**
+         * Returns bounds of the marker (its line and its label) for the
+         * specified marker's position. Marker's label can be drawn on both
+         * sides of the marker's line, so bounds cover marker's line,
+         * label's gap and maximal label extent (with 2 pixels of slack) on
+         * both sides of it, across whole ruler's thickness.
+         *
+         * \param SurfaceRect       The rectangle that defines the area to
+         *                          render in.
+         * \param eRulerPosition    The position of the ruler.
+         * \param iMarkerPosition   The position of the marker.
+         * \param Metrics           Ruler's metrics.
+         * \param LabelExtent       Extent of the widest marker's label, see
+         *                          MeasureMarkerLabel().
+         *
+         * \return  Returns marker's bounds or empty rectangle if marker's
+         *          position is -1.
+         **/
+        static wxRect GetMarkerBounds(
+            const wxRect& SurfaceRect,
+            ERulerPosition eRulerPosition,
+            int iMarkerPosition,
+            const SRulerMetrics& Metrics,
+            const wxSize& LabelExtent);
+    private:
+        /**
+         * Binds backend selected by configuration to the device context. If
+         * selected backend can not draw on it, classic wxDC backend is used.
+         *
+         * \param dc                The device context to use for rendering.
+         * \param eRenderBackend    The selected backend.
+         *
+         * \return  Returns bound backend. Its End() must be called when
+         *          drawing is finished.
+         **/
+        CRenderBackend& BeginBackend(wxDC& dc, ERenderBackend eRenderBackend);
+
+        /**
+         * Recomposes cached ruler's surface if it is not valid anymore.
+         * Surface of software backend is composed by its rasteriser.
+         *
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void UpdateSurfaceLayer(
+            const wxRect& SurfaceRect, const SRulerRenderConfig& Config);
+
+        /**
+         * Composes the ruler's surface (background and outline) directly on
+         * the device context.
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void ComposeSurface(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Draws ruler's background image parts directly on the device
+         * context, see PlaceBackgroundImageParts().
+         *
+         * \param dc            The device context to use for rendering.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         * \param Config        The ruler's appearance.
+         **/
+        void DrawBackgroundImage(
+            wxDC& dc, const wxRect& SurfaceRect,
+            const SRulerRenderConfig& Config);
+
+        /**
+         * Returns copy of the bitmap scaled by specified factor. Bitmap is
+         * returned unchanged if factor is 1.
+         *
+         * \param Bitmap    The bitmap to scale.
+         * \param dScale    The scale factor.
+         *
+         * \return  Returns scaled bitmap.
+         **/
+        static wxBitmap ScaleBitmap(const wxBitmap& Bitmap, double dScale);
+
+        /**
+         * Selects ruler's font of specified metrics on device context and
+         * synchronises it with label cache.
+         *
+         * \param dc        The device context to use for rendering.
+         * \param Metrics   Ruler's metrics.
+         **/
+        void SelectFont(wxDC& dc, const SRulerMetrics& Metrics);
+
+        /**
+         * Draws single ruler's marker (its line and its label). It selects
+         * specialization of DrawMarkerAxis() for ruler's position.
+         *
+         * \param dc                The device context used for measurement
+         *                          of marker's label.
+         * \param Backend           The backend to use for rendering.
+         * \param SurfaceRect       The rectangle that defines the area to
+         *                          render in.
+         * \param eRulerPosition    The position of the ruler.
+         * \param eRulerUnits       The units of the ruler.
+         * \param PixelPerInch      The PPI value used for unit conversion.
+         * \param Metrics           Ruler's metrics.
+         * \param cMarkerColour     The colour of the marker.
+         * \param iMarkerPosition   The position of the marker.
+         **/
+        void DrawMarker(
+            wxDC& dc, CRenderBackend& Backend, const wxRect& SurfaceRect,
+            ERulerPosition eRulerPosition,
+            ERulerUnits eRulerUnits,
+            const wxRealPoint& PixelPerInch,
+            const SRulerMetrics& Metrics,
+            const wxColour& cMarkerColour,
+            int iMarkerPosition);
+
+        /**
+         * Draws single ruler's marker for ruler's position described by axis
+         * policy. Parameters are the same as for DrawMarker().
+         *
+         * \tparam Axis     Axis policy (TRulerAxis) of ruler's position.
+         **/
+        template <class Axis>
+        void DrawMarkerAxis(
+            wxDC& dc, CRenderBackend& Backend, const wxRect& SurfaceRect,
+            ERulerUnits eRulerUnits,
+            const wxRealPoint& PixelPerInch,
+            const SRulerMetrics& Metrics,
+            const wxColour& cMarkerColour,
+            int iMarkerPosition);
+
+        /**
+         * Formats marker's label (position and unit's suffix) without memory
+         * allocation. Position is converted by lookup table, which must be
+         * already updated for ruler's unit and direction.
+         *
+         * \param Label             Receives formatted label.
+         * \param eRulerUnits       The units of the ruler.
+         * \param iMarkerPosition   The position of the marker.
+         **/
+        void FormatMarkerLabel(
+            wxString& Label,
+            ERulerUnits eRulerUnits,
+            int iMarkerPosition);
+    private:
+        //! Font of ruler's scale and markers' labels.
+        wxFont m_RulerFont;
+
+        //! Pixel height of m_RulerFont set by UpdateFont().
+        int m_iFontHeight;
+
+        //! Pens and brushes of the ruler's colours.
+        CGDIObjectPool m_GDIPool;
+
+        //! Classic wxDC backend.
+        CDCRenderBackend m_DCBackend;
+
+        //! wxGraphicsContext backend.
+        CGCRenderBackend m_GCBackend;
+
+        //! Software backend.
+        CRasterRenderBackend m_RasterBackend;
+
+        //! Cache of formatted and measured labels.
+        CRulerLabelCache m_LabelCache;
+
+        //! Cached layout of all ticks and labels of the ruler's scale.
+        CRulerScaleLayout m_ScaleLayout;
+
+        //! Pixel to unit conversions of ruler's unit and direction.
+        CUnitLookupTable m_LookupTable;
+
+        //! Text of currently drawn marker's label. It has reserved capacity.
+        wxString m_sMarkerLabel;
+
+        //! Cached ruler's surface.
+        wxBitmap m_SurfaceLayer;
+
+        //! Configuration used for composition of m_SurfaceLayer.
+        SRulerRenderConfig m_SurfaceConfig;
+
+        //! Validity flag of m_SurfaceLayer.
+        bool m_bSurfaceLayerValid;
+    };
+} // end namespace WinRuler
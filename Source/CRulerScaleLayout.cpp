@@ -0,0 +1,547 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <algorithm>
+#include <wx/wx.h>
+#include "CRulerScaleLayout.h"
+#include "WRUtilities.h"
+#include "WRRulerAxis.h"
+
+namespace WinRuler
+{
+    CRulerScaleLayout::CRulerScaleLayout() :
+        m_bValid(false),
+        m_eRulerPosition(ERulerPosition::rpTop),
+        m_UnitDesc(GetRulerUnitDesc(ERulerUnits::ruCentimetres)),
+        m_Metrics(GetRulerMetrics(1.0)),
+        m_bVertical(false),
+        m_iTickOrigin(0),
+        m_ullTickStep(0),
+        m_uRegularTicks(0),
+        m_uLabelInterval(0),
+        m_iMaxLabelAlong(0)
+    {
+        // No code.
+    }
+
+    bool CRulerScaleLayout::Update(
+        wxDC& dc, CRulerLabelCache& LabelCache,
+        CUnitLookupTable& LookupTable, const wxRect& SurfaceRect,
+        ERulerPosition eRulerPosition,
+        ERulerUnits eRulerUnits,
+        const wxRealPoint& PixelPerInch,
+        const SRulerMetrics& Metrics)
+    {
+        // Layout is keyed by unit's descriptor, not by the unit itself, so
+        // changes of user-defined unit rebuild it too.
+        const SRulerUnitDesc& UnitDesc = GetRulerUnitDesc(eRulerUnits);
+
+        // If layout is valid and all key values are the same as during the
+        // last build, there is nothing to do.
+        if (m_bValid &&
+            (m_eRulerPosition == eRulerPosition) &&
+            m_UnitDesc.IsSameScale(UnitDesc) &&
+            (m_SurfaceSize == SurfaceRect.GetSize()) &&
+            (m_PixelPerInch == PixelPerInch) &&
+            (m_Metrics == Metrics))
+            return false;
+
+        // Store new key values.
+        m_eRulerPosition = eRulerPosition;
+        m_UnitDesc = UnitDesc;
+        m_SurfaceSize = SurfaceRect.GetSize();
+        m_PixelPerInch = PixelPerInch;
+        m_Metrics = Metrics;
+
+        // Rebuild whole layout.
+        Rebuild(dc, LabelCache, LookupTable, SurfaceRect);
+
+        m_bValid = true;
+
+        return true;
+    }
+
+    void CRulerScaleLayout::Draw(
+        CRenderBackend& Backend, const wxRect& ClipBox) const
+    {
+        if (m_bVertical)
+            DrawRange(Backend, ClipBox.GetTop(), ClipBox.GetBottom() + 1);
+        else
+            DrawRange(Backend, ClipBox.GetLeft(), ClipBox.GetRight() + 1);
+    }
+
+    void CRulerScaleLayout::DrawRange(
+        CRenderBackend& Backend, int iFrom, int iTo) const
+    {
+        // Draw visible ticks of regular grid in one batch and ticks after
+        // the grid (ruler's end).
+        DrawTickRange(Backend, GetFirstTickAt(iFrom), GetFirstTickAt(iTo));
+        DrawTickRange(Backend, m_uRegularTicks, m_vTicks.size());
+
+        if (m_vLabels.empty())
+            return;
+
+        // Labels of ruler's start and end are always drawn.
+        DrawLabel(Backend, m_vLabels.front());
+        if (m_vLabels.size() > 1)
+            DrawLabel(Backend, m_vLabels.back());
+
+        if ((m_vLabels.size() <= 2) || (m_uLabelInterval == 0))
+            return;
+
+        // Label may overhang its tick by its whole extent, so range of
+        // labelled ticks is widened by the largest label.
+        size_t FirstTick = GetFirstTickAt(iFrom - m_iMaxLabelAlong);
+        size_t EndTick = GetFirstTickAt(iTo + m_iMaxLabelAlong);
+
+        // Label I labels tick I * m_uLabelInterval.
+        size_t First = std::max<size_t>(
+            1, (FirstTick + m_uLabelInterval - 1) / m_uLabelInterval);
+        size_t End = std::min<size_t>(
+            m_vLabels.size() - 1,
+            (EndTick + m_uLabelInterval - 1) / m_uLabelInterval);
+
+        for (size_t I = First; I < End; I++)
+            DrawLabel(Backend, m_vLabels[I]);
+    }
+
+    void CRulerScaleLayout::DrawTicks(CRenderBackend& Backend) const
+    {
+        DrawTickRange(Backend, 0, m_vTicks.size());
+    }
+
+    void CRulerScaleLayout::DrawTickRange(
+        CRenderBackend& Backend, size_t First, size_t End) const
+    {
+        // Nothing to draw.
+        if (First >= End)
+            return;
+
+        Backend.DrawLines(m_vTicks.data() + First, End - First);
+    }
+
+    void CRulerScaleLayout::DrawLabels(CRenderBackend& Backend) const
+    {
+        // Draw all labels.
+        for (const SRulerLabel& Label : m_vLabels)
+            DrawLabel(Backend, Label);
+    }
+
+    void CRulerScaleLayout::DrawLabel(
+        CRenderBackend& Backend, const SRulerLabel& Label)
+    {
+        // Pre-rasterised labels are just blitted.
+        if (Label.Bitmap.IsOk())
+            Backend.DrawBitmap(Label.Bitmap, Label.Anchor, true);
+        else
+            Backend.DrawText(Label.Text, Label.Anchor);
+    }
+
+    size_t CRulerScaleLayout::GetFirstTickAt(int iAlong) const
+    {
+        // There is no regular grid.
+        if (m_ullTickStep == 0)
+            return m_uRegularTicks;
+
+        if (iAlong <= m_iTickOrigin)
+            return 0;
+
+        // Tick K lies at m_iTickOrigin + ((K * m_ullTickStep) >> 32), so the
+        // first tick at or after D is the smallest K for which
+        // K * m_ullTickStep >= D << 32.
+        unsigned long long Distance =
+            static_cast<unsigned long long>(iAlong - m_iTickOrigin);
+        unsigned long long Index =
+            ((Distance << 32) + m_ullTickStep - 1) / m_ullTickStep;
+
+        return static_cast<size_t>(
+            std::min<unsigned long long>(Index, m_uRegularTicks));
+    }
+
+    size_t CRulerScaleLayout::GetTickCount() const
+    {
+        return m_vTicks.size();
+    }
+
+    void CRulerScaleLayout::Invalidate()
+    {
+        m_bValid = false;
+    }
+
+    void CRulerScaleLayout::AddTick(const wxPoint& Start, const wxPoint& End)
+    {
+        m_vTicks.push_back({ Start, End });
+    }
+
+    void CRulerScaleLayout::AddLabel(
+        const SRulerLabelEntry& Label, const wxPoint& Anchor)
+    {
+        m_vLabels.push_back({ Label.Text, Label.Bitmap, Anchor });
+    }
+
+    template <class Axis>
+    void CRulerScaleLayout::AddAxisTick(
+        const wxRect& SurfaceRect, int iAlong, int iLength)
+    {
+        wxPoint Start, End;
+
+        Axis::MapLine(SurfaceRect, iAlong, 0, iLength, Start, End);
+        AddTick(Start, End);
+    }
+
+    template <class Axis>
+    void CRulerScaleLayout::AddAxisLabel(
+        const wxRect& SurfaceRect, const SRulerLabelEntry& Label,
+        int iAlong, int iAcross)
+    {
+        AddLabel(
+            Label, Axis::MapLabel(SurfaceRect, iAlong, iAcross, Label.Extent));
+
+        m_iMaxLabelAlong =
+            std::max(m_iMaxLabelAlong, Axis::GetAlong(Label.Extent));
+    }
+
+    template <class Axis>
+    void CRulerScaleLayout::SetAxisGrid(
+        const wxRect& SurfaceRect, int iOrigin,
+        unsigned long long ullTickStep, size_t uLabelInterval)
+    {
+        m_bVertical = Axis::bVertical;
+        m_iTickOrigin =
+            (Axis::bVertical ? SurfaceRect.GetTop() : SurfaceRect.GetLeft()) +
+            iOrigin;
+        m_ullTickStep = ullTickStep;
+        m_uRegularTicks = m_vTicks.size();
+        m_uLabelInterval = uLabelInterval;
+    }
+
+    size_t CRulerScaleLayout::SelectTickStride(
+        unsigned long long ullStep, const size_t* pStrides, size_t uCount,
+        size_t uLabelStride) const
+    {
+        // The finest subdivision whose ticks are far enough from each other.
+        for (size_t I = 0; I < uCount; I++)
+        {
+            if (pStrides[I] * ullStep >=
+                (static_cast<unsigned long long>(
+                    m_Metrics.iMinTickSpacing) << 32))
+                return pStrides[I];
+        }
+
+        // Even whole units are too dense, so only labelled ticks are drawn.
+        return uLabelStride;
+    }
+
+    size_t CRulerScaleLayout::SelectLabelStride(
+        unsigned long long ullStep, size_t uBaseStride,
+        int iLabelAlong) const
+    {
+        static const size_t Multipliers[] = { 1, 2, 5 };
+        unsigned long long ullMinSpacing =
+            static_cast<unsigned long long>(
+                iLabelAlong + m_Metrics.iMinLabelGap) << 32;
+
+        // Walk 1-2-5 series of the base stride until labels do not overlap.
+        // Every step of the series divides all following ones, so ticks
+        // selected by SelectTickStride() always hit labelled positions.
+        for (size_t Decade = 1; ; Decade *= 10)
+        {
+            for (size_t Multiplier : Multipliers)
+            {
+                size_t Stride = uBaseStride * Multiplier * Decade;
+
+                if (Stride * ullStep >= ullMinSpacing)
+                    return Stride;
+            }
+        }
+    }
+
+    template <class Axis>
+    void CRulerScaleLayout::BuildUnitScale(
+        wxDC& dc, CRulerLabelCache& LabelCache,
+        const CUnitLookupTable& LookupTable, const wxRect& SurfaceRect)
+    {
+        // All intervals of the scale are in base ticks of the unit.
+        const SRulerUnitDesc& Desc = m_UnitDesc;
+        const size_t LabelTicks = Desc.uLabelTicks;
+        const size_t MediumTicks = Desc.uMediumTicks;
+
+        // Subdivisions from the finest one are all divisors of the medium
+        // interval (or of the label interval if there are no medium ticks),
+        // so every subdivision divides every label stride.
+        size_t TickStrides[16];
+        size_t StrideCount = 0;
+        size_t Interval = (MediumTicks != 0) ? MediumTicks : LabelTicks;
+        for (size_t D = 1;
+             (D <= Interval) && (StrideCount < WXSIZEOF(TickStrides));
+             D++)
+        {
+            if (Interval % D == 0)
+                TickStrides[StrideCount++] = D;
+        }
+
+        const SRulerLabelEntry* pLabel;
+        const int iInset = m_Metrics.iInset;
+        int sT =
+            Axis::GetLength(SurfaceRect) - iInset - m_Metrics.iEndMargin;
+        unsigned long long Step = LookupTable.GetTickStep();
+
+        // Ruler is too short, PPI value is not valid or descriptor has no
+        // scale, so there is no scale.
+        if ((sT <= 0) || (Step == 0) || (LabelTicks == 0))
+            return;
+
+        // Label of ruler's length is the widest one, so it limits density
+        // of labels. Middle labels must not overlap it either.
+        pLabel =
+            &LabelCache.GetLabel(
+                dc, LookupTable.PixelsToUnits(sT), Desc.uLabelDecimals);
+        int iEndLabelAlong = Axis::GetAlong(pLabel->Extent);
+        int iEndLabelStart = iInset + sT - iEndLabelAlong;
+
+        // Select level of detail: labels are as dense as they can be without
+        // overlap and ticks are at least minimal tick spacing apart.
+        size_t LabelStride =
+            SelectLabelStride(Step, LabelTicks, iEndLabelAlong);
+        size_t TickStride = SelectTickStride(
+            Step, TickStrides, StrideCount, LabelStride);
+        unsigned long long GridStep = TickStride * Step;
+
+        // Number of drawn ticks which lie before ruler's end, i.e. the
+        // smallest G for which (G * GridStep) >> 32 >= sT.
+        size_t Count = static_cast<size_t>(
+            ((static_cast<unsigned long long>(sT) << 32) + GridStep - 1) /
+            GridStep);
+
+        // Map every drawn tick to its pixel position. This loop has no
+        // branches, so compiler can vectorize it.
+        m_vTickPositions.resize(Count);
+        int* pPositions = m_vTickPositions.data();
+        for (size_t G = 0; G < Count; G++)
+            pPositions[G] = static_cast<int>((G * GridStep) >> 32);
+
+        // Classify ticks by integer index of the base tick.
+        for (size_t G = 0; G < Count; G++)
+        {
+            size_t K = G * TickStride;
+            int pT = iInset + pPositions[G];
+
+            if (K == 0)
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iLongTick);
+
+                pLabel = &LabelCache.GetLabel(dc, 0.0, Desc.uLabelDecimals);
+                AddAxisLabel<Axis>(
+                    SurfaceRect, *pLabel, pT,
+                    Axis::GetEndLabelOffset(m_Metrics));
+            }
+            else if (K % LabelTicks == 0)
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iMiddleTick);
+
+                if (K % LabelStride != 0)
+                    continue;
+
+                // Value is exact for all built-in units, eighths are
+                // representable in double.
+                pLabel =
+                    &LabelCache.GetLabel(
+                        dc,
+                        (static_cast<double>(K) * Desc.uUnitsPerTick) /
+                            Desc.uTicksPerUnit,
+                        Desc.uLabelDecimals);
+                int iAlong = pT - (Axis::GetAlong(pLabel->Extent) / 2);
+
+                // Labels which would overlap the end label are dropped.
+                // They form the tail of the labels, so the rest still
+                // follows the label stride.
+                if (iAlong + Axis::GetAlong(pLabel->Extent) +
+                    m_Metrics.iMinLabelGap > iEndLabelStart)
+                    continue;
+
+                AddAxisLabel<Axis>(
+                    SurfaceRect, *pLabel, iAlong, m_Metrics.iLabelOffset);
+            }
+            else if ((MediumTicks != 0) && (K % MediumTicks == 0))
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iMediumTick);
+            }
+            else
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iShortTick);
+            }
+        }
+
+        // Drawn ticks form regular grid, closing tick lies after it.
+        SetAxisGrid<Axis>(
+            SurfaceRect, iInset, GridStep, LabelStride / TickStride);
+
+        // Closing tick and label with ruler's length.
+        AddAxisTick<Axis>(SurfaceRect, iInset + sT, m_Metrics.iLongTick);
+
+        pLabel =
+            &LabelCache.GetLabel(
+                dc, LookupTable.PixelsToUnits(sT), Desc.uLabelDecimals);
+        AddAxisLabel<Axis>(
+            SurfaceRect, *pLabel, iEndLabelStart,
+            Axis::GetEndLabelOffset(m_Metrics));
+    }
+
+    template <class Axis>
+    void CRulerScaleLayout::BuildPixelScale(
+        wxDC& dc, CRulerLabelCache& LabelCache, const wxRect& SurfaceRect)
+    {
+        // Base tick lies on every second pixel, major ticks every 10 base
+        // ticks. Subdivisions from the finest one are in base ticks.
+        static const size_t TickStrides[] = { 1, 2, 5, 10 };
+        static const unsigned long long Step =
+            static_cast<unsigned long long>(2) << 32;
+
+        const SRulerLabelEntry* pLabel;
+        const int iInset = m_Metrics.iInset;
+        int sT = (Axis::GetLength(SurfaceRect) - (2 * iInset)) / 2;
+
+        // Ruler is too short, so there is no scale.
+        if (sT <= 0)
+            return;
+
+        // Index of base tick at ruler's end. It gets closing tick.
+        size_t Last = static_cast<size_t>(sT - 1);
+
+        // Label of ruler's length is the widest one, so it limits density
+        // of labels. Middle labels must not overlap it either.
+        pLabel = &LabelCache.GetLabel(dc, Last * 2, 0);
+        int iEndLabelAlong = Axis::GetAlong(pLabel->Extent);
+        int iEndLabelStart =
+            iInset + static_cast<int>(Last * 2) - iEndLabelAlong;
+
+        // Select level of detail: labels are as dense as they can be without
+        // overlap and ticks are at least minimal tick spacing apart.
+        size_t LabelStride = SelectLabelStride(Step, 10, iEndLabelAlong);
+        size_t TickStride = SelectTickStride(
+            Step, TickStrides, WXSIZEOF(TickStrides), LabelStride);
+
+        // Start label.
+        pLabel = &LabelCache.GetLabel(dc, 0, 0);
+        AddAxisLabel<Axis>(
+            SurfaceRect, *pLabel, iInset,
+            Axis::GetEndLabelOffset(m_Metrics));
+
+        // Drawn base ticks before ruler's end.
+        for (size_t I = 0; I < Last; I += TickStride)
+        {
+            int pT = iInset + static_cast<int>(I * 2);
+
+            if (I == 0)
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iLongTick);
+            }
+            else if (I % 10 == 0)
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iMiddleTick);
+
+                if (I % LabelStride != 0)
+                    continue;
+
+                pLabel = &LabelCache.GetLabel(dc, I * 2, 0);
+                int iAlong = pT - (Axis::GetAlong(pLabel->Extent) / 2);
+
+                // Labels which would overlap the end label are dropped.
+                if (iAlong + Axis::GetAlong(pLabel->Extent) +
+                    m_Metrics.iMinLabelGap > iEndLabelStart)
+                    continue;
+
+                AddAxisLabel<Axis>(
+                    SurfaceRect, *pLabel, iAlong, m_Metrics.iLabelOffset);
+            }
+            else
+            {
+                AddAxisTick<Axis>(SurfaceRect, pT, m_Metrics.iShortTick);
+            }
+        }
+
+        // Drawn ticks form regular grid, closing tick lies after it.
+        SetAxisGrid<Axis>(
+            SurfaceRect, iInset, TickStride * Step,
+            LabelStride / TickStride);
+
+        // Closing tick and label with ruler's length.
+        AddAxisTick<Axis>(
+            SurfaceRect, iInset + static_cast<int>(Last * 2),
+            m_Metrics.iLongTick);
+
+        pLabel = &LabelCache.GetLabel(dc, Last * 2, 0);
+        AddAxisLabel<Axis>(
+            SurfaceRect, *pLabel, iEndLabelStart,
+            Axis::GetEndLabelOffset(m_Metrics));
+    }
+
+    template <class Axis>
+    void CRulerScaleLayout::RebuildAxis(
+        wxDC& dc, CRulerLabelCache& LabelCache,
+        CUnitLookupTable& LookupTable, const wxRect& SurfaceRect)
+    {
+        // Pixels keep their own layout, scale of every other unit is built
+        // from its descriptor with lookup table of PPI value along the axis.
+        if (m_UnitDesc.bDevicePixels)
+        {
+            BuildPixelScale<Axis>(dc, LabelCache, SurfaceRect);
+        }
+        else
+        {
+            LookupTable.Update(
+                m_UnitDesc, Axis::GetPixelPerInchAlong(m_PixelPerInch),
+                Axis::GetLength(SurfaceRect));
+
+            BuildUnitScale<Axis>(dc, LabelCache, LookupTable, SurfaceRect);
+        }
+    }
+
+    void CRulerScaleLayout::Rebuild(
+        wxDC& dc, CRulerLabelCache& LabelCache,
+        CUnitLookupTable& LookupTable, const wxRect& SurfaceRect)
+    {
+        // Clear previous layout. Capacity of all vectors is kept, so
+        // rebuilds for similar rulers do not allocate again.
+        m_vTicks.clear();
+        m_vTickPositions.clear();
+        m_vLabels.clear();
+
+        // Forget previous grid. Kernel sets the new one.
+        m_bVertical = false;
+        m_iTickOrigin = 0;
+        m_ullTickStep = 0;
+        m_uRegularTicks = 0;
+        m_uLabelInterval = 0;
+        m_iMaxLabelAlong = 0;
+
+        // Select specialization for ruler's position. This is the only place
+        // where ruler's position is checked, kernels are fully inlined for
+        // every position.
+        switch (m_eRulerPosition)
+        {
+        case ERulerPosition::rpLeft:
+            RebuildAxis<TRulerAxis<ERulerPosition::rpLeft>>(
+                dc, LabelCache, LookupTable, SurfaceRect);
+
+            break;
+        case ERulerPosition::rpTop:
+            RebuildAxis<TRulerAxis<ERulerPosition::rpTop>>(
+                dc, LabelCache, LookupTable, SurfaceRect);
+
+            break;
+        case ERulerPosition::rpRight:
+            RebuildAxis<TRulerAxis<ERulerPosition::rpRight>>(
+                dc, LabelCache, LookupTable, SurfaceRect);
+
+            break;
+        case ERulerPosition::rpBottom:
+            RebuildAxis<TRulerAxis<ERulerPosition::rpBottom>>(
+                dc, LabelCache, LookupTable, SurfaceRect);
+
+            break;
+        }
+    }
+} // end namespace WinRuler
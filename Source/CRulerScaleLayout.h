@@ -0,0 +1,353 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "CRulerLabelCache.h"
+#include "CUnitLookupTable.h"
+#include "CRenderBackend.h"
+#include "WRRulerMetrics.h"
+#include "WRRulerUnits.h"
+
+namespace WinRuler
+{
+    /**
+     * Single label of the ruler's scale together with its anchor point.
+     **/
+    struct SRulerLabel
+    {
+        //! Text of the label.
+        wxString Text;
+
+        //! Pre-rasterised label. If it is not valid, Text is drawn instead.
+        wxBitmap Bitmap;
+
+        //! Top left point where label's text is drawn.
+        wxPoint Anchor;
+    };
+
+    /**
+     * CRulerScaleLayout class definition. It holds positions and lengths of
+     * all ticks and anchors of all labels of the ruler's scale. Layout is
+     * keyed by ruler's position, ruler's unit of measurement, ruler's surface
+     * size, PPI value and ruler's metrics and it is rebuilt only when one of
+     * those changes, so drawing of the scale is just a walk through flat
+     * arrays. Ticks are kept in contiguous array of lines, so backend can
+     * submit all of them in one batch. Ticks lie on regular grid along the
+     * scale and labels on every N-th tick of it, so ticks and labels
+     * visible in the clipping box are found by index arithmetic and cost of
+     * drawing is proportional to exposed area, not to ruler's length. Level
+     * of detail is selected for ruler's PPI: ticks closer than minimal tick
+     * spacing of ruler's metrics and labels which would overlap are not
+     * generated at all.
+     **/
+    class CRulerScaleLayout
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CRulerScaleLayout();
+
+        /**
+         * Rebuilds layout if any of its key values differs from values used
+         * for the last build.
+         *
+         * \param dc                The device context used for measurement of
+         *                          labels. Its font must be already set.
+         * \param LabelCache        The cache of formatted and measured labels.
+         * \param LookupTable       The lookup table of unit conversions. It
+         *                          is updated for ruler's axis.
+         * \param SurfaceRect       The rectangle that defines the area to
+         *                          render in.
+         * \param eRulerPosition    The position of the ruler.
+         * \param eRulerUnits       The units of the ruler.
+         * \param PixelPerInch      The PPI value used for unit conversion.
+         * \param Metrics           Geometry of ticks and labels scaled for
+         *                          display which shows the ruler.
+         *
+         * \return  Returns true if layout was rebuilt, otherwise false.
+         **/
+        bool Update(
+            wxDC& dc, CRulerLabelCache& LabelCache,
+            CUnitLookupTable& LookupTable, const wxRect& SurfaceRect,
+            ERulerPosition eRulerPosition,
+            ERulerUnits eRulerUnits,
+            const wxRealPoint& PixelPerInch,
+            const SRulerMetrics& Metrics);
+
+        /**
+         * Draws ticks (in one batch) and labels of the layout which lie in
+         * the clipping box. Pen, font and text colour of the backend must
+         * be already set.
+         *
+         * \param Backend   The backend to use for rendering.
+         * \param ClipBox   Clipping box of the device context.
+         **/
+        void Draw(CRenderBackend& Backend, const wxRect& ClipBox) const;
+
+        /**
+         * Draws ticks (in one batch) and labels of the layout which lie in
+         * the specified range along the scale. Pen, font and text colour of
+         * the backend must be already set.
+         *
+         * \param Backend   The backend to use for rendering.
+         * \param iFrom     Start of the range along the scale in device
+         *                  coordinates.
+         * \param iTo       End of the range along the scale (exclusive).
+         **/
+        void DrawRange(CRenderBackend& Backend, int iFrom, int iTo) const;
+
+        /**
+         * Draws all ticks of the layout in one batch. Pen of the backend
+         * must be already set.
+         *
+         * \param Backend   The backend to use for rendering.
+         **/
+        void DrawTicks(CRenderBackend& Backend) const;
+
+        /**
+         * Draws all labels of the layout. Font and text colour of the
+         * backend must be already set.
+         *
+         * \param Backend   The backend to use for rendering.
+         **/
+        void DrawLabels(CRenderBackend& Backend) const;
+
+        /**
+         * Returns number of ticks in the layout.
+         *
+         * \return  Returns number of ticks.
+         **/
+        size_t GetTickCount() const;
+
+        /**
+         * Marks layout as invalid, so it will be rebuilt on the next
+         * Update() call.
+         **/
+        void Invalidate();
+    private:
+        /**
+         * Returns index of the first tick of regular grid which lies at or
+         * after the specified position along the scale. It is computed
+         * directly from tick's step, without a scan.
+         *
+         * \param iAlong    Position along the scale in device coordinates.
+         *
+         * \return  Returns index of the tick, or number of regular ticks if
+         *          there is no such tick.
+         **/
+        size_t GetFirstTickAt(int iAlong) const;
+
+        /**
+         * Draws ticks from the specified range of indices in one batch.
+         *
+         * \param Backend   The backend to use for rendering.
+         * \param First     Index of the first drawn tick.
+         * \param End       Index after the last drawn tick.
+         **/
+        void DrawTickRange(
+            CRenderBackend& Backend, size_t First, size_t End) const;
+
+        /**
+         * Draws single label.
+         *
+         * \param Backend   The backend to use for rendering.
+         * \param Label     The label to draw.
+         **/
+        static void DrawLabel(
+            CRenderBackend& Backend, const SRulerLabel& Label);
+
+        /**
+         * Rebuilds all ticks and labels for the current key values.
+         *
+         * \param dc            The device context used for measurement of
+         *                      labels.
+         * \param LabelCache    The cache of formatted and measured labels.
+         * \param LookupTable   The lookup table of unit conversions.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         **/
+        void Rebuild(
+            wxDC& dc, CRulerLabelCache& LabelCache,
+            CUnitLookupTable& LookupTable, const wxRect& SurfaceRect);
+
+        /**
+         * Appends new tick to the layout.
+         *
+         * \param Start     Start point of the tick line.
+         * \param End       End point of the tick line.
+         **/
+        void AddTick(const wxPoint& Start, const wxPoint& End);
+
+        /**
+         * Appends new label to the layout.
+         *
+         * \param Label     Cached label.
+         * \param Anchor    Top left point of the label's text.
+         **/
+        void AddLabel(const SRulerLabelEntry& Label, const wxPoint& Anchor);
+
+        /**
+         * Selects kernel for descriptor of ruler's unit of measurement and
+         * builds the scale for specified axis.
+         *
+         * \tparam Axis         Axis policy (TRulerAxis) of ruler's position.
+         * \param dc            The device context used for measurement of
+         *                      labels.
+         * \param LabelCache    The cache of formatted and measured labels.
+         * \param LookupTable   The lookup table of unit conversions. It is
+         *                      updated for PPI value along the axis.
+         * \param SurfaceRect   The rectangle that defines the area to render
+         *                      in.
+         **/
+        template <class Axis>
+        void RebuildAxis(
+            wxDC& dc, CRulerLabelCache& LabelCache,
+            CUnitLookupTable& LookupTable, const wxRect& SurfaceRect);
+
+        /**
+         * Returns the finest tick subdivision whose ticks are at least
+         * minimal tick spacing of ruler's metrics apart.
+         *
+         * \param ullStep       32.32 fixed-point length of the base tick.
+         * \param pStrides      Candidate subdivisions in base ticks, from
+         *                      the finest one. All of them must divide label
+         *                      stride.
+         * \param uCount        Number of candidate subdivisions.
+         * \param uLabelStride  Label stride in base ticks. It is used when
+         *                      no candidate is coarse enough.
+         *
+         * \return  Returns tick stride in base ticks.
+         **/
+        size_t SelectTickStride(
+            unsigned long long ullStep, const size_t* pStrides, size_t uCount,
+            size_t uLabelStride) const;
+
+        /**
+         * Returns the smallest label stride from 1-2-5 series of the base
+         * stride at which labels do not overlap.
+         *
+         * \param ullStep       32.32 fixed-point length of the base tick.
+         * \param uBaseStride   The finest label stride in base ticks.
+         * \param iLabelAlong   The largest extent of label along the scale.
+         *
+         * \return  Returns label stride in base ticks.
+         **/
+        size_t SelectLabelStride(
+            unsigned long long ullStep, size_t uBaseStride,
+            int iLabelAlong) const;
+
+        /**
+         * Builds scale of any unit described by unit's descriptor. It steps
+         * by integer index of the base tick mapped to pixels with
+         * fixed-point arithmetic, so it is exact for any ruler's length.
+         * Only base ticks of subdivision selected by SelectTickStride() get
+         * ticks. Parameters are the same as for RebuildAxis().
+         **/
+        template <class Axis>
+        void BuildUnitScale(
+            wxDC& dc, CRulerLabelCache& LabelCache,
+            const CUnitLookupTable& LookupTable, const wxRect& SurfaceRect);
+
+        /**
+         * Builds scale in pixels. Base tick lies on every second pixel,
+         * level of detail is selected the same way as for fractional scale.
+         * Parameters are the same as for RebuildAxis().
+         **/
+        template <class Axis>
+        void BuildPixelScale(
+            wxDC& dc, CRulerLabelCache& LabelCache, const wxRect& SurfaceRect);
+
+        /**
+         * Appends new tick given in axis coordinates to the layout.
+         *
+         * \param SurfaceRect   The rectangle of ruler's surface.
+         * \param iAlong        Position of the tick along the scale.
+         * \param iLength       Length of the tick from scale's edge.
+         **/
+        template <class Axis>
+        void AddAxisTick(const wxRect& SurfaceRect, int iAlong, int iLength);
+
+        /**
+         * Appends new label given in axis coordinates to the layout.
+         *
+         * \param SurfaceRect   The rectangle of ruler's surface.
+         * \param Label         Cached label.
+         * \param iAlong        Start of the label's box along the scale.
+         * \param iAcross       Start of the label's box across the scale.
+         **/
+        template <class Axis>
+        void AddAxisLabel(
+            const wxRect& SurfaceRect, const SRulerLabelEntry& Label,
+            int iAlong, int iAcross);
+
+        /**
+         * Stores regular grid of ticks and labels of the scale.
+         *
+         * \param SurfaceRect       The rectangle of ruler's surface.
+         * \param iOrigin           Position of the first tick along the
+         *                          scale, relative to surface.
+         * \param ullTickStep       32.32 fixed-point distance of two ticks.
+         * \param uLabelInterval    Number of ticks between two labels.
+         **/
+        template <class Axis>
+        void SetAxisGrid(
+            const wxRect& SurfaceRect, int iOrigin,
+            unsigned long long ullTickStep, size_t uLabelInterval);
+    private:
+        //! Validity flag of the layout.
+        bool m_bValid;
+
+        //! Ruler's position used for the last build.
+        ERulerPosition m_eRulerPosition;
+
+        //! Descriptor of ruler's unit of measurement used for the last
+        //! build.
+        SRulerUnitDesc m_UnitDesc;
+
+        //! Ruler's surface size used for the last build.
+        wxSize m_SurfaceSize;
+
+        //! PPI value used for the last build.
+        wxRealPoint m_PixelPerInch;
+
+        //! Ruler's metrics used for the last build.
+        SRulerMetrics m_Metrics;
+
+        //! All ticks of the scale.
+        std::vector<SRenderLine> m_vTicks;
+
+        //! Scratch buffer with pixel positions of all drawn base ticks.
+        std::vector<int> m_vTickPositions;
+
+        //! All labels of the scale. The first one labels the first tick,
+        //! the last one labels the end of the ruler and label I between them
+        //! labels tick I * m_uLabelInterval.
+        std::vector<SRulerLabel> m_vLabels;
+
+        //! Ruler's scale runs from top to bottom.
+        bool m_bVertical;
+
+        //! Position of the first tick along the scale in device coordinates.
+        int m_iTickOrigin;
+
+        //! 32.32 fixed-point distance of two ticks of regular grid.
+        unsigned long long m_ullTickStep;
+
+        //! Number of ticks of regular grid. Ticks after them (ruler's end)
+        //! are always drawn.
+        size_t m_uRegularTicks;
+
+        //! Number of ticks between two labels.
+        size_t m_uLabelInterval;
+
+        //! The largest extent of label along the scale.
+        int m_iMaxLabelAlong;
+    };
+} // end namespace WinRuler
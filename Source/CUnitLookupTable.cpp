@@ -0,0 +1,146 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <algorithm>
+#include <wx/wx.h>
+#include "CUnitLookupTable.h"
+#include "WRUnitConversion.h"
+
+namespace WinRuler
+{
+    //! Table grows in blocks of this many pixels, so resizing of the ruler
+    //! does not rebuild it for every pixel.
+    static const int LookupTableBlock = 1024;
+
+    CUnitLookupTable::CUnitLookupTable() :
+        m_bValid(false),
+        m_UnitDesc(GetRulerUnitDesc(ERulerUnits::ruCentimetres)),
+        m_dPixelPerInch(0.0),
+        m_iLength(0),
+        m_ullTickStep(0)
+    {
+        // No code.
+    }
+
+    bool CUnitLookupTable::Update(
+        const SRulerUnitDesc& Desc, double PixelPerInch, int iLength)
+    {
+        // If table is valid, it was built for the same unit's scale and
+        // PPI value and it is long enough, there is nothing to do.
+        if (m_bValid &&
+            m_UnitDesc.IsSameScale(Desc) &&
+            (m_dPixelPerInch == PixelPerInch) &&
+            (iLength <= m_iLength))
+            return false;
+
+        // Table of the same configuration only grows.
+        if (!m_bValid ||
+            !m_UnitDesc.IsSameScale(Desc) ||
+            (m_dPixelPerInch != PixelPerInch))
+            m_iLength = 0;
+
+        // Store new key values.
+        m_UnitDesc = Desc;
+        m_dPixelPerInch = PixelPerInch;
+        m_iLength = std::max(
+            m_iLength,
+            ((std::max(iLength, 0) / LookupTableBlock) + 1) *
+                LookupTableBlock);
+
+        Rebuild();
+
+        m_bValid = true;
+
+        return true;
+    }
+
+    template <ERulerUnits eUnits>
+    void CUnitLookupTable::FillUnits()
+    {
+        // Table is built for PPI value along the scale, so axis of the
+        // functor does not matter.
+        const THorizontalUnitConversion<eUnits> Conversion(m_dPixelPerInch);
+        double* pUnits = m_vUnits.data();
+
+        for (int P = 0; P <= m_iLength; P++)
+            pUnits[P] = Conversion.ToUnits(P);
+    }
+
+    void CUnitLookupTable::Rebuild()
+    {
+        // Every pixel offset is converted by the conversion functor of the
+        // unit or by the conversion kernel, so loaded values are the same
+        // as values converted directly.
+        m_vUnits.resize(static_cast<size_t>(m_iLength) + 1);
+        double* pUnits = m_vUnits.data();
+
+        switch (m_UnitDesc.eUnits)
+        {
+        case ERulerUnits::ruCentimetres:
+            FillUnits<ERulerUnits::ruCentimetres>();
+
+            break;
+        case ERulerUnits::ruInches:
+            FillUnits<ERulerUnits::ruInches>();
+
+            break;
+        case ERulerUnits::ruPicas:
+            FillUnits<ERulerUnits::ruPicas>();
+
+            break;
+        case ERulerUnits::ruPixels:
+            FillUnits<ERulerUnits::ruPixels>();
+
+            break;
+        case ERulerUnits::ruMillimetres:
+            FillUnits<ERulerUnits::ruMillimetres>();
+
+            break;
+        case ERulerUnits::ruPoints:
+            FillUnits<ERulerUnits::ruPoints>();
+
+            break;
+        case ERulerUnits::ruTwips:
+            FillUnits<ERulerUnits::ruTwips>();
+
+            break;
+        default:
+            // User-defined unit is known only at run time.
+            for (int P = 0; P <= m_iLength; P++)
+                pUnits[P] =
+                    ConvertPixelsToUnits(m_UnitDesc, m_dPixelPerInch, P);
+
+            break;
+        }
+
+        // Base ticks are not tabulated. Fine units have many of them per
+        // pixel, so table of base ticks would be much larger than table of
+        // pixels, while their positions are just one multiplication.
+        m_ullTickStep = GetUnitTickStep(m_UnitDesc, m_dPixelPerInch);
+    }
+
+    double CUnitLookupTable::PixelsToUnits(int iPixels) const
+    {
+        if ((iPixels >= 0) && (iPixels <= m_iLength) && m_bValid)
+            return m_vUnits[static_cast<size_t>(iPixels)];
+
+        return ConvertPixelsToUnits(m_UnitDesc, m_dPixelPerInch, iPixels);
+    }
+
+    int CUnitLookupTable::TickToPixels(size_t Tick) const
+    {
+        return static_cast<int>((Tick * m_ullTickStep) >> 32);
+    }
+
+    unsigned long long CUnitLookupTable::GetTickStep() const
+    {
+        return m_ullTickStep;
+    }
+
+    void CUnitLookupTable::Invalidate()
+    {
+        m_bValid = false;
+    }
+} // end namespace WinRuler
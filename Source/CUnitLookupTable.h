@@ -0,0 +1,113 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <vector>
+#include <wx/wx.h>
+#include "WRRulerUnits.h"
+
+namespace WinRuler
+{
+    /**
+     * CUnitLookupTable class definition. It holds value in units of every
+     * pixel offset along the ruler for one configuration (unit of
+     * measurement and PPI value along the scale), so marker labels and
+     * scale labels convert by indexed load. Reverse conversion of base
+     * ticks to pixels is one fixed-point multiplication and it is not
+     * tabulated, so size of the table does not depend on fineness of the
+     * unit. Table is rebuilt only when unit's scale or PPI value changes,
+     * or when ruler grows beyond length of the table.
+     **/
+    class CUnitLookupTable
+    {
+    public:
+        /**
+         * Default constructor.
+         **/
+        CUnitLookupTable();
+
+        /**
+         * Rebuilds table if unit's scale or PPI value differs from values
+         * used for the last build, or if table is shorter than specified
+         * length.
+         *
+         * \param Desc          Descriptor of the unit.
+         * \param PixelPerInch  PPI value along the scale.
+         * \param iLength       Length of the ruler along the scale. Table
+         *                      covers pixel offsets from 0 to iLength.
+         *
+         * \return  Returns true if table was rebuilt, otherwise false.
+         **/
+        bool Update(
+            const SRulerUnitDesc& Desc, double PixelPerInch, int iLength);
+
+        /**
+         * Converts pixel offset along the scale to units. Offsets covered
+         * by the table are just loaded from it, others are converted by the
+         * conversion kernel.
+         *
+         * \param iPixels   Pixel offset along the scale.
+         *
+         * \return  Returns value in units.
+         **/
+        double PixelsToUnits(int iPixels) const;
+
+        /**
+         * Converts index of the base tick of the unit to its pixel offset
+         * along the scale as (Tick * GetTickStep()) >> 32.
+         *
+         * \param Tick  Index of the base tick.
+         *
+         * \return  Returns pixel offset of the base tick.
+         **/
+        int TickToPixels(size_t Tick) const;
+
+        /**
+         * Returns 32.32 fixed-point length of one base tick, see
+         * GetUnitTickStep().
+         **/
+        unsigned long long GetTickStep() const;
+
+        /**
+         * Marks table as invalid, so it will be rebuilt on the next
+         * Update() call.
+         **/
+        void Invalidate();
+    private:
+        /**
+         * Rebuilds the table for the current key values.
+         **/
+        void Rebuild();
+
+        /**
+         * Fills table of unit values with conversion functor of built-in
+         * unit, so conversion is inlined and PPI value is hoisted out of
+         * the loop.
+         *
+         * \tparam eUnits   Built-in unit of measurement of the table.
+         **/
+        template <ERulerUnits eUnits>
+        void FillUnits();
+    private:
+        //! Validity flag of the table.
+        bool m_bValid;
+
+        //! Descriptor of the unit used for the last build.
+        SRulerUnitDesc m_UnitDesc;
+
+        //! PPI value along the scale used for the last build.
+        double m_dPixelPerInch;
+
+        //! Length covered by the table.
+        int m_iLength;
+
+        //! 32.32 fixed-point length of one base tick.
+        unsigned long long m_ullTickStep;
+
+        //! Value in units of every pixel offset from 0 to m_iLength.
+        std::vector<double> m_vUnits;
+    };
+} // end namespace WinRuler
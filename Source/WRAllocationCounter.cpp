@@ -0,0 +1,128 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include "WRAllocationCounter.h"
+
+// Allocations of C runtime are counted by debug CRT's allocation hook,
+// which exists only in Debug build of MSVC.
+#if defined(WR_COUNT_ALLOCATIONS) && defined(WR_WINDOWS) &&	\
+	defined(_MSC_VER) && defined(_DEBUG)
+# define WR_COUNT_CRT_ALLOCATIONS
+#endif
+
+#ifdef WR_COUNT_ALLOCATIONS
+# include <atomic>
+# include <cstdlib>
+# include <new>
+# ifdef WR_COUNT_CRT_ALLOCATIONS
+#  include <crtdbg.h>
+# endif
+#endif
+
+#ifdef WR_COUNT_ALLOCATIONS
+namespace
+{
+	//! Number of heap allocations since start of the process.
+	std::atomic<unsigned long long> g_ullAllocationCount(0);
+}
+
+# ifdef WR_COUNT_CRT_ALLOCATIONS
+namespace
+{
+	/**
+	 * Debug CRT's allocation hook. It counts allocations and
+	 * reallocations and allows all of them.
+	 **/
+	int __cdecl AllocationHook(
+		int iAllocType, void* /*pUserData*/, size_t /*Size*/,
+		int /*iBlockType*/, long /*lRequestNumber*/,
+		const unsigned char* /*pFileName*/, int /*iLineNumber*/)
+	{
+		if ((iAllocType == _HOOK_ALLOC) || (iAllocType == _HOOK_REALLOC))
+			g_ullAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		return TRUE;
+	}
+
+	/**
+	 * Installs allocation hook during static initialisation.
+	 **/
+	struct SAllocationHookInstaller
+	{
+		SAllocationHookInstaller()
+		{
+			_CrtSetAllocHook(AllocationHook);
+		}
+	} g_AllocationHookInstaller;
+}
+# else
+void* operator new(std::size_t Size)
+{
+	g_ullAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	// Zero sized allocation must return unique pointer.
+	void* pMemory = std::malloc((Size != 0) ? Size : 1);
+	if (pMemory == nullptr)
+		throw std::bad_alloc();
+
+	return pMemory;
+}
+
+void* operator new[](std::size_t Size)
+{
+	return operator new(Size);
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t /*Size*/) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t /*Size*/) noexcept
+{
+	std::free(pMemory);
+}
+# endif
+#endif
+
+namespace WinRuler
+{
+	bool IsAllocationCountingEnabled()
+	{
+#ifdef WR_COUNT_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool IsCRuntimeAllocationCountingEnabled()
+	{
+#ifdef WR_COUNT_CRT_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	unsigned long long GetAllocationCount()
+	{
+#ifdef WR_COUNT_ALLOCATIONS
+		return g_ullAllocationCount.load(std::memory_order_relaxed);
+#else
+		return 0;
+#endif
+	}
+} // end namespace WinRuler
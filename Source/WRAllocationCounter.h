@@ -0,0 +1,37 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include "WRPlatform.h"
+
+namespace WinRuler
+{
+	/**
+	 * Returns true if heap allocations are counted (WR_COUNT_ALLOCATIONS is
+	 * defined), otherwise false.
+	 **/
+	bool IsAllocationCountingEnabled();
+
+	/**
+	 * Returns true if allocations made by C runtime (malloc) are counted
+	 * too, otherwise only C++ allocations (operator new) are counted.
+	 **/
+	bool IsCRuntimeAllocationCountingEnabled();
+
+	/**
+	 * Returns number of heap allocations made by the process since its
+	 * start. Allocations are counted only if WR_COUNT_ALLOCATIONS is defined,
+	 * otherwise 0 is returned.
+	 *
+	 * \note	In Debug build of MSVC allocations are counted by debug CRT's
+	 *			allocation hook, so malloc and allocations made by
+	 *			wxWidgets' DLLs sharing the CRT are counted too. Otherwise
+	 *			global operator new is replaced and only C++ allocations
+	 *			are counted. Allocations made by C libraries (e.g. malloc
+	 *			and g_malloc of GTK, Cairo and Pango) are not counted.
+	 **/
+	unsigned long long GetAllocationCount();
+} // end namespace WinRuler
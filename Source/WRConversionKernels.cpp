@@ -0,0 +1,241 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cmath>
+#include <algorithm>
+#include "WRConversionKernels.h"
+
+#ifdef WR_X86
+# include <immintrin.h>
+#endif
+
+namespace WinRuler
+{
+	namespace
+	{
+		/*---------------------------------------------------------------------
+		  Scalar kernels.
+		---------------------------------------------------------------------*/
+
+		void PixelsToUnitsScalar(
+			const int* pPixels, double* pUnits, size_t uCount,
+			double dNumerator, double dDenominator)
+		{
+			for (size_t I = 0; I < uCount; I++)
+				pUnits[I] =
+					(static_cast<double>(pPixels[I]) * dNumerator) /
+					dDenominator;
+		}
+
+		void UnitsToPixelsScalar(
+			const double* pUnits, int* pPixels, size_t uCount,
+			double dMultiplier1, double dMultiplier2, double dDivisor)
+		{
+			for (size_t I = 0; I < uCount; I++)
+				pPixels[I] =
+					static_cast<int>(
+						std::trunc(
+							((pUnits[I] * dMultiplier1) * dMultiplier2) /
+							dDivisor));
+		}
+
+		const SConversionKernels ScalarKernels =
+		{
+			PixelsToUnitsScalar,
+			UnitsToPixelsScalar,
+			pkScalar,
+			wxT("scalar")
+		};
+
+#ifdef WR_X86
+		/*---------------------------------------------------------------------
+		  SSE2 kernels (4 values per step).
+		---------------------------------------------------------------------*/
+
+		WR_TARGET("sse2")
+		void PixelsToUnitsSSE2(
+			const int* pPixels, double* pUnits, size_t uCount,
+			double dNumerator, double dDenominator)
+		{
+			const __m128d Numerator = _mm_set1_pd(dNumerator);
+			const __m128d Denominator = _mm_set1_pd(dDenominator);
+
+			size_t I = 0;
+			for (; I + 4 <= uCount; I += 4)
+			{
+				// Conversion of int to double is exact, so lanes hold the
+				// same values as scalar code.
+				__m128i Pixels =
+					_mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(pPixels + I));
+				__m128d Lo = _mm_cvtepi32_pd(Pixels);
+				__m128d Hi =
+					_mm_cvtepi32_pd(
+						_mm_shuffle_epi32(Pixels, _MM_SHUFFLE(3, 2, 3, 2)));
+
+				_mm_storeu_pd(
+					pUnits + I,
+					_mm_div_pd(_mm_mul_pd(Lo, Numerator), Denominator));
+				_mm_storeu_pd(
+					pUnits + I + 2,
+					_mm_div_pd(_mm_mul_pd(Hi, Numerator), Denominator));
+			}
+
+			PixelsToUnitsScalar(
+				pPixels + I, pUnits + I, uCount - I, dNumerator, dDenominator);
+		}
+
+		WR_TARGET("sse2")
+		void UnitsToPixelsSSE2(
+			const double* pUnits, int* pPixels, size_t uCount,
+			double dMultiplier1, double dMultiplier2, double dDivisor)
+		{
+			const __m128d Multiplier1 = _mm_set1_pd(dMultiplier1);
+			const __m128d Multiplier2 = _mm_set1_pd(dMultiplier2);
+			const __m128d Divisor = _mm_set1_pd(dDivisor);
+
+			size_t I = 0;
+			for (; I + 4 <= uCount; I += 4)
+			{
+				__m128d Lo = _mm_loadu_pd(pUnits + I);
+				__m128d Hi = _mm_loadu_pd(pUnits + I + 2);
+
+				Lo =
+					_mm_div_pd(
+						_mm_mul_pd(_mm_mul_pd(Lo, Multiplier1), Multiplier2),
+						Divisor);
+				Hi =
+					_mm_div_pd(
+						_mm_mul_pd(_mm_mul_pd(Hi, Multiplier1), Multiplier2),
+						Divisor);
+
+				// Conversion with truncation is the same as std::trunc
+				// followed by cast for all values which fit int.
+				_mm_storeu_si128(
+					reinterpret_cast<__m128i*>(pPixels + I),
+					_mm_unpacklo_epi64(
+						_mm_cvttpd_epi32(Lo), _mm_cvttpd_epi32(Hi)));
+			}
+
+			UnitsToPixelsScalar(
+				pUnits + I, pPixels + I, uCount - I,
+				dMultiplier1, dMultiplier2, dDivisor);
+		}
+
+		const SConversionKernels SSE2Kernels =
+		{
+			PixelsToUnitsSSE2,
+			UnitsToPixelsSSE2,
+			pkSSE2,
+			wxT("SSE2")
+		};
+
+		/*---------------------------------------------------------------------
+		  AVX2 kernels (8 values per step).
+		---------------------------------------------------------------------*/
+
+		WR_TARGET("avx2")
+		void PixelsToUnitsAVX2(
+			const int* pPixels, double* pUnits, size_t uCount,
+			double dNumerator, double dDenominator)
+		{
+			const __m256d Numerator = _mm256_set1_pd(dNumerator);
+			const __m256d Denominator = _mm256_set1_pd(dDenominator);
+
+			size_t I = 0;
+			for (; I + 8 <= uCount; I += 8)
+			{
+				__m256i Pixels =
+					_mm256_loadu_si256(
+						reinterpret_cast<const __m256i*>(pPixels + I));
+				__m256d Lo =
+					_mm256_cvtepi32_pd(_mm256_castsi256_si128(Pixels));
+				__m256d Hi =
+					_mm256_cvtepi32_pd(_mm256_extracti128_si256(Pixels, 1));
+
+				_mm256_storeu_pd(
+					pUnits + I,
+					_mm256_div_pd(_mm256_mul_pd(Lo, Numerator), Denominator));
+				_mm256_storeu_pd(
+					pUnits + I + 4,
+					_mm256_div_pd(_mm256_mul_pd(Hi, Numerator), Denominator));
+			}
+
+			PixelsToUnitsScalar(
+				pPixels + I, pUnits + I, uCount - I, dNumerator, dDenominator);
+		}
+
+		WR_TARGET("avx2")
+		void UnitsToPixelsAVX2(
+			const double* pUnits, int* pPixels, size_t uCount,
+			double dMultiplier1, double dMultiplier2, double dDivisor)
+		{
+			const __m256d Multiplier1 = _mm256_set1_pd(dMultiplier1);
+			const __m256d Multiplier2 = _mm256_set1_pd(dMultiplier2);
+			const __m256d Divisor = _mm256_set1_pd(dDivisor);
+
+			size_t I = 0;
+			for (; I + 8 <= uCount; I += 8)
+			{
+				__m256d Lo = _mm256_loadu_pd(pUnits + I);
+				__m256d Hi = _mm256_loadu_pd(pUnits + I + 4);
+
+				Lo =
+					_mm256_div_pd(
+						_mm256_mul_pd(
+							_mm256_mul_pd(Lo, Multiplier1), Multiplier2),
+						Divisor);
+				Hi =
+					_mm256_div_pd(
+						_mm256_mul_pd(
+							_mm256_mul_pd(Hi, Multiplier1), Multiplier2),
+						Divisor);
+
+				_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(pPixels + I),
+					_mm256_inserti128_si256(
+						_mm256_castsi128_si256(_mm256_cvttpd_epi32(Lo)),
+						_mm256_cvttpd_epi32(Hi), 1));
+			}
+
+			UnitsToPixelsScalar(
+				pUnits + I, pPixels + I, uCount - I,
+				dMultiplier1, dMultiplier2, dDivisor);
+		}
+
+		const SConversionKernels AVX2Kernels =
+		{
+			PixelsToUnitsAVX2,
+			UnitsToPixelsAVX2,
+			pkAVX2,
+			wxT("AVX2")
+		};
+#endif
+	}
+
+	const SConversionKernels& GetConversionKernels(EPixelKernelLevel eLevel)
+	{
+		eLevel = std::min(eLevel, GetSupportedPixelKernelLevel());
+
+#ifdef WR_X86
+		switch (eLevel)
+		{
+		case EPixelKernelLevel::pkAVX2:
+			return AVX2Kernels;
+		case EPixelKernelLevel::pkSSE2:
+			return SSE2Kernels;
+		case EPixelKernelLevel::pkScalar:
+			break;
+		}
+#endif
+
+		return ScalarKernels;
+	}
+
+	const SConversionKernels& GetConversionKernels()
+	{
+		return GetConversionKernels(GetSupportedPixelKernelLevel());
+	}
+} // end namespace WinRuler
@@ -0,0 +1,74 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "WRPlatform.h"
+#include "WRPixelKernels.h"
+
+namespace WinRuler
+{
+	/**
+	 * Set of unit conversion kernels for one instruction set. Kernels
+	 * convert whole spans of values with factors prepared by caller. Every
+	 * value goes through the same IEEE operations in the same order on all
+	 * instruction sets, so all kernels of all sets produce bit-identical
+	 * results, equal to the scalar conversion kernel of the unit registry.
+	 **/
+	struct SConversionKernels
+	{
+		/**
+		 * Converts span of pixel distances to units as
+		 * (Pixels * dNumerator) / dDenominator.
+		 *
+		 * \param pPixels		First distance in pixels.
+		 * \param pUnits		Receives distances in units.
+		 * \param uCount		Number of distances of the span.
+		 * \param dNumerator	Numerator of the conversion factor.
+		 * \param dDenominator	Denominator of the conversion factor.
+		 **/
+		void (*pPixelsToUnits)(
+			const int* pPixels, double* pUnits, size_t uCount,
+			double dNumerator, double dDenominator);
+
+		/**
+		 * Converts span of distances in units to pixels as
+		 * ((Units * dMultiplier1) * dMultiplier2) / dDivisor truncated
+		 * towards zero. Results must fit int.
+		 *
+		 * \param pUnits		First distance in units.
+		 * \param pPixels		Receives distances in whole pixels.
+		 * \param uCount		Number of distances of the span.
+		 * \param dMultiplier1	The first multiplier.
+		 * \param dMultiplier2	The second multiplier.
+		 * \param dDivisor		The divisor.
+		 **/
+		void (*pUnitsToPixels)(
+			const double* pUnits, int* pPixels, size_t uCount,
+			double dMultiplier1, double dMultiplier2, double dDivisor);
+
+		//! Instruction set of the kernels.
+		EPixelKernelLevel eLevel;
+
+		//! Human readable name of the instruction set.
+		const wxChar* Name;
+	};
+
+	/**
+	 * Returns conversion kernels for specified instruction set. If it is
+	 * not supported, the best supported one is used instead.
+	 *
+	 * \param eLevel	Requested instruction set.
+	 *
+	 * \return	Returns reference to static set of kernels.
+	 **/
+	const SConversionKernels& GetConversionKernels(EPixelKernelLevel eLevel);
+
+	/**
+	 * Returns conversion kernels for the best supported instruction set.
+	 **/
+	const SConversionKernels& GetConversionKernels();
+} // end namespace WinRuler
@@ -0,0 +1,519 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <cstring>
+#include <algorithm>
+#include "WRPixelKernels.h"
+
+#ifdef WR_X86
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+# include <immintrin.h>
+#endif
+
+namespace WinRuler
+{
+	namespace
+	{
+		/**
+		 * Per channel 16.16 fixed-point state of linear gradient.
+		 **/
+		struct SGradientState
+		{
+			//! Value of red, green and blue channel of the first pixel.
+			wxInt32 aValue[3];
+
+			//! Increment of red, green and blue channel per pixel.
+			wxInt32 aStep[3];
+		};
+
+		/**
+		 * Prepares gradient's state for its pixel uFirst. Channels are
+		 * rounded by bias of half of the unit, so they are converted to
+		 * bytes by shift.
+		 **/
+		void SetupGradient(
+			wxUint32 uStart, wxUint32 uEnd, size_t uFirst, size_t uTotal,
+			SGradientState& State)
+		{
+			wxInt32 iSteps =
+				static_cast<wxInt32>(std::max<size_t>(uTotal, 2) - 1);
+
+			for (int C = 0; C < 3; C++)
+			{
+				int iShift = 16 - (8 * C);
+				wxInt32 iStart =
+					static_cast<wxInt32>((uStart >> iShift) & 0xFF);
+				wxInt32 iEnd =
+					static_cast<wxInt32>((uEnd >> iShift) & 0xFF);
+
+				State.aStep[C] = ((iEnd - iStart) * 65536) / iSteps;
+				State.aValue[C] =
+					(iStart * 65536) + 32768 +
+					(State.aStep[C] * static_cast<wxInt32>(uFirst));
+			}
+		}
+
+		/**
+		 * Packs 16.16 fixed-point channels into opaque pixel.
+		 **/
+		inline wxUint32 PackGradient(
+			wxInt32 iRed, wxInt32 iGreen, wxInt32 iBlue)
+		{
+			return 0xFF000000u |
+				((static_cast<wxUint32>(iRed) >> 16) << 16) |
+				((static_cast<wxUint32>(iGreen) >> 16) << 8) |
+				(static_cast<wxUint32>(iBlue) >> 16);
+		}
+
+		/**
+		 * Blends one channel: (Src * A + Dst * (255 - A)) / 255, rounded.
+		 **/
+		inline wxUint32 BlendChannel(wxUint32 uSrc, wxUint32 uDst, wxUint32 uA)
+		{
+			wxUint32 X = (uSrc * uA) + (uDst * (255 - uA)) + 128;
+
+			return (X + (X >> 8)) >> 8;
+		}
+
+		/*---------------------------------------------------------------------
+		  Scalar kernels.
+		---------------------------------------------------------------------*/
+
+		void FillSpanScalar(wxUint32* pDst, size_t uCount, wxUint32 uColour)
+		{
+			for (size_t I = 0; I < uCount; I++)
+				pDst[I] = uColour;
+		}
+
+		void FillGradientSpanScalar(
+			wxUint32* pDst, size_t uCount, wxUint32 uStart, wxUint32 uEnd,
+			size_t uFirst, size_t uTotal)
+		{
+			SGradientState State;
+			SetupGradient(uStart, uEnd, uFirst, uTotal, State);
+
+			for (size_t I = 0; I < uCount; I++)
+			{
+				pDst[I] =
+					PackGradient(
+						State.aValue[0], State.aValue[1], State.aValue[2]);
+
+				State.aValue[0] += State.aStep[0];
+				State.aValue[1] += State.aStep[1];
+				State.aValue[2] += State.aStep[2];
+			}
+		}
+
+		void BlendCoverageSpanScalar(
+			wxUint32* pDst, const wxByte* pCoverage, size_t uCount,
+			wxUint32 uColour)
+		{
+			for (size_t I = 0; I < uCount; I++)
+			{
+				wxUint32 uA = pCoverage[I];
+				if (uA == 0)
+					continue;
+
+				wxUint32 uDst = pDst[I];
+				wxUint32 uRed =
+					BlendChannel(
+						(uColour >> 16) & 0xFF, (uDst >> 16) & 0xFF, uA);
+				wxUint32 uGreen =
+					BlendChannel(
+						(uColour >> 8) & 0xFF, (uDst >> 8) & 0xFF, uA);
+				wxUint32 uBlue = BlendChannel(uColour & 0xFF, uDst & 0xFF, uA);
+
+				pDst[I] = 0xFF000000u | (uRed << 16) | (uGreen << 8) | uBlue;
+			}
+		}
+
+		const SPixelKernels ScalarKernels =
+		{
+			FillSpanScalar,
+			FillGradientSpanScalar,
+			BlendCoverageSpanScalar,
+			pkScalar,
+			wxT("scalar")
+		};
+
+#ifdef WR_X86
+		/*---------------------------------------------------------------------
+		  SSE2 kernels (4 pixels per step).
+		---------------------------------------------------------------------*/
+
+		WR_TARGET("sse2")
+		void FillSpanSSE2(wxUint32* pDst, size_t uCount, wxUint32 uColour)
+		{
+			__m128i Colour = _mm_set1_epi32(static_cast<int>(uColour));
+
+			size_t I = 0;
+			for (; I + 4 <= uCount; I += 4)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + I), Colour);
+
+			FillSpanScalar(pDst + I, uCount - I, uColour);
+		}
+
+		WR_TARGET("sse2")
+		void FillGradientSpanSSE2(
+			wxUint32* pDst, size_t uCount, wxUint32 uStart, wxUint32 uEnd,
+			size_t uFirst, size_t uTotal)
+		{
+			SGradientState State;
+			SetupGradient(uStart, uEnd, uFirst, uTotal, State);
+
+			// Every lane holds one pixel, channels are in separate vectors.
+			__m128i aValue[3], aStep[3];
+			for (int C = 0; C < 3; C++)
+			{
+				wxInt32 V = State.aValue[C], S = State.aStep[C];
+				aValue[C] = _mm_setr_epi32(V, V + S, V + (2 * S), V + (3 * S));
+				aStep[C] = _mm_set1_epi32(4 * S);
+			}
+
+			__m128i Alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+			size_t I = 0;
+			for (; I + 4 <= uCount; I += 4)
+			{
+				__m128i Pixels =
+					_mm_or_si128(
+						_mm_or_si128(
+							Alpha,
+							_mm_slli_epi32(_mm_srli_epi32(aValue[0], 16), 16)),
+						_mm_or_si128(
+							_mm_slli_epi32(_mm_srli_epi32(aValue[1], 16), 8),
+							_mm_srli_epi32(aValue[2], 16)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + I), Pixels);
+
+				aValue[0] = _mm_add_epi32(aValue[0], aStep[0]);
+				aValue[1] = _mm_add_epi32(aValue[1], aStep[1]);
+				aValue[2] = _mm_add_epi32(aValue[2], aStep[2]);
+			}
+
+			FillGradientSpanScalar(
+				pDst + I, uCount - I, uStart, uEnd, uFirst + I, uTotal);
+		}
+
+		WR_TARGET("sse2")
+		void BlendCoverageSpanSSE2(
+			wxUint32* pDst, const wxByte* pCoverage, size_t uCount,
+			wxUint32 uColour)
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i C128 = _mm_set1_epi16(128);
+			const __m128i C255 = _mm_set1_epi16(255);
+			const __m128i Alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+			// Colour's channels widened to 16 bits, two pixels per vector.
+			const __m128i Src =
+				_mm_unpacklo_epi8(
+					_mm_set1_epi32(static_cast<int>(uColour)), Zero);
+
+			size_t I = 0;
+			for (; I + 4 <= uCount; I += 4)
+			{
+				wxUint32 uCoverage;
+				std::memcpy(&uCoverage, pCoverage + I, sizeof(uCoverage));
+
+				// Fully transparent pixels are the most common ones.
+				if (uCoverage == 0)
+					continue;
+
+				// Replicate coverage of every pixel to its four channels.
+				__m128i A =
+					_mm_unpacklo_epi8(
+						_mm_cvtsi32_si128(static_cast<int>(uCoverage)), Zero);
+				A = _mm_unpacklo_epi16(A, A);
+				__m128i ALo = _mm_unpacklo_epi32(A, A);
+				__m128i AHi = _mm_unpackhi_epi32(A, A);
+
+				__m128i Dst =
+					_mm_loadu_si128(reinterpret_cast<__m128i*>(pDst + I));
+				__m128i DLo = _mm_unpacklo_epi8(Dst, Zero);
+				__m128i DHi = _mm_unpackhi_epi8(Dst, Zero);
+
+				// Src * A + Dst * (255 - A) fits 16 bits, divide it by 255
+				// with rounding.
+				__m128i XLo =
+					_mm_add_epi16(
+						_mm_add_epi16(
+							_mm_mullo_epi16(Src, ALo),
+							_mm_mullo_epi16(DLo, _mm_sub_epi16(C255, ALo))),
+						C128);
+				__m128i XHi =
+					_mm_add_epi16(
+						_mm_add_epi16(
+							_mm_mullo_epi16(Src, AHi),
+							_mm_mullo_epi16(DHi, _mm_sub_epi16(C255, AHi))),
+						C128);
+				XLo =
+					_mm_srli_epi16(
+						_mm_add_epi16(XLo, _mm_srli_epi16(XLo, 8)), 8);
+				XHi =
+					_mm_srli_epi16(
+						_mm_add_epi16(XHi, _mm_srli_epi16(XHi, 8)), 8);
+
+				_mm_storeu_si128(
+					reinterpret_cast<__m128i*>(pDst + I),
+					_mm_or_si128(_mm_packus_epi16(XLo, XHi), Alpha));
+			}
+
+			BlendCoverageSpanScalar(
+				pDst + I, pCoverage + I, uCount - I, uColour);
+		}
+
+		const SPixelKernels SSE2Kernels =
+		{
+			FillSpanSSE2,
+			FillGradientSpanSSE2,
+			BlendCoverageSpanSSE2,
+			pkSSE2,
+			wxT("SSE2")
+		};
+
+		/*---------------------------------------------------------------------
+		  AVX2 kernels (8 pixels per step).
+		---------------------------------------------------------------------*/
+
+		WR_TARGET("avx2")
+		void FillSpanAVX2(wxUint32* pDst, size_t uCount, wxUint32 uColour)
+		{
+			__m256i Colour = _mm256_set1_epi32(static_cast<int>(uColour));
+
+			size_t I = 0;
+			for (; I + 8 <= uCount; I += 8)
+				_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(pDst + I), Colour);
+
+			FillSpanScalar(pDst + I, uCount - I, uColour);
+		}
+
+		WR_TARGET("avx2")
+		void FillGradientSpanAVX2(
+			wxUint32* pDst, size_t uCount, wxUint32 uStart, wxUint32 uEnd,
+			size_t uFirst, size_t uTotal)
+		{
+			SGradientState State;
+			SetupGradient(uStart, uEnd, uFirst, uTotal, State);
+
+			// Every lane holds one pixel, channels are in separate vectors.
+			__m256i aValue[3], aStep[3];
+			for (int C = 0; C < 3; C++)
+			{
+				wxInt32 V = State.aValue[C], S = State.aStep[C];
+				aValue[C] =
+					_mm256_add_epi32(
+						_mm256_set1_epi32(V),
+						_mm256_mullo_epi32(
+							_mm256_set1_epi32(S),
+							_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+				aStep[C] = _mm256_set1_epi32(8 * S);
+			}
+
+			__m256i Alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+			size_t I = 0;
+			for (; I + 8 <= uCount; I += 8)
+			{
+				__m256i Pixels =
+					_mm256_or_si256(
+						_mm256_or_si256(
+							Alpha,
+							_mm256_slli_epi32(
+								_mm256_srli_epi32(aValue[0], 16), 16)),
+						_mm256_or_si256(
+							_mm256_slli_epi32(
+								_mm256_srli_epi32(aValue[1], 16), 8),
+							_mm256_srli_epi32(aValue[2], 16)));
+				_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(pDst + I), Pixels);
+
+				aValue[0] = _mm256_add_epi32(aValue[0], aStep[0]);
+				aValue[1] = _mm256_add_epi32(aValue[1], aStep[1]);
+				aValue[2] = _mm256_add_epi32(aValue[2], aStep[2]);
+			}
+
+			FillGradientSpanScalar(
+				pDst + I, uCount - I, uStart, uEnd, uFirst + I, uTotal);
+		}
+
+		WR_TARGET("avx2")
+		void BlendCoverageSpanAVX2(
+			wxUint32* pDst, const wxByte* pCoverage, size_t uCount,
+			wxUint32 uColour)
+		{
+			const __m256i Zero = _mm256_setzero_si256();
+			const __m256i C128 = _mm256_set1_epi16(128);
+			const __m256i C255 = _mm256_set1_epi16(255);
+			const __m256i Alpha =
+				_mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+			// Colour's channels widened to 16 bits, two pixels per lane.
+			const __m256i Src =
+				_mm256_unpacklo_epi8(
+					_mm256_set1_epi32(static_cast<int>(uColour)), Zero);
+
+			size_t I = 0;
+			for (; I + 8 <= uCount; I += 8)
+			{
+				wxUint64 uCoverage;
+				std::memcpy(&uCoverage, pCoverage + I, sizeof(uCoverage));
+
+				// Fully transparent pixels are the most common ones.
+				if (uCoverage == 0)
+					continue;
+
+				__m128i Coverage =
+					_mm_loadl_epi64(
+						reinterpret_cast<const __m128i*>(pCoverage + I));
+
+				// Replicate coverage of every pixel to its four channels.
+				// Unpacking works inside 128-bit lanes, so pixels 0 - 3 are
+				// in the low lane and pixels 4 - 7 in the high one.
+				__m256i A = _mm256_cvtepu8_epi32(Coverage);
+				A = _mm256_or_si256(A, _mm256_slli_epi32(A, 16));
+				__m256i ALo = _mm256_unpacklo_epi32(A, A);
+				__m256i AHi = _mm256_unpackhi_epi32(A, A);
+
+				__m256i Dst =
+					_mm256_loadu_si256(reinterpret_cast<__m256i*>(pDst + I));
+				__m256i DLo = _mm256_unpacklo_epi8(Dst, Zero);
+				__m256i DHi = _mm256_unpackhi_epi8(Dst, Zero);
+
+				// Src * A + Dst * (255 - A) fits 16 bits, divide it by 255
+				// with rounding.
+				__m256i XLo =
+					_mm256_add_epi16(
+						_mm256_add_epi16(
+							_mm256_mullo_epi16(Src, ALo),
+							_mm256_mullo_epi16(
+								DLo, _mm256_sub_epi16(C255, ALo))),
+						C128);
+				__m256i XHi =
+					_mm256_add_epi16(
+						_mm256_add_epi16(
+							_mm256_mullo_epi16(Src, AHi),
+							_mm256_mullo_epi16(
+								DHi, _mm256_sub_epi16(C255, AHi))),
+						C128);
+				XLo =
+					_mm256_srli_epi16(
+						_mm256_add_epi16(XLo, _mm256_srli_epi16(XLo, 8)), 8);
+				XHi =
+					_mm256_srli_epi16(
+						_mm256_add_epi16(XHi, _mm256_srli_epi16(XHi, 8)), 8);
+
+				_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(pDst + I),
+					_mm256_or_si256(_mm256_packus_epi16(XLo, XHi), Alpha));
+			}
+
+			BlendCoverageSpanScalar(
+				pDst + I, pCoverage + I, uCount - I, uColour);
+		}
+
+		const SPixelKernels AVX2Kernels =
+		{
+			FillSpanAVX2,
+			FillGradientSpanAVX2,
+			BlendCoverageSpanAVX2,
+			pkAVX2,
+			wxT("AVX2")
+		};
+#endif
+
+		/**
+		 * Detects the best instruction set supported by CPU and operating
+		 * system.
+		 **/
+		EPixelKernelLevel DetectPixelKernelLevel()
+		{
+#if defined(WR_X86) && defined(_MSC_VER)
+			int aInfo[4];
+
+			__cpuid(aInfo, 0);
+			int iMaxLeaf = aInfo[0];
+
+			__cpuid(aInfo, 1);
+			bool bSSE2 = (aInfo[3] & (1 << 26)) != 0;
+
+			// AVX registers must be enabled by operating system (OSXSAVE
+			// and XCR0 bits of XMM and YMM state).
+			bool bAVX =
+				((aInfo[2] & (1 << 27)) != 0) &&
+				((aInfo[2] & (1 << 28)) != 0) &&
+				((_xgetbv(0) & 6) == 6);
+
+			bool bAVX2 = false;
+			if (bAVX && (iMaxLeaf >= 7))
+			{
+				__cpuidex(aInfo, 7, 0);
+				bAVX2 = (aInfo[1] & (1 << 5)) != 0;
+			}
+
+			if (bAVX2)
+				return pkAVX2;
+			if (bSSE2)
+				return pkSSE2;
+
+			return pkScalar;
+#elif defined(WR_X86)
+			// It checks operating system's support of AVX registers too.
+			__builtin_cpu_init();
+
+			if (__builtin_cpu_supports("avx2"))
+				return pkAVX2;
+			if (__builtin_cpu_supports("sse2"))
+				return pkSSE2;
+
+			return pkScalar;
+#else
+			return pkScalar;
+#endif
+		}
+	}
+
+	EPixelKernelLevel GetSupportedPixelKernelLevel()
+	{
+		static const EPixelKernelLevel eLevel = DetectPixelKernelLevel();
+
+		return eLevel;
+	}
+
+	const SPixelKernels& GetPixelKernels(EPixelKernelLevel eLevel)
+	{
+		eLevel = std::min(eLevel, GetSupportedPixelKernelLevel());
+
+#ifdef WR_X86
+		switch (eLevel)
+		{
+		case EPixelKernelLevel::pkAVX2:
+			return AVX2Kernels;
+		case EPixelKernelLevel::pkSSE2:
+			return SSE2Kernels;
+		case EPixelKernelLevel::pkScalar:
+			break;
+		}
+#endif
+
+		return ScalarKernels;
+	}
+
+	const SPixelKernels& GetPixelKernels()
+	{
+		return GetPixelKernels(GetSupportedPixelKernelLevel());
+	}
+
+	wxUint32 GetGradientPixel(
+		wxUint32 uStart, wxUint32 uEnd, size_t uIndex, size_t uTotal)
+	{
+		SGradientState State;
+		SetupGradient(uStart, uEnd, uIndex, uTotal, State);
+
+		return PackGradient(State.aValue[0], State.aValue[1], State.aValue[2]);
+	}
+} // end namespace WinRuler
@@ -0,0 +1,128 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "WRPlatform.h"
+
+namespace WinRuler
+{
+	/**
+	 * Instruction set used by pixel kernels.
+	 **/
+	typedef enum EPixelKernelLevel
+	{
+		//! Portable scalar code.
+		pkScalar,
+
+		//! SSE2 code (4 pixels per step).
+		pkSSE2,
+
+		//! AVX2 code (8 pixels per step).
+		pkAVX2
+	} EPixelKernelLevel;
+
+	/**
+	 * Set of pixel kernels for one instruction set. Pixels are 32-bit
+	 * 0xAARRGGBB values. All kernels of all sets produce bit-exact results.
+	 **/
+	struct SPixelKernels
+	{
+		/**
+		 * Fills span of pixels with solid colour.
+		 *
+		 * \param pDst		First pixel of the span.
+		 * \param uCount	Number of pixels of the span.
+		 * \param uColour	The colour.
+		 **/
+		void (*pFillSpan)(wxUint32* pDst, size_t uCount, wxUint32 uColour);
+
+		/**
+		 * Fills span of pixels with linear gradient. Gradient runs over
+		 * uTotal pixels from start to end colour and span covers its pixels
+		 * from uFirst, so gradient can be drawn clipped.
+		 *
+		 * \param pDst		First pixel of the span.
+		 * \param uCount	Number of pixels of the span.
+		 * \param uStart	The start colour of the gradient.
+		 * \param uEnd		The end colour of the gradient.
+		 * \param uFirst	Index of span's first pixel in the gradient.
+		 * \param uTotal	Length of the whole gradient in pixels.
+		 **/
+		void (*pFillGradientSpan)(
+			wxUint32* pDst, size_t uCount, wxUint32 uStart, wxUint32 uEnd,
+			size_t uFirst, size_t uTotal);
+
+		/**
+		 * Blends solid colour over span of pixels with 8-bit coverage (for
+		 * example rasterised text). Destination stays opaque.
+		 *
+		 * \param pDst		First pixel of the span.
+		 * \param pCoverage	Coverage of every pixel of the span (0 - 255).
+		 * \param uCount	Number of pixels of the span.
+		 * \param uColour	The colour.
+		 **/
+		void (*pBlendCoverageSpan)(
+			wxUint32* pDst, const wxByte* pCoverage, size_t uCount,
+			wxUint32 uColour);
+
+		//! Instruction set of the kernels.
+		EPixelKernelLevel eLevel;
+
+		//! Human readable name of the instruction set.
+		const wxChar* Name;
+	};
+
+	/**
+	 * Returns the best instruction set supported by CPU and operating
+	 * system. It is detected once, on the first call.
+	 **/
+	EPixelKernelLevel GetSupportedPixelKernelLevel();
+
+	/**
+	 * Returns pixel kernels for specified instruction set. If it is not
+	 * supported, the best supported one is used instead.
+	 *
+	 * \param eLevel	Requested instruction set.
+	 *
+	 * \return	Returns reference to static set of kernels.
+	 **/
+	const SPixelKernels& GetPixelKernels(EPixelKernelLevel eLevel);
+
+	/**
+	 * Returns pixel kernels for the best supported instruction set.
+	 **/
+	const SPixelKernels& GetPixelKernels();
+
+	/**
+	 * Packs colour into opaque 0xAARRGGBB pixel.
+	 *
+	 * \param Colour	The colour.
+	 *
+	 * \return	Returns packed pixel.
+	 **/
+	inline wxUint32 PackPixel(const wxColour& Colour)
+	{
+		return 0xFF000000u |
+			(static_cast<wxUint32>(Colour.Red()) << 16) |
+			(static_cast<wxUint32>(Colour.Green()) << 8) |
+			static_cast<wxUint32>(Colour.Blue());
+	}
+
+	/**
+	 * Returns colour of single pixel of linear gradient. Result is the same
+	 * as the one of pFillGradientSpan kernel.
+	 *
+	 * \param uStart	The start colour of the gradient.
+	 * \param uEnd		The end colour of the gradient.
+	 * \param uIndex	Index of the pixel in the gradient.
+	 * \param uTotal	Length of the whole gradient in pixels.
+	 *
+	 * \return	Returns packed pixel.
+	 **/
+	wxUint32 GetGradientPixel(
+		wxUint32 uStart, wxUint32 uEnd, size_t uIndex, size_t uTotal);
+} // end namespace WinRuler
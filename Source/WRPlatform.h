@@ -19,3 +19,23 @@
 // If platform is not supported.
 # error "Unsupported platform!"
 #endif
+
+// If architecture is x86 or x86-64. SSE2 and AVX2 pixel and conversion
+// kernels are built for it and selected at runtime by CPU features.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) ||	\
+	defined(__i386__)
+# define WR_X86
+#endif
+
+// GCC and Clang compile intrinsics of instruction sets above the target
+// only in functions marked with target attribute. MSVC does not need it.
+#if defined(WR_X86) && (defined(__GNUC__) || defined(__clang__))
+# define WR_TARGET(Target) __attribute__((target(Target)))
+#else
+# define WR_TARGET(Target)
+#endif
+
+// Heap allocations are counted only if WR_COUNT_ALLOCATIONS is defined by
+// the build (e.g. -DWR_COUNT_ALLOCATIONS), because counter replaces global
+// operator new. Counter is used only by the render benchmark to verify that
+// steady-state repaint does not allocate.
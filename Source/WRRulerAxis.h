@@ -0,0 +1,161 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "WRRulerMetrics.h"
+
+namespace WinRuler
+{
+	/**
+	 * Axis policy of the ruler, resolved at compile time. Rendering kernels
+	 * work in axis coordinates: "along" is distance measured along the
+	 * ruler's scale and "across" is distance from the scale's edge towards
+	 * the opposite edge of the ruler. Policy maps those coordinates to device
+	 * coordinates of ruler's surface and selects PPI direction used for unit
+	 * conversion, so every ruler's position gets its own fully inlined
+	 * specialization of the kernel.
+	 **/
+	template <ERulerPosition Position>
+	struct TRulerAxis
+	{
+		//! Ruler's scale runs from top to bottom.
+		static constexpr bool bVertical =
+			(Position == ERulerPosition::rpLeft) ||
+			(Position == ERulerPosition::rpRight);
+
+		//! Ruler's scale is on right or bottom edge, so across coordinates
+		//! grow towards left or top.
+		static constexpr bool bMirrored =
+			(Position == ERulerPosition::rpRight) ||
+			(Position == ERulerPosition::rpBottom);
+
+		/**
+		 * Returns across offset of the first and the last label of the
+		 * scale. On horizontal rulers text cell's internal leading already
+		 * separates label from the tick, so its offset is smaller.
+		 **/
+		static int GetEndLabelOffset(const SRulerMetrics& Metrics)
+		{
+			return bVertical ?
+				Metrics.iEndLabelOffsetVertical :
+				Metrics.iEndLabelOffsetHorizontal;
+		}
+
+		/**
+		 * Returns length of the ruler's surface along the scale.
+		 **/
+		static int GetLength(const wxRect& SurfaceRect)
+		{
+			return bVertical ? SurfaceRect.GetHeight() : SurfaceRect.GetWidth();
+		}
+
+		/**
+		 * Returns thickness of the ruler's surface across the scale.
+		 **/
+		static int GetThickness(const wxRect& SurfaceRect)
+		{
+			return bVertical ? SurfaceRect.GetWidth() : SurfaceRect.GetHeight();
+		}
+
+		/**
+		 * Returns size of the extent along the scale.
+		 **/
+		static int GetAlong(const wxSize& Extent)
+		{
+			return bVertical ? Extent.GetHeight() : Extent.GetWidth();
+		}
+
+		/**
+		 * Returns size of the extent across the scale.
+		 **/
+		static int GetAcross(const wxSize& Extent)
+		{
+			return bVertical ? Extent.GetWidth() : Extent.GetHeight();
+		}
+
+		/**
+		 * Maps line perpendicular to the scale to device coordinates.
+		 * Returned points are ordered, so the line covers across range
+		 * [iFrom, iTo) on every ruler's position.
+		 *
+		 * \param SurfaceRect	The rectangle of ruler's surface.
+		 * \param iAlong		Position of the line along the scale.
+		 * \param iFrom			Across start of the line.
+		 * \param iTo			Across end of the line (exclusive).
+		 * \param Start			Receives start point of the line.
+		 * \param End			Receives end point of the line.
+		 **/
+		static void MapLine(
+			const wxRect& SurfaceRect, int iAlong, int iFrom, int iTo,
+			wxPoint& Start, wxPoint& End)
+		{
+			if constexpr (bMirrored)
+			{
+				int iThickness = GetThickness(SurfaceRect);
+				int iMirroredFrom = iThickness - iTo;
+
+				iTo = iThickness - iFrom;
+				iFrom = iMirroredFrom;
+			}
+
+			if constexpr (bVertical)
+			{
+				Start = wxPoint(
+					SurfaceRect.GetLeft() + iFrom,
+					SurfaceRect.GetTop() + iAlong);
+				End = wxPoint(
+					SurfaceRect.GetLeft() + iTo, SurfaceRect.GetTop() + iAlong);
+			}
+			else
+			{
+				Start = wxPoint(
+					SurfaceRect.GetLeft() + iAlong,
+					SurfaceRect.GetTop() + iFrom);
+				End = wxPoint(
+					SurfaceRect.GetLeft() + iAlong, SurfaceRect.GetTop() + iTo);
+			}
+		}
+
+		/**
+		 * Maps top left corner of the label's box given in axis coordinates
+		 * to device coordinates.
+		 *
+		 * \param SurfaceRect	The rectangle of ruler's surface.
+		 * \param iAlong		Start of the label's box along the scale.
+		 * \param iAcross		Start of the label's box across the scale.
+		 * \param Extent		Extent of the label's text.
+		 *
+		 * \return	Returns point where label's text is drawn.
+		 **/
+		static wxPoint MapLabel(
+			const wxRect& SurfaceRect, int iAlong, int iAcross,
+			const wxSize& Extent)
+		{
+			if constexpr (bMirrored)
+				iAcross =
+					GetThickness(SurfaceRect) - iAcross - GetAcross(Extent);
+
+			if constexpr (bVertical)
+				return wxPoint(
+					SurfaceRect.GetLeft() + iAcross,
+					SurfaceRect.GetTop() + iAlong);
+			else
+				return wxPoint(
+					SurfaceRect.GetLeft() + iAlong,
+					SurfaceRect.GetTop() + iAcross);
+		}
+
+		/**
+		 * Returns PPI value of the direction along the scale.
+		 **/
+		static double GetPixelPerInchAlong(const wxRealPoint& PixelPerInch)
+		{
+			return bVertical ? PixelPerInch.y : PixelPerInch.x;
+		}
+	};
+}
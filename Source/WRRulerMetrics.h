@@ -0,0 +1,135 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+namespace WinRuler
+{
+	/**
+	 * Geometry of the ruler's elements in logical pixels of the window which
+	 * shows the ruler. All values are designed in device independent pixels
+	 * (DIPs) and scaled by number of logical pixels per DIP, so the ruler
+	 * keeps its physical size on displays with any scaling. Ruler's length
+	 * and markers' positions are measurements and they are never scaled.
+	 **/
+	struct SRulerMetrics
+	{
+		//! Number of logical pixels per DIP used for scaling.
+		double dScale;
+
+		//! Distance of the scale's origin from the ruler's start.
+		int iInset;
+
+		//! Distance of the scale's end from the ruler's end.
+		int iEndMargin;
+
+		//! Length of the first and the last tick.
+		int iLongTick;
+
+		//! Length of the medium tick (units with medium ticks only).
+		int iMediumTick;
+
+		//! Length of the labelled tick.
+		int iMiddleTick;
+
+		//! Length of the shortest tick.
+		int iShortTick;
+
+		//! Across offset of the middle labels of the scale.
+		int iLabelOffset;
+
+		//! Across offset of the first and the last label of horizontal and
+		//! vertical scale.
+		int iEndLabelOffsetHorizontal;
+		int iEndLabelOffsetVertical;
+
+		//! The smallest distance of two ticks.
+		int iMinTickSpacing;
+
+		//! The smallest gap between two labels.
+		int iMinLabelGap;
+
+		//! Gap between marker's line and its label.
+		int iMarkerLabelGap;
+
+		//! Thickness of the ruler's window.
+		int iThickness;
+
+		//! Pixel height of ruler's font. It is set as pixel size, because
+		//! point size is converted to pixels by DPI of the system again.
+		int iFontHeight;
+
+		bool operator==(const SRulerMetrics& Other) const
+		{
+			return
+				(dScale == Other.dScale) &&
+				(iInset == Other.iInset) &&
+				(iEndMargin == Other.iEndMargin) &&
+				(iLongTick == Other.iLongTick) &&
+				(iMediumTick == Other.iMediumTick) &&
+				(iMiddleTick == Other.iMiddleTick) &&
+				(iShortTick == Other.iShortTick) &&
+				(iLabelOffset == Other.iLabelOffset) &&
+				(iEndLabelOffsetHorizontal ==
+					Other.iEndLabelOffsetHorizontal) &&
+				(iEndLabelOffsetVertical == Other.iEndLabelOffsetVertical) &&
+				(iMinTickSpacing == Other.iMinTickSpacing) &&
+				(iMinLabelGap == Other.iMinLabelGap) &&
+				(iMarkerLabelGap == Other.iMarkerLabelGap) &&
+				(iThickness == Other.iThickness) &&
+				(iFontHeight == Other.iFontHeight);
+		}
+
+		bool operator!=(const SRulerMetrics& Other) const
+		{
+			return !(*this == Other);
+		}
+	};
+
+	/**
+	 * Returns ruler's metrics for specified number of logical pixels per
+	 * DIP. Lengths are rounded to whole pixels, but never drop below one
+	 * pixel, so fractional scaling does not make any element disappear.
+	 *
+	 * \param dScale	Number of logical pixels per DIP. It is 1.0 on
+	 *					platforms where logical pixels are already DIPs
+	 *					(GTK and macOS), on MSW it is DPI / 96.
+	 *
+	 * \return	Returns scaled metrics.
+	 **/
+	inline SRulerMetrics GetRulerMetrics(double dScale)
+	{
+		if (!(dScale > 0.0))
+			dScale = 1.0;
+
+		auto Scale = [dScale](int iDIPs)
+		{
+			return std::max(
+				1, static_cast<int>(std::lround(iDIPs * dScale)));
+		};
+
+		SRulerMetrics Metrics;
+		Metrics.dScale = dScale;
+		Metrics.iInset = Scale(4);
+		Metrics.iEndMargin = Scale(6);
+		Metrics.iLongTick = Scale(12);
+		Metrics.iMediumTick = Scale(8);
+		Metrics.iMiddleTick = Scale(5);
+		Metrics.iShortTick = Scale(3);
+		Metrics.iLabelOffset = Scale(5);
+		Metrics.iEndLabelOffsetHorizontal = Scale(12);
+		Metrics.iEndLabelOffsetVertical = Scale(14);
+		Metrics.iMinTickSpacing = Scale(2);
+		Metrics.iMinLabelGap = Scale(4);
+		Metrics.iMarkerLabelGap = Scale(4);
+		Metrics.iThickness = Scale(60);
+		Metrics.iFontHeight = Scale(8);
+
+		return Metrics;
+	}
+} // end namespace WinRuler
@@ -0,0 +1,248 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#include <numeric>
+#include <algorithm>
+#include "WRRulerUnits.h"
+#include "WRConversionKernels.h"
+
+namespace WinRuler
+{
+	//! Symbol of user-defined unit. Descriptor points to it, so it can be
+	//! changed without reallocation.
+	static wxChar g_szUserDefinedUnitSymbol[16] = wxT("u");
+
+	//! Denominator used for units per inch of user-defined unit.
+	static const unsigned long long UserDefinedUnitDenominator = 1000000;
+
+	//! Descriptor of user-defined unit. By default it is one unit per inch
+	//! with tenths of the unit as base ticks.
+	static SRulerUnitDesc g_UserDefinedUnitDesc =
+	{
+		ERulerUnits::ruUserDefined, wxT("&User-defined"),
+		g_szUserDefinedUnitSymbol,
+		false, 1, 1, 10, 1, 10, 5, 1, 2
+	};
+
+	const SRulerUnitDesc& GetRulerUnitDesc(ERulerUnits eRulerUnits)
+	{
+		if (eRulerUnits == ERulerUnits::ruUserDefined)
+			return g_UserDefinedUnitDesc;
+
+		if ((eRulerUnits < 0) || (eRulerUnits >= ERulerUnits::ruUserDefined))
+			return g_aRulerUnitDescs[ERulerUnits::ruCentimetres];
+
+		return g_aRulerUnitDescs[eRulerUnits];
+	}
+
+	bool IsValidUserDefinedUnitsPerInch(double dUnitsPerInch)
+	{
+		return
+			std::isfinite(dUnitsPerInch) &&
+			(dUnitsPerInch >= UserDefinedUnitsPerInchMin) &&
+			(dUnitsPerInch <= UserDefinedUnitsPerInchMax);
+	}
+
+	bool SetUserDefinedUnit(double dUnitsPerInch, const wxString& Symbol)
+	{
+		bool bValid = IsValidUserDefinedUnitsPerInch(dUnitsPerInch);
+
+		// Units per inch are kept with six decimal places as exact fraction.
+		// Range check keeps the product far below range of long long.
+		if (bValid)
+		{
+			unsigned long long Numerator =
+				static_cast<unsigned long long>(
+					std::llround(dUnitsPerInch * UserDefinedUnitDenominator));
+			unsigned long long Denominator = UserDefinedUnitDenominator;
+			unsigned long long Divisor = std::gcd(Numerator, Denominator);
+
+			g_UserDefinedUnitDesc.ullUnitsPerInchNumerator =
+				Numerator / Divisor;
+			g_UserDefinedUnitDesc.ullUnitsPerInchDenominator =
+				Denominator / Divisor;
+		}
+
+		// Copy symbol, it is cut to the size of the buffer.
+		size_t Length = 0;
+		for (wxString::const_iterator It = Symbol.begin();
+			(It != Symbol.end()) &&
+			(Length < WXSIZEOF(g_szUserDefinedUnitSymbol) - 1);
+			++It)
+			g_szUserDefinedUnitSymbol[Length++] = *It;
+		g_szUserDefinedUnitSymbol[Length] = wxT('\0');
+
+		return bValid;
+	}
+
+	double GetUserDefinedUnitsPerInch()
+	{
+		return
+			static_cast<double>(
+				g_UserDefinedUnitDesc.ullUnitsPerInchNumerator) /
+			static_cast<double>(
+				g_UserDefinedUnitDesc.ullUnitsPerInchDenominator);
+	}
+
+	wxString GetUserDefinedUnitSymbol()
+	{
+		return wxString(g_szUserDefinedUnitSymbol);
+	}
+
+	unsigned long long GetUnitTickStep(
+		const SRulerUnitDesc& Desc, double PixelPerInch)
+	{
+		unsigned long long Numerator, Denominator;
+
+		// Without valid PPI value there is no scale.
+		if (!std::isfinite(PixelPerInch) || (PixelPerInch <= 0.0))
+			return 0;
+
+		// Pixels per base tick as fraction. Whole PPI values keep exact
+		// fraction, fractional ones are computed in floating point.
+		if (Desc.bDevicePixels)
+		{
+			Numerator = Desc.uUnitsPerTick;
+			Denominator = Desc.uTicksPerUnit;
+		}
+		else if ((PixelPerInch == std::floor(PixelPerInch)) &&
+			(PixelPerInch <= 0xFFFFFFFF))
+		{
+			Numerator =
+				static_cast<unsigned long long>(PixelPerInch) *
+				Desc.uUnitsPerTick * Desc.ullUnitsPerInchDenominator;
+			Denominator =
+				Desc.ullUnitsPerInchNumerator * Desc.uTicksPerUnit;
+		}
+		else
+		{
+			if ((Desc.ullUnitsPerInchNumerator == 0) ||
+				(Desc.uTicksPerUnit == 0))
+				return 0;
+
+			return static_cast<unsigned long long>(
+				std::ceil(
+					std::ldexp(
+						(PixelPerInch * Desc.uUnitsPerTick *
+						 static_cast<double>(
+							Desc.ullUnitsPerInchDenominator)) /
+						(static_cast<double>(
+							Desc.ullUnitsPerInchNumerator) *
+						 Desc.uTicksPerUnit), 32)));
+		}
+
+		if ((Numerator == 0) || (Denominator == 0))
+			return 0;
+
+		unsigned long long Divisor = std::gcd(Numerator, Denominator);
+		Numerator /= Divisor;
+		Denominator /= Divisor;
+
+		// Round up, so exact multiples of the step are never truncated one
+		// pixel down. Fractions which do not fit in 32.32 arithmetic (only
+		// unusual user-defined units) are computed in floating point.
+		if ((Numerator <= 0xFFFFFFFFULL) && (Denominator <= 0xFFFFFFFFULL))
+			return ((Numerator << 32) + Denominator - 1) / Denominator;
+
+		return static_cast<unsigned long long>(
+			std::ceil(
+				std::ldexp(
+					static_cast<double>(Numerator) /
+					static_cast<double>(Denominator), 32)));
+	}
+
+	double ConvertPixelsToUnits(
+		const SRulerUnitDesc& Desc, double PixelPerInch, int iPixels)
+	{
+		if (Desc.bDevicePixels)
+			return static_cast<double>(iPixels);
+
+		if (PixelPerInch <= 0.0)
+			return 0.0;
+
+		return
+			(static_cast<double>(iPixels) *
+			 static_cast<double>(Desc.ullUnitsPerInchNumerator)) /
+			(static_cast<double>(Desc.ullUnitsPerInchDenominator) *
+			 PixelPerInch);
+	}
+
+	int ConvertUnitsToPixels(
+		const SRulerUnitDesc& Desc, double PixelPerInch, double dUnits)
+	{
+		if (Desc.bDevicePixels)
+			return static_cast<int>(std::trunc(dUnits));
+
+		return static_cast<int>(
+			std::trunc(
+				(dUnits * PixelPerInch *
+				 static_cast<double>(Desc.ullUnitsPerInchDenominator)) /
+				static_cast<double>(Desc.ullUnitsPerInchNumerator)));
+	}
+
+	void ConvertPixelSpanToUnits(
+		const SRulerUnitDesc& Desc, double PixelPerInch,
+		const int* pPixels, double* pUnits, size_t uCount,
+		EPixelKernelLevel eLevel)
+	{
+		const SConversionKernels& Kernels = GetConversionKernels(eLevel);
+
+		// Factors are the same as operands of ConvertPixelsToUnits(), so
+		// results are bit-identical to it.
+		if (Desc.bDevicePixels)
+			Kernels.pPixelsToUnits(pPixels, pUnits, uCount, 1.0, 1.0);
+		else if (PixelPerInch <= 0.0)
+			std::fill(pUnits, pUnits + uCount, 0.0);
+		else
+			Kernels.pPixelsToUnits(
+				pPixels, pUnits, uCount,
+				static_cast<double>(Desc.ullUnitsPerInchNumerator),
+				static_cast<double>(Desc.ullUnitsPerInchDenominator) *
+					PixelPerInch);
+	}
+
+	void ConvertUnitSpanToPixels(
+		const SRulerUnitDesc& Desc, double PixelPerInch,
+		const double* pUnits, int* pPixels, size_t uCount,
+		EPixelKernelLevel eLevel)
+	{
+		const SConversionKernels& Kernels = GetConversionKernels(eLevel);
+
+		// Factors are the same as operands of ConvertUnitsToPixels(), so
+		// results are bit-identical to it.
+		if (Desc.bDevicePixels)
+			Kernels.pUnitsToPixels(pUnits, pPixels, uCount, 1.0, 1.0, 1.0);
+		else
+			Kernels.pUnitsToPixels(
+				pUnits, pPixels, uCount, PixelPerInch,
+				static_cast<double>(Desc.ullUnitsPerInchDenominator),
+				static_cast<double>(Desc.ullUnitsPerInchNumerator));
+	}
+
+	size_t FormatUnitValue(
+		const SRulerUnitDesc& Desc, double dValue,
+		wxChar* Buffer, size_t BufferSize)
+	{
+		size_t Length =
+			FormatFixedPoint(
+				dValue, Desc.uMarkerDecimals, Buffer, BufferSize);
+		const wxChar* pszSymbol = Desc.pszSymbol;
+
+		// Value did not fit.
+		if (Length == 0)
+			return 0;
+
+		// Append space and unit's symbol while there is room for them and
+		// terminating null character.
+		if (Length + 1 < BufferSize)
+			Buffer[Length++] = wxT(' ');
+		while ((*pszSymbol != wxT('\0')) && (Length + 1 < BufferSize))
+			Buffer[Length++] = *pszSymbol++;
+
+		Buffer[Length] = wxT('\0');
+
+		return Length;
+	}
+} // end namespace WinRuler
@@ -0,0 +1,287 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "WRUtilities.h"
+#include "WRPixelKernels.h"
+
+namespace WinRuler
+{
+	/**
+	 * Descriptor of the ruler's unit of measurement. Length of the unit is
+	 * kept as exact fraction of an inch, so conversions do not depend on
+	 * rounding of intermediate values. Scale of the unit is built from base
+	 * ticks: every base tick is uUnitsPerTick / uTicksPerUnit of the unit
+	 * and all other intervals of the scale are given in base ticks. Adding
+	 * new unit of measurement is just new descriptor, renderer and labels
+	 * work with any of them.
+	 **/
+	struct SRulerUnitDesc
+	{
+		//! Unit of measurement described by this descriptor.
+		ERulerUnits eUnits;
+
+		//! Name of the unit used in menus (with mnemonic).
+		const wxChar* pszName;
+
+		//! Symbol of the unit appended to marker's label.
+		const wxChar* pszSymbol;
+
+		//! Unit is device pixel, so its length does not depend on PPI value
+		//! and units per inch are not used.
+		bool bDevicePixels;
+
+		//! Number of units in one inch as fraction
+		//! (numerator / denominator).
+		unsigned long long ullUnitsPerInchNumerator;
+		unsigned long long ullUnitsPerInchDenominator;
+
+		//! Number of base ticks in one unit and number of units in one base
+		//! tick. One of them is always 1.
+		unsigned int uTicksPerUnit;
+		unsigned int uUnitsPerTick;
+
+		//! Number of base ticks between two labelled ticks in the finest
+		//! level of detail.
+		unsigned int uLabelTicks;
+
+		//! Number of base ticks between two medium ticks or 0 if unit has no
+		//! medium ticks. It divides uLabelTicks.
+		unsigned int uMediumTicks;
+
+		//! Number of decimal places of scale's labels.
+		unsigned int uLabelDecimals;
+
+		//! Number of decimal places of marker's label.
+		unsigned int uMarkerDecimals;
+
+		/**
+		 * Compares everything that affects conversion and scale's layout.
+		 * Name and symbol are not compared.
+		 **/
+		bool IsSameScale(const SRulerUnitDesc& Other) const
+		{
+			return
+				(eUnits == Other.eUnits) &&
+				(bDevicePixels == Other.bDevicePixels) &&
+				(ullUnitsPerInchNumerator == Other.ullUnitsPerInchNumerator) &&
+				(ullUnitsPerInchDenominator ==
+					Other.ullUnitsPerInchDenominator) &&
+				(uTicksPerUnit == Other.uTicksPerUnit) &&
+				(uUnitsPerTick == Other.uUnitsPerTick) &&
+				(uLabelTicks == Other.uLabelTicks) &&
+				(uMediumTicks == Other.uMediumTicks) &&
+				(uLabelDecimals == Other.uLabelDecimals);
+		}
+	};
+
+	/**
+	 * Descriptors of built-in units of measurement, indexed by ERulerUnits.
+	 * User-defined unit is configured at run time, see
+	 * SetUserDefinedUnit().
+	 **/
+	inline constexpr SRulerUnitDesc g_aRulerUnitDescs[] =
+	{
+		// Centimetres: 2.54 cm per inch, eighths, labelled every unit.
+		{
+			ERulerUnits::ruCentimetres, wxT("&Centimetres"), wxT("cm"),
+			false, 254, 100, 8, 1, 8, 0, 2, 2
+		},
+
+		// Inches: eighths, labelled every unit.
+		{
+			ERulerUnits::ruInches, wxT("&Inches"), wxT("in"),
+			false, 1, 1, 8, 1, 8, 0, 2, 2
+		},
+
+		// Picas: 6 picas per inch, eighths, medium tick every pica and
+		// labelled every 6 picas.
+		{
+			ERulerUnits::ruPicas, wxT("&Picas"), wxT("pica"),
+			false, 6, 1, 8, 1, 48, 8, 2, 2
+		},
+
+		// Pixels: base tick on every second pixel, labelled every 10 base
+		// ticks.
+		{
+			ERulerUnits::ruPixels, wxT("&Pixels"), wxT("px"),
+			true, 0, 1, 1, 2, 10, 0, 0, 0
+		},
+
+		// Millimetres: 25.4 mm per inch, base tick every millimetre,
+		// medium tick every 5 mm and labelled every 10 mm.
+		{
+			ERulerUnits::ruMillimetres, wxT("&Millimetres"), wxT("mm"),
+			false, 254, 10, 1, 1, 10, 5, 0, 1
+		},
+
+		// Points: 72 pt per inch, base tick every point, medium tick every
+		// 5 pt and labelled every 10 pt.
+		{
+			ERulerUnits::ruPoints, wxT("P&oints"), wxT("pt"),
+			false, 72, 1, 1, 1, 10, 5, 0, 1
+		},
+
+		// Twips: 1440 twips per inch, base tick every 20 twips (one point),
+		// medium tick every 1/8 inch and labelled every 1/2 inch.
+		{
+			ERulerUnits::ruTwips, wxT("&Twips"), wxT("twip"),
+			false, 1440, 1, 1, 20, 36, 9, 0, 0
+		}
+	};
+
+	static_assert(
+		WXSIZEOF(g_aRulerUnitDescs) ==
+		static_cast<size_t>(ERulerUnits::ruUserDefined),
+		"Every built-in unit of measurement needs its descriptor.");
+
+	/**
+	 * Returns descriptor of specified unit of measurement. Invalid units
+	 * fall back to centimetres.
+	 *
+	 * \param eRulerUnits	Unit of measurement.
+	 *
+	 * \return	Returns reference to descriptor. Descriptor of user-defined
+	 *			unit is updated in place by SetUserDefinedUnit().
+	 **/
+	const SRulerUnitDesc& GetRulerUnitDesc(ERulerUnits eRulerUnits);
+
+	//! Range of units per inch of user-defined unit. The lower limit is
+	//! resolution of stored units per inch, the upper one keeps stored
+	//! fraction and fixed-point lengths of base ticks far from overflow.
+	inline constexpr double UserDefinedUnitsPerInchMin = 0.000001;
+	inline constexpr double UserDefinedUnitsPerInchMax = 100000.0;
+
+	/**
+	 * Checks if specified number of units in one inch can be used for
+	 * user-defined unit.
+	 *
+	 * \param dUnitsPerInch	Number of units in one inch.
+	 *
+	 * \return	Returns true if value is finite and lies in range from
+	 *			UserDefinedUnitsPerInchMin to UserDefinedUnitsPerInchMax,
+	 *			otherwise false.
+	 **/
+	bool IsValidUserDefinedUnitsPerInch(double dUnitsPerInch);
+
+	/**
+	 * Configures user-defined unit of measurement.
+	 *
+	 * \param dUnitsPerInch		Number of units in one inch. Values rejected
+	 *							by IsValidUserDefinedUnitsPerInch() are
+	 *							ignored and unit keeps its previous value.
+	 * \param Symbol			Symbol of the unit appended to marker's label
+	 *							(at most 15 characters are used).
+	 *
+	 * \return	Returns true if units per inch were set, otherwise false.
+	 **/
+	bool SetUserDefinedUnit(double dUnitsPerInch, const wxString& Symbol);
+
+	/**
+	 * Returns number of user-defined units in one inch.
+	 **/
+	double GetUserDefinedUnitsPerInch();
+
+	/**
+	 * Returns symbol of user-defined unit.
+	 **/
+	wxString GetUserDefinedUnitSymbol();
+
+	/**
+	 * Returns length of one base tick of the unit in pixels as 32.32
+	 * fixed-point number. It is rounded up, so (K * Step) >> 32 is exactly
+	 * the whole number of pixels in K base ticks whenever that number is
+	 * whole. Whole PPI values are converted as exact fraction, fractional
+	 * ones in floating point.
+	 *
+	 * \param Desc			Descriptor of the unit.
+	 * \param PixelPerInch	PPI value of the direction of conversion.
+	 *
+	 * \return	Returns fixed-point step or 0 if PPI value is not valid.
+	 **/
+	unsigned long long GetUnitTickStep(
+		const SRulerUnitDesc& Desc, double PixelPerInch);
+
+	/**
+	 * Converts distance in pixels to specified unit. This is the only
+	 * conversion kernel, all per-unit conversion routines call it.
+	 *
+	 * \param Desc			Descriptor of the unit.
+	 * \param PixelPerInch	PPI value of the direction of conversion.
+	 * \param iPixels		Distance in pixels.
+	 *
+	 * \return	Returns distance in units or 0 if PPI value is not valid.
+	 **/
+	double ConvertPixelsToUnits(
+		const SRulerUnitDesc& Desc, double PixelPerInch, int iPixels);
+
+	/**
+	 * Converts distance in specified unit to pixels. Result is truncated
+	 * towards zero.
+	 *
+	 * \param Desc			Descriptor of the unit.
+	 * \param PixelPerInch	PPI value of the direction of conversion.
+	 * \param dUnits		Distance in units.
+	 *
+	 * \return	Returns distance in whole pixels.
+	 **/
+	int ConvertUnitsToPixels(
+		const SRulerUnitDesc& Desc, double PixelPerInch, double dUnits);
+
+	/**
+	 * Converts span of distances in pixels to specified unit with SIMD
+	 * conversion kernels. Results are bit-identical to
+	 * ConvertPixelsToUnits() of every distance on every instruction set.
+	 *
+	 * \param Desc			Descriptor of the unit.
+	 * \param PixelPerInch	PPI value of the direction of conversion.
+	 * \param pPixels		First distance in pixels.
+	 * \param pUnits		Receives distances in units.
+	 * \param uCount		Number of distances.
+	 * \param eLevel		Instruction set of the kernels. By default the
+	 *						best one supported by CPU.
+	 **/
+	void ConvertPixelSpanToUnits(
+		const SRulerUnitDesc& Desc, double PixelPerInch,
+		const int* pPixels, double* pUnits, size_t uCount,
+		EPixelKernelLevel eLevel = GetSupportedPixelKernelLevel());
+
+	/**
+	 * Converts span of distances in specified unit to pixels with SIMD
+	 * conversion kernels. Results are bit-identical to
+	 * ConvertUnitsToPixels() of every distance on every instruction set.
+	 *
+	 * \param Desc			Descriptor of the unit.
+	 * \param PixelPerInch	PPI value of the direction of conversion.
+	 * \param pUnits		First distance in units.
+	 * \param pPixels		Receives distances in whole pixels.
+	 * \param uCount		Number of distances.
+	 * \param eLevel		Instruction set of the kernels. By default the
+	 *						best one supported by CPU.
+	 **/
+	void ConvertUnitSpanToPixels(
+		const SRulerUnitDesc& Desc, double PixelPerInch,
+		const double* pUnits, int* pPixels, size_t uCount,
+		EPixelKernelLevel eLevel = GetSupportedPixelKernelLevel());
+
+	/**
+	 * Formats value with marker's decimal places of the unit followed by
+	 * space and unit's symbol into caller supplied buffer. It does not
+	 * allocate any memory.
+	 *
+	 * \param Desc			Descriptor of the unit.
+	 * \param dValue		Value in units.
+	 * \param Buffer		Buffer that receives null terminated text.
+	 * \param BufferSize	Size of the buffer in characters.
+	 *
+	 * \return	Returns number of written characters (without terminating null
+	 *			character). Symbol is cut if buffer is too small.
+	 **/
+	size_t FormatUnitValue(
+		const SRulerUnitDesc& Desc, double dValue,
+		wxChar* Buffer, size_t BufferSize);
+} // end namespace WinRuler
@@ -0,0 +1,138 @@
+/**
+ * Copyright  2024-2025 Piotr Domanski
+ * Licensed under the MIT license.
+ **/
+
+#pragma once
+
+#include <wx/wx.h>
+#include "WRRulerUnits.h"
+
+namespace WinRuler
+{
+	/**
+	 * Conversion functor of one axis and one built-in unit of measurement,
+	 * resolved at compile time. Factors of the unit are compile-time
+	 * constants of its descriptor and PPI value of the axis is selected once
+	 * by constructor, so loops which create functor before the loop convert
+	 * every value inline with one multiplication and one division. Results
+	 * are bit-identical to ConvertPixelsToUnits() and ConvertUnitsToPixels().
+	 *
+	 * \tparam bVertical	Conversion along vertical axis (Y PPI value),
+	 *						otherwise along horizontal one (X PPI value).
+	 * \tparam eUnits		Built-in unit of measurement.
+	 **/
+	template <bool bVertical, ERulerUnits eUnits>
+	class TUnitConversion
+	{
+		static_assert(
+			eUnits < ERulerUnits::ruUserDefined,
+			"User-defined unit is configured at run time, convert it with "
+			"its descriptor.");
+	public:
+		//! Unit is device pixel, so PPI value is not used.
+		static constexpr bool bDevicePixels =
+			g_aRulerUnitDescs[eUnits].bDevicePixels;
+
+		//! Number of units in one inch as fraction.
+		static constexpr double dUnitsPerInchNumerator =
+			static_cast<double>(
+				g_aRulerUnitDescs[eUnits].ullUnitsPerInchNumerator);
+		static constexpr double dUnitsPerInchDenominator =
+			static_cast<double>(
+				g_aRulerUnitDescs[eUnits].ullUnitsPerInchDenominator);
+
+		/**
+		 * Constructor.
+		 *
+		 * \param PixelPerInch	PPI value of the axis.
+		 **/
+		constexpr explicit TUnitConversion(double PixelPerInch) :
+			m_dPixelPerInch(PixelPerInch),
+			m_dPixelDivisor(dUnitsPerInchDenominator * PixelPerInch)
+		{
+			// No code.
+		}
+
+		/**
+		 * Constructor. It selects PPI value of the axis.
+		 *
+		 * \param PixelPerInch	PPI values of both axes.
+		 **/
+		explicit TUnitConversion(const wxRealPoint& PixelPerInch) :
+			TUnitConversion(bVertical ? PixelPerInch.y : PixelPerInch.x)
+		{
+			// No code.
+		}
+
+		/**
+		 * Converts distance in pixels to units.
+		 *
+		 * \param iPixels	Distance in pixels.
+		 *
+		 * \return	Returns distance in units or 0 if PPI value is not
+		 *			valid.
+		 **/
+		constexpr double ToUnits(int iPixels) const
+		{
+			if constexpr (bDevicePixels)
+				return static_cast<double>(iPixels);
+
+			if (m_dPixelPerInch <= 0.0)
+				return 0.0;
+
+			return
+				(static_cast<double>(iPixels) * dUnitsPerInchNumerator) /
+				m_dPixelDivisor;
+		}
+
+		/**
+		 * Converts distance in units to pixels. Result is truncated towards
+		 * zero (by cast, std::trunc() is not constexpr).
+		 *
+		 * \param dUnits	Distance in units.
+		 *
+		 * \return	Returns distance in whole pixels.
+		 **/
+		constexpr int ToPixels(double dUnits) const
+		{
+			if constexpr (bDevicePixels)
+				return static_cast<int>(dUnits);
+
+			return static_cast<int>(
+				(dUnits * m_dPixelPerInch * dUnitsPerInchDenominator) /
+				dUnitsPerInchNumerator);
+		}
+
+		/**
+		 * Converts distance in pixels to units, see ToUnits().
+		 **/
+		constexpr double operator()(int iPixels) const
+		{
+			return ToUnits(iPixels);
+		}
+
+		/**
+		 * Returns PPI value of the axis.
+		 **/
+		constexpr double GetPixelPerInch() const
+		{
+			return m_dPixelPerInch;
+		}
+	private:
+		//! PPI value of the axis.
+		double m_dPixelPerInch;
+
+		//! Divisor of conversion to units (denominator of units per inch
+		//! multiplied by PPI value).
+		double m_dPixelDivisor;
+	};
+
+	//! Conversion functor of horizontal axis.
+	template <ERulerUnits eUnits>
+	using THorizontalUnitConversion = TUnitConversion<false, eUnits>;
+
+	//! Conversion functor of vertical axis.
+	template <ERulerUnits eUnits>
+	using TVerticalUnitConversion = TUnitConversion<true, eUnits>;
+} // end namespace WinRuler
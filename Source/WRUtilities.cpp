@@ -4,144 +4,164 @@
  **/
 
 #include "WRUtilities.h"
+#include "WRRulerUnits.h"
+#include "WRUnitConversion.h"
 
 namespace WinRuler
 {
-	std::vector<wxSize> g_vPixelPerInch( { wxSize(0, 0) } );
+	std::vector<wxRealPoint> g_vPixelPerInch( { wxRealPoint(0.0, 0.0) } );
 
 	bool AreSame(double a, double b, double epsilon)
 	{
 		return (std::fabs(a - b) < epsilon);
 	}
 
-	void SetPixelPerInch(unsigned int DisplayNo, wxSize& NewPPIValue)
+	bool IsValidPixelPerInch(double dPixelPerInch)
 	{
-		// If NewValue is different than current PixelPerInch value, then
-		// change it.
-		if ((g_vPixelPerInch[DisplayNo].x != NewPPIValue.x) &&
-			(g_vPixelPerInch[DisplayNo].y != NewPPIValue.y))
-			g_vPixelPerInch[DisplayNo] = NewPPIValue;
+		return
+			std::isfinite(dPixelPerInch) &&
+			(dPixelPerInch >= PixelPerInchMin);
 	}
 
-	wxSize& GetPixelPerInch(unsigned int DisplayNo)
+	void SetPixelPerInch(
+		unsigned int DisplayNo, const wxRealPoint& NewPPIValue)
 	{
+		// Displays which are not known have no PPI value of their own.
+		if (DisplayNo >= g_vPixelPerInch.size())
+			return;
+
+		// Change PixelPerInch value along every axis where NewValue is
+		// valid and different than current one.
+		wxRealPoint& PixelPerInch = g_vPixelPerInch[DisplayNo];
+		if (IsValidPixelPerInch(NewPPIValue.x) &&
+			(PixelPerInch.x != NewPPIValue.x))
+			PixelPerInch.x = NewPPIValue.x;
+		if (IsValidPixelPerInch(NewPPIValue.y) &&
+			(PixelPerInch.y != NewPPIValue.y))
+			PixelPerInch.y = NewPPIValue.y;
+	}
+
+	wxRealPoint& GetPixelPerInch(unsigned int DisplayNo)
+	{
+		// Displays connected after start of the application are not known,
+		// they use PPI value of the primary display.
+		if (DisplayNo >= g_vPixelPerInch.size())
+			DisplayNo = 0;
+
 		// Return current PixelPerInch value.
 		return g_vPixelPerInch[DisplayNo];
 	}
 
 	int InchesToPixelsHorizontal(unsigned int DisplayNo, double AInchDistance)
 	{
-		// Calculate how many pixels are in specified distance (in inches) and
-		// return result.
-		return static_cast<int>(
-			std::trunc(GetPixelPerInch(DisplayNo).GetX() * AInchDistance));
+		return THorizontalUnitConversion<ERulerUnits::ruInches>(
+			GetPixelPerInch(DisplayNo)).ToPixels(AInchDistance);
 	}
 
 	int InchesToPixelsVertical(unsigned int DisplayNo, double AInchDistance)
 	{
-		// Calculate how many pixels are in specified distance (in inches) and
-		// return result.
-		return static_cast<int>(
-			std::trunc(GetPixelPerInch(DisplayNo).GetY() * AInchDistance));
+		return TVerticalUnitConversion<ERulerUnits::ruInches>(
+			GetPixelPerInch(DisplayNo)).ToPixels(AInchDistance);
 	}
 
 	double PixelsToInchesHorizontal(unsigned int DisplayNo, int APixelDistance)
 	{
-		// Calculate how many inches are in specified pixel distance and return
-		// result.
-		return static_cast<double>(
-			static_cast<double>(APixelDistance) /
-			static_cast<double>(GetPixelPerInch(DisplayNo).GetX()));
+		return THorizontalUnitConversion<ERulerUnits::ruInches>(
+			GetPixelPerInch(DisplayNo)).ToUnits(APixelDistance);
 	}
 
 	double PixelsToInchesVertical(unsigned int DisplayNo, int APixelDistance)
 	{
-		// Calculate how many inches are in specified pixel distance and return
-		// result.
-		return static_cast<double>(
-			static_cast<double>(APixelDistance) /
-			static_cast<double>(GetPixelPerInch(DisplayNo).GetY()));
+		return TVerticalUnitConversion<ERulerUnits::ruInches>(
+			GetPixelPerInch(DisplayNo)).ToUnits(APixelDistance);
 	}
 
 	int CentimetresToPixelsHorizontal(
 		unsigned int DisplayNo, double ACentimetreDistance)
 	{
-		// Calculate how many pixels are in specified distance (in centimetres)
-		// and return result.
-		return static_cast<int>(
-			std::trunc(GetPixelPerInch(DisplayNo).GetX() / 2.54) * 
-			ACentimetreDistance);
+		return THorizontalUnitConversion<ERulerUnits::ruCentimetres>(
+			GetPixelPerInch(DisplayNo)).ToPixels(ACentimetreDistance);
 	}
 
 	int CentimetresToPixelsVertical(
 		unsigned int DisplayNo, double ACentimetreDistance)
 	{
-		// Calculate how many pixels are in specified distance (in centimetres)
-		// and return result.
-		return static_cast<int>(
-			std::trunc(GetPixelPerInch(DisplayNo).GetY() / 2.54) * 
-			ACentimetreDistance);
+		return TVerticalUnitConversion<ERulerUnits::ruCentimetres>(
+			GetPixelPerInch(DisplayNo)).ToPixels(ACentimetreDistance);
 	}
 
 	double PixelsToCentimetresHorizontal(
 		unsigned int DisplayNo, int APixelDistance)
 	{
-		// Calculates how many centimetres are in specified pixel distance and
-		// return result.
-		return static_cast<double>(
-			static_cast<double>(APixelDistance) /
-			static_cast<double>(
-				static_cast<double>(
-					GetPixelPerInch(DisplayNo).GetX() / 2.54)));
+		return THorizontalUnitConversion<ERulerUnits::ruCentimetres>(
+			GetPixelPerInch(DisplayNo)).ToUnits(APixelDistance);
 	}
 
 	double PixelsToCentimetresVertical(
 		unsigned int DisplayNo, int APixelDistance)
 	{
-		// Calculates how many centimetres are in specified pixel distance and
-		// return result.
-		return static_cast<double>(
-			static_cast<double>(APixelDistance) /
-			static_cast<double>(
-				static_cast<double>(
-					GetPixelPerInch(DisplayNo).GetY() / 2.54)));
+		return TVerticalUnitConversion<ERulerUnits::ruCentimetres>(
+			GetPixelPerInch(DisplayNo)).ToUnits(APixelDistance);
 	}
 
 	int PicasToPixelsHorizontal(unsigned int DisplayNo, double APicasDistance)
 	{
-		// Calculates how many pixels are in specified distance (in picas) and
-		// return result.
-		return static_cast<int>(
-			(GetPixelPerInch(DisplayNo).GetX() / 6.0) * 
-			APicasDistance);
+		return THorizontalUnitConversion<ERulerUnits::ruPicas>(
+			GetPixelPerInch(DisplayNo)).ToPixels(APicasDistance);
 	}
 
 	int PicasToPixelsVertical(unsigned int DisplayNo, double APicasDistance)
 	{
-		// Calculates how many pixels are in specified distance (in picas) and
-		// return result.
-		return static_cast<int>(
-			(GetPixelPerInch(DisplayNo).GetY() / 6.0) * APicasDistance);
+		return TVerticalUnitConversion<ERulerUnits::ruPicas>(
+			GetPixelPerInch(DisplayNo)).ToPixels(APicasDistance);
 	}
 
 	double PixelsToPicasHorizontal(unsigned int DisplayNo, int APixelDistance)
 	{
-		// Calculates how many picas are in specified pixel distance and return
-		// result.
-		return static_cast<double>(
-			static_cast<double>(APixelDistance) /
-			static_cast<double>(
-				static_cast<double>(GetPixelPerInch(DisplayNo).GetX() / 6.0)));
+		return THorizontalUnitConversion<ERulerUnits::ruPicas>(
+			GetPixelPerInch(DisplayNo)).ToUnits(APixelDistance);
 	}
 
 	double PixelsToPicasVertical(unsigned int DisplayNo, int APixelDistance)
 	{
-		// Calculates how many picas are in specified pixel distance and return
-		// result.
-		return static_cast<double>(
-			static_cast<double>(APixelDistance) /
-			static_cast<double>(
-				static_cast<double>(GetPixelPerInch(DisplayNo).GetY() / 6.0)));
+		return TVerticalUnitConversion<ERulerUnits::ruPicas>(
+			GetPixelPerInch(DisplayNo)).ToUnits(APixelDistance);
+	}
+
+	void PixelsToUnitsHorizontal(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const int* pPixels, double* pUnits, size_t uCount)
+	{
+		ConvertPixelSpanToUnits(
+			GetRulerUnitDesc(eRulerUnits), GetPixelPerInch(DisplayNo).x,
+			pPixels, pUnits, uCount);
+	}
+
+	void PixelsToUnitsVertical(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const int* pPixels, double* pUnits, size_t uCount)
+	{
+		ConvertPixelSpanToUnits(
+			GetRulerUnitDesc(eRulerUnits), GetPixelPerInch(DisplayNo).y,
+			pPixels, pUnits, uCount);
+	}
+
+	void UnitsToPixelsHorizontal(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const double* pUnits, int* pPixels, size_t uCount)
+	{
+		ConvertUnitSpanToPixels(
+			GetRulerUnitDesc(eRulerUnits), GetPixelPerInch(DisplayNo).x,
+			pUnits, pPixels, uCount);
+	}
+
+	void UnitsToPixelsVertical(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const double* pUnits, int* pPixels, size_t uCount)
+	{
+		ConvertUnitSpanToPixels(
+			GetRulerUnitDesc(eRulerUnits), GetPixelPerInch(DisplayNo).y,
+			pUnits, pPixels, uCount);
 	}
 
 	wxPoint ParsePosition(const wxString& PositionString)
@@ -164,6 +184,68 @@ namespace WinRuler
 		}
 	}
 
+	size_t FormatFixedPoint(
+		double Value, unsigned int Decimals,
+		wxChar* Buffer, size_t BufferSize)
+	{
+		static const double Scales[] =
+			{ 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0 };
+		wxChar Digits[24];
+		size_t DigitCount = 0;
+		size_t Length = 0;
+
+		// Limit number of decimal places.
+		if (Decimals > 6)
+			Decimals = 6;
+
+		// Scale value to integer number. Values which do not fit in 64 bits
+		// are not supported.
+		double Scaled = std::nearbyint(std::fabs(Value) * Scales[Decimals]);
+		if (!std::isfinite(Scaled) || (Scaled >= 1.0e19))
+		{
+			if (BufferSize > 0)
+				Buffer[0] = wxT('\0');
+
+			return 0;
+		}
+		unsigned long long Integer = static_cast<unsigned long long>(Scaled);
+
+		// Produce digits in reverse order. At least one digit before decimal
+		// separator is always produced.
+		do
+		{
+			Digits[DigitCount++] = static_cast<wxChar>(wxT('0') + Integer % 10);
+			Integer /= 10;
+		} while ((Integer != 0) || (DigitCount <= Decimals));
+
+		// Check if buffer is big enough for sign, digits, separator and
+		// terminating null character.
+		if (BufferSize < DigitCount + 3)
+		{
+			if (BufferSize > 0)
+				Buffer[0] = wxT('\0');
+
+			return 0;
+		}
+
+		// Write sign only for values which are not rounded to zero.
+		if ((Value < 0.0) && (Scaled != 0.0))
+			Buffer[Length++] = wxT('-');
+
+		// Write digits in correct order together with decimal separator.
+		while (DigitCount > 0)
+		{
+			if (DigitCount == Decimals)
+				Buffer[Length++] = wxT('.');
+
+			Buffer[Length++] = Digits[--DigitCount];
+		}
+
+		Buffer[Length] = wxT('\0');
+
+		return Length;
+	}
+
 // If platform is Windows, then we can use WinAPI to get all windows.
 #ifdef WR_WINDOWS
 	BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam)
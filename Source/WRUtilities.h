@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include <limits>
 #include <cstdio> // For sscanf()
 #include <iostream>
@@ -55,7 +56,22 @@ namespace WinRuler
 		ruPicas,
 		
 		//! Pixels as unit of measurement.
-		ruPixels
+		ruPixels,
+
+		//! Millimetres as unit of measurement.
+		ruMillimetres,
+
+		//! Points as unit of measurement.
+		ruPoints,
+
+		//! Twips (twentieths of a point) as unit of measurement.
+		ruTwips,
+
+		//! User-defined unit of measurement.
+		ruUserDefined,
+
+		//! Number of units of measurement.
+		ruCount
 	} ERulerUnits;
 
 	/**
@@ -73,6 +89,67 @@ namespace WinRuler
 		btImage
 	} ERulerBackgroundType;
 
+	/**
+	 * Part of ruler's background image.
+	 **/
+	typedef enum EBackgroundImagePart
+	{
+		//! Part at the start of the ruler (left or top one).
+		bpStart,
+
+		//! Part tiled between the start and the end part.
+		bpMiddle,
+
+		//! Part at the end of the ruler (right or bottom one).
+		bpEnd
+	} EBackgroundImagePart;
+
+	/**
+	 * Places parts of ruler's background image along the ruler. The start
+	 * part is placed at the start of the ruler, the middle part is tiled
+	 * after it up to the end part, which is placed at the end of the ruler.
+	 * Lengths of parts are taken from the parts themselves, so scaled parts
+	 * are placed the same way.
+	 *
+	 * \tparam TDrawPart		Functor called as DrawPart(ePart, iOffset) for
+	 *						every placed part. iOffset is offset of the part
+	 *						along the ruler.
+	 * \param iLength		Length of the ruler.
+	 * \param iStartLength	Length of the start part along the ruler.
+	 * \param iMiddleLength	Length of the middle part along the ruler.
+	 * \param iEndLength		Length of the end part along the ruler.
+	 * \param DrawPart		Functor which draws the part.
+	 **/
+	template <typename TDrawPart>
+	void PlaceBackgroundImageParts(
+		int iLength, int iStartLength, int iMiddleLength, int iEndLength,
+		TDrawPart DrawPart)
+	{
+		DrawPart(EBackgroundImagePart::bpStart, 0);
+
+		for (int iOffset = iStartLength;
+			iOffset <= iLength - iEndLength;
+			iOffset += std::max(iMiddleLength, 1))
+			DrawPart(EBackgroundImagePart::bpMiddle, iOffset);
+
+		DrawPart(EBackgroundImagePart::bpEnd, iLength - iEndLength);
+	}
+
+	/**
+	 * Graphics backend used for ruler's rendering.
+	 **/
+	typedef enum ERenderBackend
+	{
+		//! Classic wxDC calls without antialiasing.
+		rbDC,
+
+		//! wxGraphicsContext with antialiasing and batched paths.
+		rbGraphicsContext,
+
+		//! Software rasteriser with SIMD pixel kernels.
+		rbSoftware
+	} ERenderBackend;
+
 	/*-------------------------------------------------------------------------
 	  Mathematical routines.
 	-------------------------------------------------------------------------*/
@@ -91,25 +168,52 @@ namespace WinRuler
         double epsilon = std::numeric_limits<double>::epsilon());
 
 	/*-------------------------------------------------------------------------
-	  Unit of measurement conversion routines.
+	  Unit of measurement conversion routines. All of them are thin wrappers
+	  of compile-time conversion functors (WRUnitConversion.h) or of span
+	  conversions of the unit registry (WRRulerUnits.h). Hot loops should
+	  use the functors directly with PPI value selected before the loop.
 	-------------------------------------------------------------------------*/
 
-	extern std::vector<wxSize> g_vPixelPerInch;
+	//! Calibrated PPI values of all displays. X is horizontal and Y is
+	//! vertical PPI value. They are fractional, so calibration is not
+	//! rounded to whole pixels per inch.
+	extern std::vector<wxRealPoint> g_vPixelPerInch;
+
+	//! The smallest PPI value of calibration. Zero or negative PPI value
+	//! would collapse or invert ruler's scale.
+	inline constexpr double PixelPerInchMin = 1.0;
+
+	/**
+	 * Checks if specified PPI value can be used for calibration.
+	 *
+	 * \param dPixelPerInch	PPI value along one axis.
+	 *
+	 * \return	Returns true if value is finite and not smaller than
+	 *			PixelPerInchMin, otherwise false.
+	 **/
+	bool IsValidPixelPerInch(double dPixelPerInch);
 
 	/**
 	 * Sets new PixelPerInch value.
 	 *
-	 * \param NewValue	New value that will be stored as current PixelPerInch
-	 *					value.
+	 * \param DisplayNo		Number of display. Unknown displays are ignored.
+	 * \param NewPPIValue	New value that will be stored as current
+	 *						PixelPerInch value of the display. Values of
+	 *						axes rejected by IsValidPixelPerInch() are
+	 *						ignored.
 	 **/
-	void SetPixelPerInch(unsigned int DisplayNo, wxSize& NewPPIValue);
+	void SetPixelPerInch(
+		unsigned int DisplayNo, const wxRealPoint& NewPPIValue);
 
 	/**
 	 * Gets PixelPerInch value.
 	 *
+	 * \param DisplayNo	Number of display. Unknown displays use PPI value
+	 *					of display 0.
+	 *
 	 * \return	Returns current PixelPerInch value.
 	 **/
-	wxSize& GetPixelPerInch(unsigned int DisplayNo);
+	wxRealPoint& GetPixelPerInch(unsigned int DisplayNo);
 
 	/**
 	 * Calculates conversion from inches to pixels (horizontal version).
@@ -233,6 +337,58 @@ namespace WinRuler
 	 **/
 	double PixelsToPicasVertical(unsigned int DisplayNo, int APixelDistance);
 
+	/**
+	 * Converts span of pixel distances to specified unit (horizontal
+	 * version). Conversion uses SIMD kernels and its results are the same
+	 * as results of the single value routines.
+	 *
+	 * \param eRulerUnits	Unit of measurement.
+	 * \param pPixels		First pixel distance of the span.
+	 * \param pUnits		Receives distances in units.
+	 * \param uCount		Number of distances of the span.
+	 **/
+	void PixelsToUnitsHorizontal(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const int* pPixels, double* pUnits, size_t uCount);
+
+	/**
+	 * Converts span of pixel distances to specified unit (vertical version).
+	 *
+	 * \param eRulerUnits	Unit of measurement.
+	 * \param pPixels		First pixel distance of the span.
+	 * \param pUnits		Receives distances in units.
+	 * \param uCount		Number of distances of the span.
+	 **/
+	void PixelsToUnitsVertical(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const int* pPixels, double* pUnits, size_t uCount);
+
+	/**
+	 * Converts span of distances in specified unit to pixels (horizontal
+	 * version).
+	 *
+	 * \param eRulerUnits	Unit of measurement.
+	 * \param pUnits		First distance in units of the span.
+	 * \param pPixels		Receives distances in whole pixels.
+	 * \param uCount		Number of distances of the span.
+	 **/
+	void UnitsToPixelsHorizontal(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const double* pUnits, int* pPixels, size_t uCount);
+
+	/**
+	 * Converts span of distances in specified unit to pixels (vertical
+	 * version).
+	 *
+	 * \param eRulerUnits	Unit of measurement.
+	 * \param pUnits		First distance in units of the span.
+	 * \param pPixels		Receives distances in whole pixels.
+	 * \param uCount		Number of distances of the span.
+	 **/
+	void UnitsToPixelsVertical(
+		unsigned int DisplayNo, ERulerUnits eRulerUnits,
+		const double* pUnits, int* pPixels, size_t uCount);
+
 	/*-------------------------------------------------------------------------
 	  Other helpful routines.
 	-------------------------------------------------------------------------*/
@@ -247,6 +403,24 @@ namespace WinRuler
 	 **/
 	wxPoint ParsePosition(const wxString& PositionString);
 
+	/**
+	 * Formats value as decimal number with fixed number of decimal places
+	 * into caller supplied buffer. It does not allocate any memory, so it is
+	 * suitable for labels that change on every frame. Decimal separator is
+	 * always '.', value is rounded to nearest (ties to even).
+	 *
+	 * \param Value			Value to format.
+	 * \param Decimals		Number of decimal places (at most 6).
+	 * \param Buffer		Buffer that receives null terminated text.
+	 * \param BufferSize	Size of the buffer in characters.
+	 *
+	 * \return	Returns number of written characters (without terminating null
+	 *			character) or 0 if value is not finite or buffer is too small.
+	 **/
+	size_t FormatFixedPoint(
+		double Value, unsigned int Decimals,
+		wxChar* Buffer, size_t BufferSize);
+
 #if (defined(_WIN32) || defined(WIN32))	// If platform is Windows.
 	// Window information structure.
 	struct WindowInfo